@@ -16,6 +16,9 @@ import tempfile
 app = Flask(__name__)
 CORS(app)
 
+# Re-running an unchanged program reuses the linked executable from this cache
+COMPILER_CACHE_DIR = os.environ.get('ORION_CACHE_DIR', '.orion-cache')
+
 @app.route('/')
 def index():
     """Serve the main HTML page."""
@@ -73,7 +76,7 @@ def compile_code():
             if has_input_calls and input_data:
                 # Provide input data via stdin
                 result = subprocess.run(
-                    ['./orion', os.path.abspath(temp_file_path)],
+                    ['./orion', '--cache-dir', COMPILER_CACHE_DIR, os.path.abspath(temp_file_path)],
                     cwd='./compiler',
                     capture_output=True,
                     text=True,
@@ -91,7 +94,7 @@ def compile_code():
             else:
                 # Non-interactive program
                 result = subprocess.run(
-                    ['./orion', os.path.abspath(temp_file_path)],
+                    ['./orion', '--cache-dir', COMPILER_CACHE_DIR, os.path.abspath(temp_file_path)],
                     cwd='./compiler',
                     capture_output=True,
                     text=True,
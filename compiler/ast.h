@@ -23,20 +23,6 @@ public:
     virtual std::string toString(int indent = 0) const = 0;
 };
 
-// Expression base class
-class Expression : public ASTNode {
-public:
-    Expression(int line = 0, int column = 0) : ASTNode(line, column) {}
-    virtual ~Expression() = default;
-};
-
-// Statement base class
-class Statement : public ASTNode {
-public:
-    Statement(int line = 0, int column = 0) : ASTNode(line, column) {}
-    virtual ~Statement() = default;
-};
-
 // Type representation
 enum class TypeKind {
     INT32,
@@ -51,6 +37,7 @@ enum class TypeKind {
     FUNCTION,
     LIST,
     DICT,
+    RANGE,
     UNKNOWN
 };
 
@@ -114,11 +101,28 @@ struct Type {
             case TypeKind::DICT:
                 return "dict[" + (keyType ? keyType->toString() : "unknown") + ", " + 
                        (elementType ? elementType->toString() : "unknown") + "]";
+            case TypeKind::RANGE: return "range";
             default: return "unknown";
         }
     }
 };
 
+// Expression base class
+class Expression : public ASTNode {
+public:
+    Type inferredType;  // Set by the TypeChecker pass; UNKNOWN where inference gave up
+    
+    Expression(int line = 0, int column = 0) : ASTNode(line, column) {}
+    virtual ~Expression() = default;
+};
+
+// Statement base class
+class Statement : public ASTNode {
+public:
+    Statement(int line = 0, int column = 0) : ASTNode(line, column) {}
+    virtual ~Statement() = default;
+};
+
 // Literals
 class IntLiteral : public Expression {
 public:
@@ -250,6 +254,7 @@ class FunctionCall : public Expression {
 public:
     std::string name;
     std::vector<std::unique_ptr<Expression>> arguments;
+    std::string specialization;  // Set by the TypeChecker: label of the monomorphized copy to call, empty for the generic body
     
     FunctionCall(const std::string& n) : name(n) {}
     void accept(ASTVisitor& visitor) override;
@@ -494,13 +499,15 @@ public:
 class ForInStatement : public Statement {
 public:
     std::string variable;                        // for x in ...
+    std::string valueVariable;                   // for k, v in items(d): empty otherwise
     std::unique_ptr<Expression> iterable;        // ... in iterable
     std::unique_ptr<Statement> body;
     
     ForInStatement(const std::string& var, 
                    std::unique_ptr<Expression> iter,
-                   std::unique_ptr<Statement> body_stmt)
-        : variable(var), iterable(std::move(iter)), body(std::move(body_stmt)) {}
+                   std::unique_ptr<Statement> body_stmt,
+                   const std::string& valueVar = "")
+        : variable(var), valueVariable(valueVar), iterable(std::move(iter)), body(std::move(body_stmt)) {}
     
     void accept(ASTVisitor& visitor) override;
     std::string toString(int indent = 0) const override;
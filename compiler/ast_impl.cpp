@@ -321,6 +321,9 @@ std::string ForInStatement::toString(int indent) const {
     std::string indentStr(indent, ' ');
     std::string result = indentStr + "ForInStatement:\n";
     result += indentStr + "  Variable: " + variable + "\n";
+    if (!valueVariable.empty()) {
+        result += indentStr + "  Value variable: " + valueVariable + "\n";
+    }
     result += indentStr + "  Iterable:\n";
     result += iterable->toString(indent + 4);
     result += indentStr + "  Body:\n";
@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+"""Compiler throughput benchmark.
+
+Generates synthetic sources at several sizes with gen_large_source.py, compiles
+each one repeatedly with `orion --no-run --stats-json`, and reports the median
+time of every compiler phase together with its throughput in lines/sec and
+bytes/sec. Results can be written as JSON and compared against a previous run,
+so a slowdown in the lexer, parser or code generator fails CI.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+COMPILER_DIR = os.path.dirname(BENCH_DIR)
+
+sys.dont_write_bytecode = True
+sys.path.insert(0, BENCH_DIR)
+import gen_large_source  # noqa: E402
+
+# Generator settings for each benchmark size
+PRESETS = {
+    "small": dict(functions=200, nesting=8, interpolations=20, interp_parts=20, lists=2, list_size=1000),
+    "medium": dict(functions=1000, nesting=12, interpolations=100, interp_parts=40, lists=10, list_size=5000),
+    "large": dict(functions=4000, nesting=16, interpolations=400, interp_parts=60, lists=40, list_size=10000),
+}
+
+# Phases that run inside the compiler; assemble+link is reported but is gcc's time
+FRONTEND_PHASES = ("lex", "parse", "typecheck", "escape", "codegen")
+
+
+def generate_source(preset, path, seed):
+    options = argparse.Namespace(seed=seed, **PRESETS[preset])
+    with open(path, "w") as out:
+        out.write(gen_large_source.generate(options))
+
+
+def compile_once(compiler, source, workdir):
+    stats_path = os.path.join(workdir, "stats.json")
+    result = subprocess.run(
+        [compiler, source, "--no-run", "--stats-json=" + stats_path],
+        cwd=workdir, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+    if result.returncode != 0:
+        raise RuntimeError(f"compilation of {source} failed:\n{result.stderr}")
+    with open(stats_path) as f:
+        return json.load(f)
+
+
+def run_preset(compiler, preset, repeat, workdir, seed):
+    source = os.path.join(workdir, f"bench_{preset}.or")
+    generate_source(preset, source, seed)
+
+    runs = [compile_once(compiler, source, workdir) for _ in range(repeat)]
+    lines = runs[0]["source_lines"]
+    size = runs[0]["source_bytes"]
+
+    phases = {}
+    for phase in runs[0]["phases"]:
+        name = phase["name"]
+        wall = statistics.median(
+            p["wall_ms"] for run in runs for p in run["phases"] if p["name"] == name)
+        seconds = max(wall / 1000.0, 1e-9)
+        phases[name] = {
+            "wall_ms": round(wall, 3),
+            "lines_per_sec": round(lines / seconds),
+            "bytes_per_sec": round(size / seconds),
+        }
+        if "count" in phase:
+            phases[name]["count"] = phase["count"]
+            phases[name]["count_unit"] = phase["count_unit"]
+
+    frontend_ms = sum(phases[p]["wall_ms"] for p in FRONTEND_PHASES if p in phases)
+    seconds = max(frontend_ms / 1000.0, 1e-9)
+    phases["frontend"] = {
+        "wall_ms": round(frontend_ms, 3),
+        "lines_per_sec": round(lines / seconds),
+        "bytes_per_sec": round(size / seconds),
+    }
+    return {"preset": preset, "source_lines": lines, "source_bytes": size,
+            "repeat": repeat, "phases": phases}
+
+
+def print_report(results):
+    print(f"{'preset':<8} {'phase':<14} {'wall (ms)':>11} {'lines/s':>13} {'MB/s':>9}  items")
+    for result in results:
+        print(f"{result['preset']:<8} {'source':<14} {'':>11} "
+              f"{result['source_lines']:>13,} {result['source_bytes'] / 1e6:>8.2f}M")
+        for name, phase in result["phases"].items():
+            items = ""
+            if "count" in phase:
+                items = f"{phase['count']:,} {phase['count_unit']}"
+            print(f"{'':<8} {name:<14} {phase['wall_ms']:>11.2f} "
+                  f"{phase['lines_per_sec']:>13,} {phase['bytes_per_sec'] / 1e6:>9.2f}  {items}")
+
+
+def compare(results, baseline_path, max_regression):
+    """Return the list of phases whose throughput dropped more than max_regression percent."""
+    with open(baseline_path) as f:
+        baseline = {r["preset"]: r for r in json.load(f)["results"]}
+
+    regressions = []
+    for result in results:
+        old = baseline.get(result["preset"])
+        if not old:
+            continue
+        for name in FRONTEND_PHASES + ("frontend",):
+            if name not in result["phases"] or name not in old["phases"]:
+                continue
+            before = old["phases"][name]["bytes_per_sec"]
+            after = result["phases"][name]["bytes_per_sec"]
+            if before <= 0:
+                continue
+            change = (after - before) * 100.0 / before
+            print(f"{result['preset']:<8} {name:<14} {change:+7.1f}% bytes/sec vs baseline")
+            if change < -max_regression:
+                regressions.append(f"{result['preset']}/{name} ({change:+.1f}%)")
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Orion compiler throughput benchmark")
+    parser.add_argument("--compiler", default=os.path.join(COMPILER_DIR, "orion"),
+                        help="compiler binary (default: %(default)s)")
+    parser.add_argument("--runtime", default=os.path.join(COMPILER_DIR, "runtime.o"),
+                        help="runtime object the compiler links against")
+    parser.add_argument("--sizes", default="small,medium,large",
+                        help="comma-separated presets: " + ", ".join(PRESETS))
+    parser.add_argument("--repeat", type=int, default=3, help="compilations per preset (median is reported)")
+    parser.add_argument("--seed", type=int, default=1, help="generator seed")
+    parser.add_argument("--json", help="write results to FILE")
+    parser.add_argument("--baseline", help="compare throughput with a previous --json result")
+    parser.add_argument("--max-regression", type=float, default=10.0,
+                        help="percent throughput drop that fails the comparison (default: %(default)s)")
+    args = parser.parse_args()
+
+    sizes = [s for s in args.sizes.split(",") if s]
+    for size in sizes:
+        if size not in PRESETS:
+            parser.error(f"unknown size '{size}'")
+
+    compiler = os.path.abspath(args.compiler)
+    # The driver writes orion_asm.s/orion_exec into its working directory and
+    # links against ./runtime.o, so every run happens in a scratch directory
+    workdir = tempfile.mkdtemp(prefix="orion-bench-")
+    try:
+        os.symlink(os.path.abspath(args.runtime), os.path.join(workdir, "runtime.o"))
+        results = [run_preset(compiler, size, args.repeat, workdir, args.seed) for size in sizes]
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+
+    print_report(results)
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump({"compiler": compiler, "results": results}, f, indent=2)
+            f.write("\n")
+
+    if args.baseline:
+        regressions = compare(results, args.baseline, args.max_regression)
+        if regressions:
+            print("Throughput regressions: " + ", ".join(regressions), file=sys.stderr)
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,600 @@
+// Microbenchmarks for the Orion runtime containers (runtime.c).
+//
+// Every benchmark runs a fixed workload of about N operations per iteration
+// and returns the exact count. After a number of warmup iterations the harness
+// records each iteration's time and reports min/p50/p90/p99/max plus
+// nanoseconds per operation. With --json the results are written as one JSON
+// object per line, which compare_runtime.py diffs between two commits.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+// Runtime entry points (runtime.c has no header; the compiler emits calls directly)
+typedef struct OrionList OrionList;
+typedef struct OrionDict OrionDict;
+typedef struct OrionRange OrionRange;
+
+OrionList* list_new(int64_t initial_capacity);
+void list_release(OrionList* list);
+void list_append(OrionList* list, int64_t value);
+int64_t list_get(OrionList* list, int64_t index);
+int64_t list_pop(OrionList* list);
+int64_t list_len(OrionList* list);
+OrionList* list_new_kind(int64_t initial_capacity, int64_t kind);
+double list_get_float(OrionList* list, int64_t index);
+void list_append_float(OrionList* list, double value);
+int64_t list_get_bool(OrionList* list, int64_t index);
+void list_append_bool(OrionList* list, int64_t truth);
+
+OrionDict* dict_new(int64_t initial_capacity);
+OrionDict* dict_new_str(int64_t initial_capacity);
+void dict_release(OrionDict* dict);
+void dict_set(OrionDict* dict, int64_t key, int64_t value);
+int64_t dict_get(OrionDict* dict, int64_t key);
+int64_t dict_get_default(OrionDict* dict, int64_t key, int64_t default_value);
+int64_t dict_contains(OrionDict* dict, int64_t key);
+void dict_delete(OrionDict* dict, int64_t key);
+OrionList* dict_keys(OrionDict* dict);
+
+// Same layout as the runtime's OrionIter
+typedef struct {
+    int64_t kind;
+    void* source;
+    int64_t position;
+    int64_t limit;
+    int64_t value;
+    int64_t second;
+} OrionIter;
+#define ORION_ITER_DICT_KEYS 3
+void iter_init(OrionIter* it, int64_t kind, void* source);
+int64_t iter_next(OrionIter* it);
+
+char* string_new(const char* str);
+void string_release(char* str);
+int64_t string_len(const char* str);
+char* int_to_string(int64_t value);
+char* string_concat_parts(char** parts, int count);
+typedef struct {
+    char* data;
+    int64_t length;
+    int64_t capacity;
+} OrionStringBuilder;
+void string_builder_reserve(OrionStringBuilder* builder, int64_t capacity);
+void string_builder_append_str(OrionStringBuilder* builder, const char* str);
+void string_builder_append_int(OrionStringBuilder* builder, int64_t value);
+char* string_builder_finish(OrionStringBuilder* builder);
+
+OrionRange* range_new(int64_t start, int64_t stop, int64_t step);
+int64_t range_get(OrionRange* range, int64_t index);
+int64_t range_len(OrionRange* range);
+void range_release(OrionRange* range);
+
+// Keeps results observable so the optimizer cannot drop the work
+static volatile int64_t sink;
+
+static int64_t* random_keys;
+static int64_t random_keys_size;
+
+// xorshift64*, deterministic across runs
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+static uint64_t next_random(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return rng_state * 2685821657736338717ULL;
+}
+
+static void prepare_random_keys(int64_t n) {
+    if (random_keys_size >= n) return;
+    free(random_keys);
+    random_keys = (int64_t*)malloc(sizeof(int64_t) * n);
+    for (int64_t i = 0; i < n; i++) {
+        random_keys[i] = (int64_t)(next_random() >> 1);
+    }
+    random_keys_size = n;
+}
+
+// ---------------------------------------------------------------------------
+// Lists
+
+static int64_t bench_list_append_grow(int64_t n) {
+    OrionList* list = list_new(0);
+    for (int64_t i = 0; i < n; i++) {
+        list_append(list, i);
+    }
+    sink = list_len(list);
+    list_release(list);
+    return n;
+}
+
+static int64_t bench_list_append_presized(int64_t n) {
+    OrionList* list = list_new(n);
+    for (int64_t i = 0; i < n; i++) {
+        list_append(list, i);
+    }
+    sink = list_len(list);
+    list_release(list);
+    return n;
+}
+
+static int64_t bench_list_get_sequential(int64_t n) {
+    static OrionList* list;
+    static int64_t built;
+    if (built != n) {
+        if (list) list_release(list);
+        list = list_new(n);
+        for (int64_t i = 0; i < n; i++) list_append(list, i);
+        built = n;
+    }
+    int64_t sum = 0;
+    for (int64_t i = 0; i < n; i++) {
+        sum += list_get(list, i);
+    }
+    sink = sum;
+    return n;
+}
+
+static int64_t bench_list_push_pop(int64_t n) {
+    // Sawtooth: grow to n, drain to zero, exercising grow and shrink paths
+    OrionList* list = list_new(8);
+    for (int64_t i = 0; i < n; i++) list_append(list, i);
+    int64_t sum = 0;
+    while (list_len(list) > 0) sum += list_pop(list);
+    sink = sum;
+    list_release(list);
+    return n;
+}
+
+static int64_t bench_list_many_small(int64_t n) {
+    // Short-lived small lists, the common case for literals and temporaries
+    for (int64_t i = 0; i < n / 4; i++) {
+        OrionList* list = list_new(4);
+        list_append(list, i);
+        list_append(list, i + 1);
+        list_append(list, i + 2);
+        list_append(list, i + 3);
+        sink = list_get(list, 2);
+        list_release(list);
+    }
+    return n / 4 * 4;
+}
+
+static int64_t bench_list_float_typed(int64_t n) {
+    // list[float] through the typed entry points: dense double storage
+    OrionList* list = list_new_kind(4, 1);
+    for (int64_t i = 0; i < n; i++) list_append_float(list, (double)i * 0.5);
+    double sum = 0.0;
+    for (int64_t i = 0; i < n; i++) sum += list_get_float(list, i);
+    sink = (int64_t)sum;
+    list_release(list);
+    return n;
+}
+
+static int64_t bench_list_bool_packed(int64_t n) {
+    // list[bool], one bit per element
+    OrionList* list = list_new_kind(4, 2);
+    for (int64_t i = 0; i < n; i++) list_append_bool(list, (i & 3) == 0);
+    int64_t count = 0;
+    for (int64_t i = 0; i < n; i++) count += list_get_bool(list, i);
+    sink = count;
+    list_release(list);
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// Dicts
+
+static int64_t bench_dict_insert_sequential(int64_t n) {
+    OrionDict* dict = dict_new(8);
+    for (int64_t i = 0; i < n; i++) {
+        dict_set(dict, i, i);
+    }
+    dict_release(dict);
+    return n;
+}
+
+static int64_t bench_dict_insert_random(int64_t n) {
+    prepare_random_keys(n);
+    OrionDict* dict = dict_new(8);
+    for (int64_t i = 0; i < n; i++) {
+        dict_set(dict, random_keys[i], i);
+    }
+    dict_release(dict);
+    return n;
+}
+
+static OrionDict* lookup_dict;
+static int64_t lookup_dict_size;
+
+static void prepare_lookup_dict(int64_t n) {
+    if (lookup_dict_size == n) return;
+    prepare_random_keys(n);
+    if (lookup_dict) dict_release(lookup_dict);
+    lookup_dict = dict_new(8);
+    for (int64_t i = 0; i < n; i++) {
+        dict_set(lookup_dict, random_keys[i], i);
+    }
+    lookup_dict_size = n;
+}
+
+static int64_t bench_dict_lookup_hit(int64_t n) {
+    prepare_lookup_dict(n);
+    int64_t sum = 0;
+    for (int64_t i = 0; i < n; i++) {
+        sum += dict_get(lookup_dict, random_keys[(i * 7919) % n]);
+    }
+    sink = sum;
+    return n;
+}
+
+static int64_t bench_dict_lookup_miss(int64_t n) {
+    prepare_lookup_dict(n);
+    int64_t found = 0;
+    for (int64_t i = 0; i < n; i++) {
+        // Keys in random_keys are non-negative, so negative keys always miss
+        found += dict_contains(lookup_dict, -1 - i);
+    }
+    sink = found;
+    return n;
+}
+
+static int64_t bench_dict_mixed(int64_t n) {
+    // 60% lookup, 25% insert/update, 15% delete over a working set of n/4 keys
+    int64_t keyspace = n / 4 > 0 ? n / 4 : 1;
+    OrionDict* dict = dict_new(8);
+    uint64_t state = 12345;
+    int64_t sum = 0;
+    for (int64_t i = 0; i < n; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        int64_t key = (int64_t)((state >> 33) % (uint64_t)keyspace);
+        int op = (int)((state >> 20) % 100);
+        if (op < 60) {
+            sum += dict_get_default(dict, key, 0);
+        } else if (op < 85) {
+            dict_set(dict, key, i);
+        } else if (dict_contains(dict, key)) {
+            dict_delete(dict, key);
+        }
+    }
+    sink = sum;
+    dict_release(dict);
+    return n;
+}
+
+static int64_t bench_dict_iterate_copy(int64_t n) {
+    // What for-in over dict_keys() costs: copy the keys, then index the list
+    prepare_lookup_dict(n);
+    OrionList* keys = dict_keys(lookup_dict);
+    int64_t sum = 0;
+    for (int64_t i = 0; i < list_len(keys); i++) {
+        sum += list_get(keys, i);
+    }
+    list_release(keys);
+    sink = sum;
+    return n;
+}
+
+static int64_t bench_dict_iterate_cursor(int64_t n) {
+    // for-in over a dict: walk the entries in place
+    prepare_lookup_dict(n);
+    OrionIter it;
+    int64_t sum = 0;
+    iter_init(&it, ORION_ITER_DICT_KEYS, lookup_dict);
+    while (iter_next(&it)) {
+        sum += it.value;
+    }
+    sink = sum;
+    return n;
+}
+
+static char** string_keys;
+static char** string_probes;
+static int64_t string_keys_size;
+
+// Equal strings in two separate allocations, so lookups cannot match by pointer
+static void prepare_string_keys(int64_t n) {
+    if (string_keys_size == n) return;
+    for (int64_t i = 0; i < string_keys_size; i++) {
+        string_release(string_keys[i]);
+        string_release(string_probes[i]);
+    }
+    free(string_keys);
+    free(string_probes);
+    string_keys = (char**)malloc(sizeof(char*) * (size_t)n);
+    string_probes = (char**)malloc(sizeof(char*) * (size_t)n);
+    for (int64_t i = 0; i < n; i++) {
+        string_keys[i] = int_to_string(i * 7919);
+        string_probes[i] = int_to_string(i * 7919);
+    }
+    string_keys_size = n;
+}
+
+static int64_t bench_dict_string_keys(int64_t n) {
+    // Insert n decimal strings, then look every one up through an equal copy
+    prepare_string_keys(n);
+    OrionDict* dict = dict_new_str(8);
+    for (int64_t i = 0; i < n; i++) {
+        dict_set(dict, (int64_t)string_keys[i], i);
+    }
+    int64_t sum = 0;
+    for (int64_t i = 0; i < n; i++) {
+        sum += dict_get(dict, (int64_t)string_probes[i]);
+    }
+    sink = sum;
+    dict_release(dict);
+    return n;
+}
+
+static int64_t bench_dict_churn(int64_t n) {
+    // Sliding window of 1024 live keys: insert one, delete the oldest.
+    // Stresses tombstone handling in the open-addressing table.
+    OrionDict* dict = dict_new(8);
+    const int64_t window = 1024;
+    for (int64_t i = 0; i < n; i++) {
+        dict_set(dict, i, i);
+        if (i >= window) {
+            dict_delete(dict, i - window);
+        }
+    }
+    dict_release(dict);
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// Strings and ranges
+
+static int64_t bench_int_to_string(int64_t n) {
+    int64_t total = 0;
+    for (int64_t i = 0; i < n; i++) {
+        char* text = int_to_string(i * 1000003);
+        total += string_len(text);
+        string_release(text);
+    }
+    sink = total;
+    return n;
+}
+
+static int64_t bench_concat_parts_short(int64_t n) {
+    // Typical interpolation: "name=${name} id=${id}"
+    char* parts[4] = {string_new("name="), string_new("orion"), string_new(" id="), string_new("42")};
+    for (int64_t i = 0; i < n; i++) {
+        char* text = string_concat_parts(parts, 4);
+        sink = text[0];
+        string_release(text);
+    }
+    for (int i = 0; i < 4; i++) string_release(parts[i]);
+    return n;
+}
+
+static int64_t bench_builder_line(int64_t n) {
+    // "item ${i}: ${name}" as the compiler emits it: one reserved builder
+    char* item = string_new("item ");
+    char* colon = string_new(": ");
+    char* name = string_new("orion");
+    for (int64_t i = 0; i < n; i++) {
+        OrionStringBuilder builder;
+        string_builder_reserve(&builder, 5 + 20 + 2 + 16);
+        string_builder_append_str(&builder, item);
+        string_builder_append_int(&builder, i);
+        string_builder_append_str(&builder, colon);
+        string_builder_append_str(&builder, name);
+        char* text = string_builder_finish(&builder);
+        sink = text[0];
+        string_release(text);
+    }
+    string_release(item);
+    string_release(colon);
+    string_release(name);
+    return n;
+}
+
+static int64_t bench_concat_parts_wide(int64_t n) {
+    // Long interpolation with 32 segments
+    char* parts[32];
+    for (int i = 0; i < 32; i++) {
+        parts[i] = string_new((i % 2 == 0) ? "segment text " : "12345");
+    }
+    for (int64_t i = 0; i < n / 8; i++) {
+        char* text = string_concat_parts(parts, 32);
+        sink = text[0];
+        string_release(text);
+    }
+    for (int i = 0; i < 32; i++) string_release(parts[i]);
+    return n / 8;
+}
+
+static int64_t bench_string_build_loop(int64_t n) {
+    // s = "${s}x" in a loop: each step copies the whole accumulated string
+    int64_t steps = n / 16 > 0 ? n / 16 : 1;
+    char* acc = string_concat_parts(NULL, 0);
+    char* parts[2];
+    parts[1] = string_new("x");
+    for (int64_t i = 0; i < steps; i++) {
+        parts[0] = acc;
+        char* next = string_concat_parts(parts, 2);
+        string_release(acc);
+        acc = next;
+    }
+    sink = string_len(acc);
+    string_release(acc);
+    string_release(parts[1]);
+    return steps;
+}
+
+static int64_t bench_range_iterate(int64_t n) {
+    OrionRange* range = range_new(0, n, 1);
+    int64_t sum = 0;
+    int64_t len = range_len(range);
+    for (int64_t i = 0; i < len; i++) {
+        sum += range_get(range, i);
+    }
+    sink = sum;
+    range_release(range);
+    return n;
+}
+
+static int64_t bench_range_new(int64_t n) {
+    for (int64_t i = 0; i < n; i++) {
+        OrionRange* range = range_new(0, i + 1, 1);
+        sink = range_len(range);
+        range_release(range);
+    }
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// Harness
+
+typedef struct {
+    const char* name;
+    const char* group;
+    int64_t (*run)(int64_t n);  // Returns the number of operations it performed
+} Benchmark;
+
+static const Benchmark benchmarks[] = {
+    {"list_append_grow", "list", bench_list_append_grow},
+    {"list_append_presized", "list", bench_list_append_presized},
+    {"list_get_sequential", "list", bench_list_get_sequential},
+    {"list_push_pop", "list", bench_list_push_pop},
+    {"list_many_small", "list", bench_list_many_small},
+    {"list_float_typed", "list", bench_list_float_typed},
+    {"list_bool_packed", "list", bench_list_bool_packed},
+    {"dict_insert_sequential", "dict", bench_dict_insert_sequential},
+    {"dict_insert_random", "dict", bench_dict_insert_random},
+    {"dict_lookup_hit", "dict", bench_dict_lookup_hit},
+    {"dict_lookup_miss", "dict", bench_dict_lookup_miss},
+    {"dict_mixed", "dict", bench_dict_mixed},
+    {"dict_churn", "dict", bench_dict_churn},
+    {"dict_string_keys", "dict", bench_dict_string_keys},
+    {"dict_iterate_copy", "dict", bench_dict_iterate_copy},
+    {"dict_iterate_cursor", "dict", bench_dict_iterate_cursor},
+    {"int_to_string", "string", bench_int_to_string},
+    {"concat_parts_short", "string", bench_concat_parts_short},
+    {"concat_parts_wide", "string", bench_concat_parts_wide},
+    {"builder_line", "string", bench_builder_line},
+    {"string_build_loop", "string", bench_string_build_loop},
+    {"range_iterate", "range", bench_range_iterate},
+    {"range_new", "range", bench_range_new},
+};
+
+typedef struct {
+    int64_t size;
+    int warmup;
+    int iterations;
+    int json;
+    const char* filter;
+} Options;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of a sorted sample
+static double percentile(const double* sorted, int count, double p) {
+    int rank = (int)(p / 100.0 * count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > count) rank = count;
+    return sorted[rank - 1];
+}
+
+static void run_benchmark(const Benchmark* bench, const Options* options) {
+    for (int i = 0; i < options->warmup; i++) {
+        bench->run(options->size);
+    }
+
+    double* samples = (double*)malloc(sizeof(double) * options->iterations);
+    int64_t operations = 1;
+    for (int i = 0; i < options->iterations; i++) {
+        double start = now_ns();
+        operations = bench->run(options->size);
+        samples[i] = now_ns() - start;
+    }
+    qsort(samples, options->iterations, sizeof(double), compare_doubles);
+
+    int count = options->iterations;
+    double mean = 0;
+    for (int i = 0; i < count; i++) mean += samples[i];
+    mean /= count;
+    double p50 = percentile(samples, count, 50);
+    double p90 = percentile(samples, count, 90);
+    double p99 = percentile(samples, count, 99);
+    double ns_per_op = p50 / (double)(operations > 0 ? operations : 1);
+
+    if (options->json) {
+        printf("{\"benchmark\": \"%s\", \"group\": \"%s\", \"size\": %ld, \"iterations\": %d, "
+               "\"min_ns\": %.0f, \"p50_ns\": %.0f, \"p90_ns\": %.0f, \"p99_ns\": %.0f, "
+               "\"max_ns\": %.0f, \"mean_ns\": %.0f, \"ns_per_op\": %.3f}\n",
+               bench->name, bench->group, (long)options->size, count,
+               samples[0], p50, p90, p99, samples[count - 1], mean, ns_per_op);
+    } else {
+        printf("%-24s %12.1f %12.1f %12.1f %12.1f %10.2f\n",
+               bench->name, samples[0] / 1e3, p50 / 1e3, p90 / 1e3, p99 / 1e3, ns_per_op);
+    }
+    fflush(stdout);
+    free(samples);
+}
+
+static void print_usage(const char* program) {
+    fprintf(stderr, "Usage: %s [options]\n", program);
+    fprintf(stderr, "  --size N         Operations per iteration (default 100000)\n");
+    fprintf(stderr, "  --warmup N       Untimed warmup iterations (default 3)\n");
+    fprintf(stderr, "  --iterations N   Timed iterations (default 30)\n");
+    fprintf(stderr, "  --filter TEXT    Only run benchmarks whose name contains TEXT\n");
+    fprintf(stderr, "  --json           Emit one JSON object per benchmark\n");
+    fprintf(stderr, "  --list           List benchmark names\n");
+}
+
+int main(int argc, char** argv) {
+    Options options = {100000, 3, 30, 0, NULL};
+    size_t count = sizeof(benchmarks) / sizeof(benchmarks[0]);
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        int has_value = i + 1 < argc;
+        if (strcmp(arg, "--size") == 0 && has_value) {
+            options.size = atoll(argv[++i]);
+        } else if (strcmp(arg, "--warmup") == 0 && has_value) {
+            options.warmup = atoi(argv[++i]);
+        } else if (strcmp(arg, "--iterations") == 0 && has_value) {
+            options.iterations = atoi(argv[++i]);
+        } else if (strcmp(arg, "--filter") == 0 && has_value) {
+            options.filter = argv[++i];
+        } else if (strcmp(arg, "--json") == 0) {
+            options.json = 1;
+        } else if (strcmp(arg, "--list") == 0) {
+            for (size_t b = 0; b < count; b++) printf("%s\n", benchmarks[b].name);
+            return 0;
+        } else {
+            print_usage(argv[0]);
+            return strcmp(arg, "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (options.size <= 0 || options.iterations <= 0 || options.warmup < 0) {
+        fprintf(stderr, "Error: --size and --iterations must be positive\n");
+        return 1;
+    }
+
+    if (!options.json) {
+        printf("size=%ld warmup=%d iterations=%d (times in microseconds per iteration)\n",
+               (long)options.size, options.warmup, options.iterations);
+        printf("%-24s %12s %12s %12s %12s %10s\n", "benchmark", "min", "p50", "p90", "p99", "ns/op");
+    }
+    for (size_t b = 0; b < count; b++) {
+        if (options.filter && !strstr(benchmarks[b].name, options.filter)) continue;
+        run_benchmark(&benchmarks[b], &options);
+    }
+    return 0;
+}
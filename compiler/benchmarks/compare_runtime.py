@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""Compare two `bench_runtime --json` result files.
+
+Prints the p50 change of every benchmark present in both files and exits with
+status 1 if any benchmark slowed down by more than --max-regression percent.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    results = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith("{"):
+                entry = json.loads(line)
+                results[entry["benchmark"]] = entry
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare runtime benchmark results")
+    parser.add_argument("baseline", help="JSON-lines output of the old build")
+    parser.add_argument("current", help="JSON-lines output of the new build")
+    parser.add_argument("--metric", default="p50_ns", help="field to compare (default: %(default)s)")
+    parser.add_argument("--max-regression", type=float, default=10.0,
+                        help="percent slowdown that fails the comparison (default: %(default)s)")
+    args = parser.parse_args()
+
+    old = load(args.baseline)
+    new = load(args.current)
+
+    print(f"{'benchmark':<24} {'old ns/op':>12} {'new ns/op':>12} {'change':>9}")
+    regressions = []
+    for name, entry in new.items():
+        if name not in old or old[name][args.metric] <= 0:
+            continue
+        before = old[name][args.metric] / old[name]["size"]
+        after = entry[args.metric] / entry["size"]
+        change = (after - before) * 100.0 / before
+        flag = "  REGRESSION" if change > args.max_regression else ""
+        print(f"{name:<24} {before:>12.2f} {after:>12.2f} {change:>+8.1f}%{flag}")
+        if flag:
+            regressions.append(name)
+
+    if regressions:
+        print("Regressed: " + ", ".join(regressions), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
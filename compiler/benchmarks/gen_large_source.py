@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""Generate large synthetic Orion programs for compiler throughput benchmarks.
+
+The output exercises the parts of the front end whose cost grows with input
+size: many function declarations, deeply nested control flow, long string
+interpolations and huge list literals. Only constructs the current parser and
+code generator accept are emitted, and the output is deterministic for a given
+set of options.
+"""
+
+import argparse
+import random
+import sys
+
+
+def emit_nested_block(lines, depth, max_depth, indent, rng):
+    """Emit if/while/for blocks nested max_depth levels deep."""
+    pad = "    " * indent
+    if depth >= max_depth:
+        lines.append(f"{pad}acc = acc + {rng.randint(1, 9)}")
+        return
+
+    kind = depth % 3
+    if kind == 0:
+        lines.append(f"{pad}if acc > {rng.randint(0, 100)} {{")
+        emit_nested_block(lines, depth + 1, max_depth, indent + 1, rng)
+        lines.append(f"{pad}}} else {{")
+        lines.append(f"{pad}    acc = acc - 1")
+        lines.append(f"{pad}}}")
+    elif kind == 1:
+        lines.append(f"{pad}while acc < {rng.randint(1, 50)} {{")
+        lines.append(f"{pad}    acc = acc + 1")
+        emit_nested_block(lines, depth + 1, max_depth, indent + 1, rng)
+        lines.append(f"{pad}}}")
+    else:
+        lines.append(f"{pad}for i{depth} in range({rng.randint(1, 4)}) {{")
+        emit_nested_block(lines, depth + 1, max_depth, indent + 1, rng)
+        lines.append(f"{pad}}}")
+
+
+def emit_function(lines, index, nesting, rng):
+    lines.append(f"fn bench_fn_{index}(a, b) {{")
+    lines.append(f"    acc = a * {rng.randint(1, 9)} + b - {rng.randint(0, 9)}")
+    lines.append(f"    tmp = (acc + {rng.randint(1, 99)}) * (b - {rng.randint(1, 9)}) / {rng.randint(1, 9)}")
+    emit_nested_block(lines, 0, nesting, 1, rng)
+    if index > 0:
+        lines.append(f"    acc = acc + bench_fn_{rng.randrange(index)}(acc, tmp)")
+    lines.append("    return acc")
+    lines.append("}")
+    lines.append("")
+
+
+def emit_interpolations(lines, count, parts):
+    names = [f"label_{i}" for i in range(parts)]
+    for i, name in enumerate(names):
+        lines.append(f'{name} = "part{i}"')
+    for i in range(count):
+        pieces = " ".join(f"{name}=${{{name}}}" for name in names)
+        lines.append(f'message_{i} = "msg {i}: {pieces}"')
+    lines.append("")
+
+
+def emit_lists(lines, count, size, rng):
+    for i in range(count):
+        values = ", ".join(str(rng.randint(0, 1000000)) for _ in range(size))
+        lines.append(f"table_{i} = [{values}]")
+    lines.append("")
+
+
+def generate(options):
+    rng = random.Random(options.seed)
+    lines = [
+        "# Synthetic compiler benchmark input, generated by gen_large_source.py",
+        f"# functions={options.functions} nesting={options.nesting} "
+        f"interpolations={options.interpolations}x{options.interp_parts} "
+        f"lists={options.lists}x{options.list_size} seed={options.seed}",
+        "",
+    ]
+    for index in range(options.functions):
+        emit_function(lines, index, options.nesting, rng)
+    emit_interpolations(lines, options.interpolations, options.interp_parts)
+    emit_lists(lines, options.lists, options.list_size, rng)
+    if options.functions > 0:
+        lines.append(f"out(bench_fn_{options.functions - 1}(1, 2))")
+    return "\n".join(lines) + "\n"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("-o", "--output", help="write to FILE instead of stdout")
+    parser.add_argument("--functions", type=int, default=2000, help="number of function declarations")
+    parser.add_argument("--nesting", type=int, default=12, help="control-flow nesting depth per function")
+    parser.add_argument("--interpolations", type=int, default=200, help="number of interpolated strings")
+    parser.add_argument("--interp-parts", type=int, default=40, help="${} segments per interpolated string")
+    parser.add_argument("--lists", type=int, default=20, help="number of list literals")
+    parser.add_argument("--list-size", type=int, default=5000, help="elements per list literal")
+    parser.add_argument("--seed", type=int, default=1, help="random seed")
+    options = parser.parse_args()
+
+    source = generate(options)
+    if options.output:
+        with open(options.output, "w") as out:
+            out.write(source)
+    else:
+        sys.stdout.write(source)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,57 @@
+// Fannkuch-redux: permutation generation and prefix reversals on small int arrays
+#include <stdio.h>
+#include <stdint.h>
+
+int main(void) {
+    enum { N = 9 };
+    int64_t perm1[N], perm[N], count[N];
+    for (int64_t i = 0; i < N; i++) perm1[i] = i;
+
+    int64_t max_flips = 0, checksum = 0, perm_count = 0;
+    int64_t r = N;
+    int done = 0;
+
+    while (!done) {
+        while (r != 1) {
+            count[r - 1] = r;
+            r--;
+        }
+        for (int64_t i = 0; i < N; i++) perm[i] = perm1[i];
+
+        int64_t flips = 0;
+        int64_t k = perm[0];
+        while (k != 0) {
+            int64_t lo = 0, hi = k;
+            while (lo < hi) {
+                int64_t t = perm[lo];
+                perm[lo] = perm[hi];
+                perm[hi] = t;
+                lo++;
+                hi--;
+            }
+            flips++;
+            k = perm[0];
+        }
+
+        if (flips > max_flips) max_flips = flips;
+        checksum += (perm_count % 2 == 0) ? flips : -flips;
+
+        for (;;) {
+            if (r == N) {
+                done = 1;
+                break;
+            }
+            int64_t perm0 = perm1[0];
+            for (int64_t i = 0; i < r; i++) perm1[i] = perm1[i + 1];
+            perm1[r] = perm0;
+            count[r]--;
+            if (count[r] > 0) break;
+            r++;
+        }
+        perm_count++;
+    }
+
+    printf("%d\n", (int)checksum);
+    printf("%d\n", (int)max_flips);
+    return 0;
+}
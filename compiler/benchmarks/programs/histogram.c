@@ -0,0 +1,64 @@
+// Dict-heavy histogram: bucket pseudo-random samples by key and summarize.
+// Uses a small open-addressing hash table so the comparison is hash map to hash map.
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef struct {
+    int64_t* keys;
+    int64_t* values;
+    unsigned char* used;
+    int64_t capacity;
+    int64_t size;
+} Map;
+
+static void map_init(Map* map, int64_t capacity) {
+    map->keys = calloc(capacity, sizeof(int64_t));
+    map->values = calloc(capacity, sizeof(int64_t));
+    map->used = calloc(capacity, 1);
+    map->capacity = capacity;
+    map->size = 0;
+}
+
+static int64_t* map_slot(Map* map, int64_t key) {
+    uint64_t index = ((uint64_t)key * 11400714819323198485ULL) & (map->capacity - 1);
+    while (map->used[index] && map->keys[index] != key) {
+        index = (index + 1) & (map->capacity - 1);
+    }
+    if (!map->used[index]) {
+        map->used[index] = 1;
+        map->keys[index] = key;
+        map->values[index] = 0;
+        map->size++;
+    }
+    return &map->values[index];
+}
+
+int main(void) {
+    const int64_t buckets = 1000;
+    Map counts, sparse;
+    map_init(&counts, 2048);
+    map_init(&sparse, 2048);
+    for (int64_t k = 0; k < buckets; k++) *map_slot(&counts, k) = 0;
+
+    int64_t seed = 7;
+    for (int64_t i = 0; i < 1000000; i++) {
+        seed = seed * 48271 % 2147483647;
+        *map_slot(&counts, seed % buckets) += 1;
+    }
+
+    *map_slot(&sparse, 0) = 0;
+    for (int64_t k = 0; k < buckets; k++) *map_slot(&sparse, k * 7919) = *map_slot(&counts, k);
+
+    int64_t total = 0, max_count = 0, max_key = 0;
+    for (int64_t k = 0; k < buckets; k++) {
+        int64_t v = *map_slot(&sparse, k * 7919);
+        total += v;
+        if (v > max_count) {
+            max_count = v;
+            max_key = k;
+        }
+    }
+    printf("%d\n%d\n%d\n%d\n", (int)counts.size, (int)total, (int)max_key, (int)max_count);
+    return 0;
+}
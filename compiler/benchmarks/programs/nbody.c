@@ -0,0 +1,78 @@
+// N-body: Jovian planets orbiting the sun, float arithmetic over parallel arrays
+#include <stdio.h>
+#include <math.h>
+
+#define NBODIES 5
+
+int main(void) {
+    const double pi = 3.141592653589793;
+    const double solar_mass = 4.0 * pi * pi;
+    const double days_per_year = 365.24;
+    const double dt = 0.01;
+    const int steps = 100000;
+
+    // Sun, Jupiter, Saturn, Uranus, Neptune
+    double x[NBODIES] = {0.0, 4.84143144246472090, 8.34336671824457987, 12.8943695621391310, 15.3796971148509165};
+    double y[NBODIES] = {0.0, -1.16032004402742839, 4.12479856412430479, -15.1111514016986312, -25.9193146099879641};
+    double z[NBODIES] = {0.0, -0.103622044471123109, -0.403523417114321381, -0.223307578892655734, 0.179258772950371181};
+    double vx[NBODIES] = {0.0, 0.00166007664274403694, -0.00276742510726862411, 0.00296460137564761618, 0.00268067772490389322};
+    double vy[NBODIES] = {0.0, 0.00769901118419740425, 0.00499852801234917238, 0.00237847173959480950, 0.00162824170038242295};
+    double vz[NBODIES] = {0.0, -0.0000690460016972063023, 0.0000230417297573763929, -0.0000296589568540237556, -0.0000951592254519715870};
+    double mass[NBODIES] = {1.0, 0.000954791938424326609, 0.000285885980666130812, 0.0000436624404335156298, 0.0000515138902046611451};
+
+    for (int i = 0; i < NBODIES; i++) {
+        vx[i] *= days_per_year;
+        vy[i] *= days_per_year;
+        vz[i] *= days_per_year;
+        mass[i] *= solar_mass;
+    }
+
+    // Offset the sun's momentum so the system's total momentum is zero
+    double px = 0.0, py = 0.0, pz = 0.0;
+    for (int i = 0; i < NBODIES; i++) {
+        px += vx[i] * mass[i];
+        py += vy[i] * mass[i];
+        pz += vz[i] * mass[i];
+    }
+    vx[0] = 0.0 - px / solar_mass;
+    vy[0] = 0.0 - py / solar_mass;
+    vz[0] = 0.0 - pz / solar_mass;
+
+    for (int step = 0; step < steps; step++) {
+        for (int i = 0; i < NBODIES; i++) {
+            for (int j = i + 1; j < NBODIES; j++) {
+                double dx = x[i] - x[j];
+                double dy = y[i] - y[j];
+                double dz = z[i] - z[j];
+                double d2 = dx * dx + dy * dy + dz * dz;
+                double mag = dt / (d2 * pow(d2, 0.5));
+                double mi = mass[i] * mag;
+                double mj = mass[j] * mag;
+                vx[i] -= dx * mj;
+                vy[i] -= dy * mj;
+                vz[i] -= dz * mj;
+                vx[j] += dx * mi;
+                vy[j] += dy * mi;
+                vz[j] += dz * mi;
+            }
+        }
+        for (int i = 0; i < NBODIES; i++) {
+            x[i] += dt * vx[i];
+            y[i] += dt * vy[i];
+            z[i] += dt * vz[i];
+        }
+    }
+
+    double e = 0.0;
+    for (int i = 0; i < NBODIES; i++) {
+        e += 0.5 * mass[i] * (vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i]);
+        for (int j = i + 1; j < NBODIES; j++) {
+            double dx = x[i] - x[j];
+            double dy = y[i] - y[j];
+            double dz = z[i] - z[j];
+            e -= mass[i] * mass[j] / pow(dx * dx + dy * dy + dz * dz, 0.5);
+        }
+    }
+    printf("%d\n", (int)(e * 1000000000.0));
+    return 0;
+}
@@ -0,0 +1,21 @@
+// Call-heavy recursion: naive Fibonacci and the Ackermann function
+#include <stdio.h>
+#include <stdint.h>
+
+static int64_t fib(int64_t n) {
+    if (n < 2) return n;
+    return fib(n - 1) + fib(n - 2);
+}
+
+static int64_t ack(int64_t m, int64_t n) {
+    if (m == 0) return n + 1;
+    if (n == 0) return ack(m - 1, 1);
+    return ack(m - 1, ack(m, n - 1));
+}
+
+int main(void) {
+    printf("%d\n", (int)fib(30));
+    printf("%d\n", (int)ack(2, 2000));
+    printf("%d\n", (int)ack(3, 7));
+    return 0;
+}
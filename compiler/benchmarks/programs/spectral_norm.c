@@ -0,0 +1,45 @@
+// Spectral norm: repeated float matrix-vector products with an implicit matrix
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+
+static double eval_a(int64_t i, int64_t j) {
+    return 1.0 / ((i + j) * (i + j + 1) / 2 + i + 1);
+}
+
+static void mul_av(int n, const double* x, double* out) {
+    for (int i = 0; i < n; i++) {
+        double s = 0.0;
+        for (int j = 0; j < n; j++) s += eval_a(i, j) * x[j];
+        out[i] = s;
+    }
+}
+
+static void mul_atv(int n, const double* x, double* out) {
+    for (int i = 0; i < n; i++) {
+        double s = 0.0;
+        for (int j = 0; j < n; j++) s += eval_a(j, i) * x[j];
+        out[i] = s;
+    }
+}
+
+int main(void) {
+    enum { N = 300 };
+    static double u[N], v[N], tmp[N];
+    for (int i = 0; i < N; i++) u[i] = 1.0;
+
+    for (int step = 0; step < 10; step++) {
+        mul_av(N, u, tmp);
+        mul_atv(N, tmp, v);
+        mul_av(N, v, tmp);
+        mul_atv(N, tmp, u);
+    }
+
+    double vbv = 0.0, vv = 0.0;
+    for (int i = 0; i < N; i++) {
+        vbv += u[i] * v[i];
+        vv += v[i] * v[i];
+    }
+    printf("%d\n", (int)(sqrt(vbv / vv) * 1000000000.0));
+    return 0;
+}
@@ -0,0 +1,39 @@
+// String building: format many short lines and grow one long string by appending.
+// Every step allocates a fresh string, matching what Orion interpolation does.
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+int main(void) {
+    const char* name = "orion";
+    char* line = NULL;
+    for (int64_t i = 0; i < 300000; i++) {
+        char buffer[64];
+        int length = snprintf(buffer, sizeof(buffer), "item %lld: %s", (long long)i, name);
+        free(line);
+        line = malloc(length + 1);
+        memcpy(line, buffer, length + 1);
+    }
+
+    char* s = calloc(1, 1);
+    for (int64_t i = 0; i < 4000; i++) {
+        size_t length = strlen(s);
+        char* next = malloc(length + 3);
+        memcpy(next, s, length);
+        memcpy(next + length, "ab", 3);
+        free(s);
+        s = next;
+    }
+    size_t length = strlen(s);
+    char* tail = malloc(length + 2);
+    memcpy(tail, s, length);
+    memcpy(tail + length, "!", 2);
+
+    printf("%d\n", (int)strlen(tail));
+    printf("%s", line);
+    free(line);
+    free(s);
+    free(tail);
+    return 0;
+}
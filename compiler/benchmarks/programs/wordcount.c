@@ -0,0 +1,44 @@
+// Word count: tokenize a generated character stream and tally word lengths
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+int main(void) {
+    const int64_t n = 2000000;
+    int64_t* text = malloc(sizeof(int64_t) * n);
+    int64_t seed = 42;
+    for (int64_t i = 0; i < n; i++) {
+        seed = seed * 48271 % 2147483647;
+        int64_t r = seed % 100;
+        if (r < 15) text[i] = 32;
+        else if (r < 17) text[i] = 10;
+        else text[i] = 97 + r % 26;
+    }
+
+    int64_t lines = 0, words = 0, in_word = 0, word_len = 0;
+    int64_t lengths[32] = {0};
+    for (int64_t i = 0; i < n; i++) {
+        int64_t c = text[i];
+        if (c == 10) lines++;
+        if (c == 32 || c == 10) {
+            if (in_word == 1) {
+                words++;
+                if (word_len > 31) word_len = 31;
+                lengths[word_len]++;
+            }
+            in_word = 0;
+            word_len = 0;
+        } else {
+            in_word = 1;
+            word_len++;
+        }
+    }
+
+    int64_t longest = 0;
+    for (int64_t k = 0; k < 32; k++) {
+        if (lengths[k] > 0) longest = k;
+    }
+    printf("%d\n%d\n%d\n%d\n%d\n", (int)lines, (int)words, (int)longest, (int)lengths[1], (int)lengths[5]);
+    free(text);
+    return 0;
+}
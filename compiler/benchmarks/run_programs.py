@@ -0,0 +1,210 @@
+#!/usr/bin/env python3
+"""End-to-end program benchmarks against C reference implementations.
+
+Every program in benchmarks/programs/ exists twice: NAME.or and NAME.c, written
+to compute exactly the same result. The Orion version is compiled with
+`orion --no-run`, the C version with `gcc -O2`, both are run several times and
+the report shows median wall time, peak RSS and the Orion/C ratio of each.
+Outputs are compared byte for byte so a miscompilation never shows up as a
+speedup.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+COMPILER_DIR = os.path.dirname(BENCH_DIR)
+PROGRAMS_DIR = os.path.join(BENCH_DIR, "programs")
+
+
+def discover_programs():
+    names = []
+    for entry in sorted(os.listdir(PROGRAMS_DIR)):
+        name, ext = os.path.splitext(entry)
+        if ext == ".or" and os.path.exists(os.path.join(PROGRAMS_DIR, name + ".c")):
+            names.append(name)
+    return names
+
+
+def build_orion(compiler, flags, name, workdir):
+    source = os.path.join(PROGRAMS_DIR, name + ".or")
+    result = subprocess.run([compiler] + flags + [source, "--no-run"], cwd=workdir,
+                            stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+    if result.returncode != 0:
+        raise RuntimeError(f"orion failed to compile {source}:\n{result.stderr}")
+    executable = os.path.join(workdir, name + ".orion")
+    shutil.move(os.path.join(workdir, "orion_exec"), executable)
+    return executable
+
+
+def build_c(cc, cflags, name, workdir):
+    source = os.path.join(PROGRAMS_DIR, name + ".c")
+    executable = os.path.join(workdir, name + ".c.exe")
+    result = subprocess.run([cc] + cflags + ["-o", executable, source, "-lm"],
+                            stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+    if result.returncode != 0:
+        raise RuntimeError(f"{cc} failed to compile {source}:\n{result.stderr}")
+    return executable
+
+
+# Peak RSS is read with wait4() in a small native launcher: a child forked
+# straight from Python inherits the interpreter's high-water mark, which would
+# put a floor of several MB under every measurement
+LAUNCHER_SOURCE = r"""
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+int main(int argc, char** argv) {
+    if (argc < 3) return 2;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pid_t pid = fork();
+    if (pid < 0) return 2;
+    if (pid == 0) {
+        execv(argv[2], argv + 2);
+        _exit(127);
+    }
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0) return 2;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    FILE* out = fopen(argv[1], "w");
+    if (!out) return 2;
+    fprintf(out, "%.6f %ld %d\n",
+            (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6,
+            usage.ru_maxrss, status);
+    fclose(out);
+    return 0;
+}
+"""
+
+
+def build_launcher(cc, workdir):
+    source = os.path.join(workdir, "launcher.c")
+    executable = os.path.join(workdir, "launcher")
+    with open(source, "w") as f:
+        f.write(LAUNCHER_SOURCE)
+    subprocess.run([cc, "-O2", "-o", executable, source], check=True)
+    return executable
+
+
+def run_once(launcher, executable):
+    """Run a program and return (wall ms, peak RSS KB, stdout bytes, exit status)."""
+    report = executable + ".usage"
+    result = subprocess.run([launcher, report, executable],
+                            stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+    if result.returncode != 0:
+        raise RuntimeError(f"could not run {executable}")
+    with open(report) as f:
+        wall_ms, max_rss, status = f.read().split()
+    return float(wall_ms), int(max_rss), result.stdout, int(status)
+
+
+def measure(launcher, executable, repeat):
+    walls, rss = [], []
+    output = None
+    for _ in range(repeat):
+        wall_ms, max_rss, stdout, status = run_once(launcher, executable)
+        if status != 0:
+            raise RuntimeError(f"{executable} exited with status {status}")
+        walls.append(wall_ms)
+        rss.append(max_rss)
+        output = stdout
+    return {"wall_ms": round(statistics.median(walls), 3), "max_rss_kb": max(rss)}, output
+
+
+def run_program(name, compiler, orion_flags, launcher, cc, cflags, repeat, workdir):
+    orion_exe = build_orion(compiler, orion_flags, name, workdir)
+    c_exe = build_c(cc, cflags, name, workdir)
+    orion, orion_output = measure(launcher, orion_exe, repeat)
+    c, c_output = measure(launcher, c_exe, repeat)
+    return {
+        "program": name,
+        "orion": orion,
+        "c": c,
+        "time_ratio": round(orion["wall_ms"] / max(c["wall_ms"], 1e-6), 2),
+        "rss_ratio": round(orion["max_rss_kb"] / max(c["max_rss_kb"], 1), 2),
+        "output_match": orion_output == c_output,
+    }
+
+
+def print_report(results):
+    print(f"{'program':<16} {'orion ms':>10} {'C ms':>10} {'time x':>8} "
+          f"{'orion KB':>10} {'C KB':>10} {'rss x':>7}  output")
+    for r in results:
+        print(f"{r['program']:<16} {r['orion']['wall_ms']:>10.2f} {r['c']['wall_ms']:>10.2f} "
+              f"{r['time_ratio']:>8.2f} {r['orion']['max_rss_kb']:>10} {r['c']['max_rss_kb']:>10} "
+              f"{r['rss_ratio']:>7.2f}  {'ok' if r['output_match'] else 'MISMATCH'}")
+    if results:
+        ratios = [r["time_ratio"] for r in results]
+        geomean = 1.0
+        for ratio in ratios:
+            geomean *= max(ratio, 1e-6)
+        geomean **= 1.0 / len(ratios)
+        print(f"{'geomean':<16} {'':>10} {'':>10} {geomean:>8.2f}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Orion vs C end-to-end program benchmarks")
+    parser.add_argument("--compiler", default=os.path.join(COMPILER_DIR, "orion"),
+                        help="compiler binary (default: %(default)s)")
+    parser.add_argument("--runtime", default=os.path.join(COMPILER_DIR, "runtime.o"),
+                        help="runtime object the compiler links against")
+    parser.add_argument("--orion-flags", default="", help="extra compiler options, e.g. --arena")
+    parser.add_argument("--cc", default="gcc", help="C compiler for the reference programs")
+    parser.add_argument("--cflags", default="-O2", help="flags for the reference programs")
+    parser.add_argument("--programs", help="comma-separated subset (default: all in benchmarks/programs)")
+    parser.add_argument("--repeat", type=int, default=5, help="runs per program (median is reported)")
+    parser.add_argument("--json", help="write results to FILE")
+    args = parser.parse_args()
+
+    available = discover_programs()
+    names = available
+    if args.programs:
+        names = [n for n in args.programs.split(",") if n]
+        for name in names:
+            if name not in available:
+                parser.error(f"unknown program '{name}' (have: {', '.join(available)})")
+
+    compiler = os.path.abspath(args.compiler)
+    workdir = tempfile.mkdtemp(prefix="orion-programs-")
+    failed = []
+    results = []
+    try:
+        os.symlink(os.path.abspath(args.runtime), os.path.join(workdir, "runtime.o"))
+        launcher = build_launcher(args.cc, workdir)
+        for name in names:
+            result = run_program(name, compiler, args.orion_flags.split(), launcher, args.cc, args.cflags.split(),
+                                 args.repeat, workdir)
+            results.append(result)
+            if not result["output_match"]:
+                failed.append(name)
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+
+    print_report(results)
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump({"compiler": compiler, "cc": args.cc, "cflags": args.cflags,
+                       "results": results}, f, indent=2)
+            f.write("\n")
+
+    if failed:
+        print("Output differs from the C reference: " + ", ".join(failed), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,338 @@
+#include "compile_cache.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace orion {
+
+namespace {
+
+const char* ENTRY_SUFFIX = ".exe";
+
+// Two independent FNV-1a lanes give a 128-bit key, which keeps accidental
+// collisions out of reach for any realistic cache size
+struct KeyHasher {
+    uint64_t lane1 = 0xcbf29ce484222325ULL;
+    uint64_t lane2 = 0x84222325cbf29ce4ULL;
+
+    void update(const std::string& data) {
+        for (unsigned char c : data) {
+            lane1 = (lane1 ^ c) * 0x100000001b3ULL;
+            lane2 = (lane2 ^ c) * 0x100000001b3ULL;
+            lane2 ^= lane2 >> 29;
+        }
+        // Separator so that ("ab", "c") and ("a", "bc") hash differently
+        std::string len = std::to_string(data.size());
+        for (unsigned char c : len) {
+            lane1 = (lane1 ^ c) * 0x100000001b3ULL;
+        }
+        lane1 = (lane1 ^ 0xff) * 0x100000001b3ULL;
+    }
+
+    std::string hex() const {
+        char buffer[33];
+        snprintf(buffer, sizeof(buffer), "%016llx%016llx",
+                 (unsigned long long)lane1, (unsigned long long)lane2);
+        return buffer;
+    }
+};
+
+bool readFile(const std::string& path, std::string& contents) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) return false;
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    contents = buffer.str();
+    return true;
+}
+
+bool makeDirectories(const std::string& path) {
+    if (path.empty()) return false;
+    std::string partial;
+    std::stringstream ss(path);
+    std::string component;
+    if (path[0] == '/') partial = "/";
+    while (std::getline(ss, component, '/')) {
+        if (component.empty()) continue;
+        partial += component + "/";
+        if (mkdir(partial.c_str(), 0755) != 0 && errno != EEXIST) {
+            return false;
+        }
+    }
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+bool endsWith(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() &&
+           text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Exclusive advisory lock on the cache directory, released on scope exit
+class DirectoryLock {
+    int fd;
+public:
+    explicit DirectoryLock(const std::string& dir) {
+        fd = open((dir + "/.lock").c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd >= 0) flock(fd, LOCK_EX);
+    }
+    ~DirectoryLock() {
+        if (fd >= 0) {
+            flock(fd, LOCK_UN);
+            close(fd);
+        }
+    }
+};
+
+struct CacheEntry {
+    std::string path;
+    uint64_t size;
+    struct timespec lastUse;
+};
+
+std::vector<CacheEntry> listEntries(const std::string& dir) {
+    std::vector<CacheEntry> entries;
+    DIR* handle = opendir(dir.c_str());
+    if (!handle) return entries;
+    while (struct dirent* ent = readdir(handle)) {
+        std::string name = ent->d_name;
+        if (!endsWith(name, ENTRY_SUFFIX) || name[0] == '.') continue;
+        std::string path = dir + "/" + name;
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0) continue;
+        entries.push_back({path, (uint64_t)st.st_size, st.st_mtim});
+    }
+    closedir(handle);
+    return entries;
+}
+
+} // namespace
+
+CompileCache::CompileCache(const std::string& dir, uint64_t maxBytes)
+    : cacheDir(dir), maxBytes(maxBytes), enabled(false) {
+    while (cacheDir.size() > 1 && cacheDir.back() == '/') {
+        cacheDir.pop_back();
+    }
+    if (!cacheDir.empty()) {
+        enabled = makeDirectories(cacheDir);
+    }
+}
+
+std::string CompileCache::computeKey(const std::string& source, const std::string& flags,
+                                     const std::string& runtimeObjectPath) const {
+    KeyHasher hasher;
+    std::string runtimeObject;
+    readFile(runtimeObjectPath, runtimeObject);
+
+    hasher.update(source);
+    hasher.update(flags);
+    hasher.update(runtimeObject);
+    hasher.update(compilerBuildId());
+    return hasher.hex();
+}
+
+std::string CompileCache::compilerBuildId() {
+    static std::string buildId;
+    if (buildId.empty()) {
+        std::string binary;
+        KeyHasher hasher;
+        if (readFile("/proc/self/exe", binary)) {
+            hasher.update(binary);
+        } else {
+            // No procfs: fall back to the compile timestamp of the driver
+            hasher.update(std::string(__DATE__) + " " + __TIME__);
+        }
+        buildId = hasher.hex();
+    }
+    return buildId;
+}
+
+uint64_t CompileCache::parseSize(const std::string& text) {
+    if (text.empty()) return 0;
+    char* end = nullptr;
+    unsigned long long value = strtoull(text.c_str(), &end, 10);
+    if (end == text.c_str()) return 0;
+
+    std::string suffix(end);
+    if (suffix.empty() || suffix == "B") return value;
+    if (suffix == "K" || suffix == "KB") return value * 1024ULL;
+    if (suffix == "M" || suffix == "MB") return value * 1024ULL * 1024;
+    if (suffix == "G" || suffix == "GB") return value * 1024ULL * 1024 * 1024;
+    return 0;
+}
+
+std::string CompileCache::entryPath(const std::string& key) const {
+    return cacheDir + "/" + key + ENTRY_SUFFIX;
+}
+
+std::string CompileCache::statsPath() const {
+    return cacheDir + "/stats.prom";
+}
+
+bool CompileCache::lookup(const std::string& key, std::string& executablePath) {
+    if (!enabled) return false;
+
+    std::string path = entryPath(key);
+    bool hit = access(path.c_str(), X_OK) == 0;
+    if (hit) {
+        // Refresh modification time so eviction treats this entry as most recently used
+        utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+        executablePath = path;
+    }
+    bumpCounters(hit ? 1 : 0, hit ? 0 : 1, 0, 0);
+    return hit;
+}
+
+bool CompileCache::store(const std::string& key, const std::string& executablePath) {
+    if (!enabled) return false;
+
+    if (!copyExecutable(executablePath, entryPath(key))) return false;
+
+    uint64_t evicted = evictToLimit();
+    bumpCounters(0, 0, 1, evicted, maxBytes);
+    return true;
+}
+
+bool CompileCache::copyExecutable(const std::string& from, const std::string& to) {
+    std::string binary;
+    if (!readFile(from, binary)) return false;
+
+    // Write to a private temporary name and rename
+    size_t slash = to.rfind('/');
+    std::string dir = slash == std::string::npos ? "." : to.substr(0, slash);
+    std::string name = slash == std::string::npos ? to : to.substr(slash + 1);
+    std::string tempPath = dir + "/.tmp." + std::to_string(getpid()) + "." + name;
+    {
+        std::ofstream out(tempPath, std::ios::binary);
+        if (!out.is_open()) return false;
+        out << binary;
+        if (!out.good()) {
+            unlink(tempPath.c_str());
+            return false;
+        }
+    }
+    chmod(tempPath.c_str(), 0755);
+    if (rename(tempPath.c_str(), to.c_str()) != 0) {
+        unlink(tempPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+uint64_t CompileCache::evictToLimit() {
+    DirectoryLock lock(cacheDir);
+    std::vector<CacheEntry> entries = listEntries(cacheDir);
+
+    uint64_t total = 0;
+    for (const auto& entry : entries) {
+        total += entry.size;
+    }
+    if (total <= maxBytes) return 0;
+
+    // Oldest use first
+    std::sort(entries.begin(), entries.end(), [](const CacheEntry& a, const CacheEntry& b) {
+        if (a.lastUse.tv_sec != b.lastUse.tv_sec) return a.lastUse.tv_sec < b.lastUse.tv_sec;
+        return a.lastUse.tv_nsec < b.lastUse.tv_nsec;
+    });
+
+    uint64_t evicted = 0;
+    for (const auto& entry : entries) {
+        if (total <= maxBytes) break;
+        if (unlink(entry.path.c_str()) == 0) {
+            total -= entry.size;
+            evicted++;
+        }
+    }
+    return evicted;
+}
+
+CompileCache::Stats CompileCache::readStats() const {
+    Stats stats;
+    if (cacheDir.empty()) return stats;
+
+    std::ifstream in(statsPath());
+    std::string name;
+    unsigned long long value;
+    while (in >> name) {
+        if (name[0] == '#') {
+            std::string rest;
+            std::getline(in, rest);
+            continue;
+        }
+        if (!(in >> value)) break;
+        if (name == "orion_cache_hits_total") stats.hits = value;
+        else if (name == "orion_cache_misses_total") stats.misses = value;
+        else if (name == "orion_cache_stores_total") stats.stores = value;
+        else if (name == "orion_cache_evictions_total") stats.evictions = value;
+        else if (name == "orion_cache_max_bytes") stats.maxBytes = value;
+    }
+
+    for (const auto& entry : listEntries(cacheDir)) {
+        stats.entries++;
+        stats.bytes += entry.size;
+    }
+    return stats;
+}
+
+std::string CompileCache::formatStats() const {
+    Stats stats = readStats();
+    std::ostringstream out;
+    out << "# TYPE orion_cache_hits_total counter\n";
+    out << "orion_cache_hits_total " << stats.hits << "\n";
+    out << "# TYPE orion_cache_misses_total counter\n";
+    out << "orion_cache_misses_total " << stats.misses << "\n";
+    out << "# TYPE orion_cache_stores_total counter\n";
+    out << "orion_cache_stores_total " << stats.stores << "\n";
+    out << "# TYPE orion_cache_evictions_total counter\n";
+    out << "orion_cache_evictions_total " << stats.evictions << "\n";
+    out << "# TYPE orion_cache_entries gauge\n";
+    out << "orion_cache_entries " << stats.entries << "\n";
+    out << "# TYPE orion_cache_bytes gauge\n";
+    out << "orion_cache_bytes " << stats.bytes << "\n";
+    // The bound from the last store, not this invocation's --cache-max-size
+    if (stats.maxBytes != 0) {
+        out << "# TYPE orion_cache_max_bytes gauge\n";
+        out << "orion_cache_max_bytes " << stats.maxBytes << "\n";
+    }
+    return out.str();
+}
+
+void CompileCache::bumpCounters(uint64_t hits, uint64_t misses, uint64_t stores, uint64_t evictions,
+                                uint64_t prunedWith) {
+    DirectoryLock lock(cacheDir);
+    Stats stats = readStats();
+    stats.hits += hits;
+    stats.misses += misses;
+    stats.stores += stores;
+    stats.evictions += evictions;
+    if (prunedWith != 0) {
+        stats.maxBytes = prunedWith;
+    }
+
+    // The monotonic counters and the last pruning bound are persisted;
+    // the entry and byte gauges are derived on read
+    std::string tempPath = statsPath() + ".tmp." + std::to_string(getpid());
+    {
+        std::ofstream out(tempPath);
+        if (!out.is_open()) return;
+        out << "orion_cache_hits_total " << stats.hits << "\n";
+        out << "orion_cache_misses_total " << stats.misses << "\n";
+        out << "orion_cache_stores_total " << stats.stores << "\n";
+        out << "orion_cache_evictions_total " << stats.evictions << "\n";
+        if (stats.maxBytes != 0) {
+            out << "orion_cache_max_bytes " << stats.maxBytes << "\n";
+        }
+    }
+    rename(tempPath.c_str(), statsPath().c_str());
+}
+
+} // namespace orion
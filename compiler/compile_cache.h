@@ -0,0 +1,72 @@
+#ifndef COMPILE_CACHE_H
+#define COMPILE_CACHE_H
+
+#include <string>
+#include <cstdint>
+
+namespace orion {
+
+// Content-addressed cache of linked executables.
+// Entries are keyed by a hash of everything that can change the produced
+// binary: source text, codegen/link flags, runtime.o and the compiler itself.
+// Least-recently-used entries are evicted once the cache exceeds its size bound.
+class CompileCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t stores = 0;
+        uint64_t evictions = 0;
+        uint64_t entries = 0;
+        uint64_t bytes = 0;
+        uint64_t maxBytes = 0;  // Size bound the cache was last pruned with (0: never pruned)
+    };
+
+    static const uint64_t DEFAULT_MAX_BYTES = 256ULL * 1024 * 1024;
+
+    CompileCache(const std::string& dir, uint64_t maxBytes = DEFAULT_MAX_BYTES);
+
+    bool isEnabled() const { return enabled; }
+    const std::string& directory() const { return cacheDir; }
+
+    // Build the cache key for a compilation
+    std::string computeKey(const std::string& source, const std::string& flags,
+                           const std::string& runtimeObjectPath) const;
+
+    // Look up an executable; records a hit or miss and refreshes LRU order on hit
+    bool lookup(const std::string& key, std::string& executablePath);
+
+    // Copy a freshly linked executable into the cache, then enforce the size bound
+    bool store(const std::string& key, const std::string& executablePath);
+
+    Stats readStats() const;
+
+    // Counters in Prometheus text exposition format
+    std::string formatStats() const;
+
+    // Copy an executable through a temporary file next to the destination,
+    // so concurrent readers never observe a partial copy
+    static bool copyExecutable(const std::string& from, const std::string& to);
+
+    // Identifies the running compiler binary (hash of /proc/self/exe)
+    static std::string compilerBuildId();
+
+    // Parse sizes such as "512K", "64M" or "1G"; returns 0 on malformed input
+    static uint64_t parseSize(const std::string& text);
+
+private:
+    std::string cacheDir;
+    uint64_t maxBytes;
+    bool enabled;
+
+    std::string entryPath(const std::string& key) const;
+    std::string statsPath() const;
+
+    void bumpCounters(uint64_t hits, uint64_t misses, uint64_t stores, uint64_t evictions,
+                      uint64_t prunedWith = 0);
+    uint64_t evictToLimit();
+};
+
+} // namespace orion
+
+#endif // COMPILE_CACHE_H
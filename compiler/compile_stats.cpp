@@ -0,0 +1,321 @@
+#include "compile_stats.h"
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace orion {
+
+namespace {
+
+double nowMs() {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+double cpuMs(const struct rusage& usage) {
+    return usage.ru_utime.tv_sec * 1000.0 + usage.ru_utime.tv_usec / 1000.0 +
+           usage.ru_stime.tv_sec * 1000.0 + usage.ru_stime.tv_usec / 1000.0;
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string result;
+    for (char c : text) {
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    result += buffer;
+                } else {
+                    result += c;
+                }
+        }
+    }
+    return result;
+}
+
+// Counts every node reachable from the root
+class NodeCounter : public ASTVisitor {
+public:
+    long count = 0;
+
+    void visitAll(std::vector<std::unique_ptr<Expression>>& nodes) {
+        for (auto& node : nodes) {
+            if (node) node->accept(*this);
+        }
+    }
+    void visitAll(std::vector<std::unique_ptr<Statement>>& nodes) {
+        for (auto& node : nodes) {
+            if (node) node->accept(*this);
+        }
+    }
+
+    void visit(IntLiteral&) override { count++; }
+    void visit(FloatLiteral&) override { count++; }
+    void visit(StringLiteral&) override { count++; }
+    void visit(InterpolatedString& node) override {
+        count++;
+        for (auto& part : node.parts) {
+            if (part.isExpression && part.expression) part.expression->accept(*this);
+        }
+    }
+    void visit(BoolLiteral&) override { count++; }
+    void visit(Identifier&) override { count++; }
+    void visit(BinaryExpression& node) override {
+        count++;
+        node.left->accept(*this);
+        node.right->accept(*this);
+    }
+    void visit(UnaryExpression& node) override {
+        count++;
+        node.operand->accept(*this);
+    }
+    void visit(FunctionCall& node) override {
+        count++;
+        visitAll(node.arguments);
+    }
+    void visit(TupleExpression& node) override {
+        count++;
+        visitAll(node.elements);
+    }
+    void visit(ListLiteral& node) override {
+        count++;
+        visitAll(node.elements);
+    }
+    void visit(DictLiteral& node) override {
+        count++;
+        visitAll(node.keys);
+        visitAll(node.values);
+    }
+    void visit(IndexExpression& node) override {
+        count++;
+        node.object->accept(*this);
+        node.index->accept(*this);
+    }
+    void visit(VariableDeclaration& node) override {
+        count++;
+        if (node.initializer) node.initializer->accept(*this);
+    }
+    void visit(FunctionDeclaration& node) override {
+        count++;
+        if (node.isSingleExpression && node.expression) {
+            node.expression->accept(*this);
+        } else {
+            visitAll(node.body);
+        }
+    }
+    void visit(BlockStatement& node) override {
+        count++;
+        visitAll(node.statements);
+    }
+    void visit(ExpressionStatement& node) override {
+        count++;
+        node.expression->accept(*this);
+    }
+    void visit(TupleAssignment& node) override {
+        count++;
+        visitAll(node.targets);
+        visitAll(node.values);
+    }
+    void visit(ChainAssignment& node) override {
+        count++;
+        node.value->accept(*this);
+    }
+    void visit(IndexAssignment& node) override {
+        count++;
+        node.object->accept(*this);
+        node.index->accept(*this);
+        node.value->accept(*this);
+    }
+    void visit(GlobalStatement&) override { count++; }
+    void visit(LocalStatement&) override { count++; }
+    void visit(ReturnStatement& node) override {
+        count++;
+        if (node.value) node.value->accept(*this);
+    }
+    void visit(IfStatement& node) override {
+        count++;
+        node.condition->accept(*this);
+        node.thenBranch->accept(*this);
+        if (node.elseBranch) node.elseBranch->accept(*this);
+    }
+    void visit(WhileStatement& node) override {
+        count++;
+        node.condition->accept(*this);
+        node.body->accept(*this);
+    }
+    void visit(ForInStatement& node) override {
+        count++;
+        node.iterable->accept(*this);
+        node.body->accept(*this);
+    }
+    void visit(BreakStatement&) override { count++; }
+    void visit(ContinueStatement&) override { count++; }
+    void visit(PassStatement&) override { count++; }
+    void visit(StructDeclaration&) override { count++; }
+    void visit(EnumDeclaration&) override { count++; }
+    void visit(Program& node) override {
+        count++;
+        visitAll(node.statements);
+    }
+};
+
+} // namespace
+
+void PassTimer::begin(const std::string& name) {
+    currentName = name;
+    getrusage(RUSAGE_SELF, &startUsage);
+    startWall = nowMs();
+}
+
+void PassTimer::end(long count, const std::string& countUnit) {
+    double endWall = nowMs();
+    struct rusage endUsage;
+    getrusage(RUSAGE_SELF, &endUsage);
+
+    PhaseRecord record;
+    record.name = currentName;
+    record.wallMs = endWall - startWall;
+    record.cpuMs = cpuMs(endUsage) - cpuMs(startUsage);
+    record.rssDeltaKb = endUsage.ru_maxrss - startUsage.ru_maxrss;
+    record.count = count;
+    record.countUnit = countUnit;
+    records.push_back(record);
+}
+
+void PassTimer::setCount(const std::string& name, long count, const std::string& countUnit) {
+    for (auto& record : records) {
+        if (record.name == name) {
+            record.count = count;
+            record.countUnit = countUnit;
+        }
+    }
+}
+
+int PassTimer::runCommand(const std::string& name, const std::string& command) {
+    double start = nowMs();
+    pid_t pid = fork();
+    if (pid < 0) {
+        return -1;
+    }
+    if (pid == 0) {
+        execl("/bin/sh", "sh", "-c", command.c_str(), (char*)nullptr);
+        _exit(127);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0) {
+        return -1;
+    }
+
+    PhaseRecord record;
+    record.name = name;
+    record.wallMs = nowMs() - start;
+    record.cpuMs = cpuMs(usage);
+    record.rssDeltaKb = usage.ru_maxrss;
+    record.external = true;
+    records.push_back(record);
+    return status;
+}
+
+std::string PassTimer::formatTable() const {
+    std::ostringstream out;
+    out << "===------------------------------------------------------------------===\n";
+    out << "                    Orion compiler pass execution timing\n";
+    out << "===------------------------------------------------------------------===\n";
+    out << std::left << std::setw(16) << "  Phase"
+        << std::right << std::setw(11) << "Wall (ms)"
+        << std::setw(11) << "CPU (ms)"
+        << std::setw(14) << "RSS +KB"
+        << "   Items\n";
+
+    double totalWall = 0;
+    double totalCpu = 0;
+    out << std::fixed << std::setprecision(3);
+    for (const auto& record : records) {
+        totalWall += record.wallMs;
+        totalCpu += record.cpuMs;
+        out << "  " << std::left << std::setw(14) << record.name
+            << std::right << std::setw(11) << record.wallMs
+            << std::setw(11) << record.cpuMs
+            << std::setw(14) << record.rssDeltaKb;
+        if (record.count >= 0) {
+            out << "   " << record.count << " " << record.countUnit;
+        } else if (record.external) {
+            out << "   (child process peak RSS)";
+        }
+        out << "\n";
+    }
+    out << "  " << std::left << std::setw(14) << "total"
+        << std::right << std::setw(11) << totalWall
+        << std::setw(11) << totalCpu << "\n";
+    return out.str();
+}
+
+std::string PassTimer::formatJson(const std::string& sourceFile, size_t sourceBytes, size_t sourceLines) const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    out << "  \"source\": \"" << jsonEscape(sourceFile) << "\",\n";
+    out << "  \"source_bytes\": " << sourceBytes << ",\n";
+    out << "  \"source_lines\": " << sourceLines << ",\n";
+    out << "  \"phases\": [\n";
+
+    double totalWall = 0;
+    double totalCpu = 0;
+    for (size_t i = 0; i < records.size(); i++) {
+        const auto& record = records[i];
+        totalWall += record.wallMs;
+        totalCpu += record.cpuMs;
+        out << "    {\"name\": \"" << jsonEscape(record.name) << "\""
+            << ", \"wall_ms\": " << record.wallMs
+            << ", \"cpu_ms\": " << record.cpuMs
+            << ", \"rss_delta_kb\": " << record.rssDeltaKb
+            << ", \"external\": " << (record.external ? "true" : "false");
+        if (record.count >= 0) {
+            out << ", \"count\": " << record.count
+                << ", \"count_unit\": \"" << jsonEscape(record.countUnit) << "\"";
+        }
+        out << "}" << (i + 1 < records.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"total_wall_ms\": " << totalWall << ",\n";
+    out << "  \"total_cpu_ms\": " << totalCpu << "\n";
+    out << "}\n";
+    return out.str();
+}
+
+long countASTNodes(ASTNode& root) {
+    NodeCounter counter;
+    root.accept(counter);
+    return counter.count;
+}
+
+long countInstructions(const std::string& assembly) {
+    long count = 0;
+    size_t pos = 0;
+    while (pos < assembly.size()) {
+        size_t lineEnd = assembly.find('\n', pos);
+        if (lineEnd == std::string::npos) lineEnd = assembly.size();
+
+        // Instructions are indented; labels start in column 0
+        if (pos < lineEnd && (assembly[pos] == ' ' || assembly[pos] == '\t')) {
+            size_t first = assembly.find_first_not_of(" \t", pos);
+            if (first < lineEnd && assembly[first] != '#' && assembly[first] != '.') {
+                count++;
+            }
+        }
+        pos = lineEnd + 1;
+    }
+    return count;
+}
+
+} // namespace orion
@@ -0,0 +1,57 @@
+#ifndef COMPILE_STATS_H
+#define COMPILE_STATS_H
+
+#include "ast.h"
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+namespace orion {
+
+// Per-phase wall time, CPU time and memory accounting for the compiler driver.
+// In-process phases (lex, parse, codegen) are bracketed with begin()/end();
+// external phases (assembler/linker, the compiled program) run through
+// runCommand(), which reads the exact resource usage of the child process.
+class PassTimer {
+public:
+    struct PhaseRecord {
+        std::string name;
+        double wallMs = 0;
+        double cpuMs = 0;
+        long rssDeltaKb = 0;     // Growth of peak RSS (child phases: peak RSS of the child)
+        long count = -1;         // Items produced by the phase, -1 if not applicable
+        std::string countUnit;
+        bool external = false;
+    };
+
+    void begin(const std::string& name);
+    void end(long count = -1, const std::string& countUnit = "");
+
+    // Attach an item count to an already recorded phase
+    void setCount(const std::string& name, long count, const std::string& countUnit);
+
+    // Run a shell command as a timed phase; returns the wait status like system()
+    int runCommand(const std::string& name, const std::string& command);
+
+    const std::vector<PhaseRecord>& phases() const { return records; }
+
+    std::string formatTable() const;
+    std::string formatJson(const std::string& sourceFile, size_t sourceBytes, size_t sourceLines) const;
+
+private:
+    std::vector<PhaseRecord> records;
+    std::string currentName;
+    double startWall = 0;
+    struct rusage startUsage;
+};
+
+// Number of nodes in an AST, counted with a visitor
+long countASTNodes(ASTNode& root);
+
+// Number of machine instructions in generated assembly (directives, labels
+// and comment-only lines are not counted)
+long countInstructions(const std::string& assembly);
+
+} // namespace orion
+
+#endif // COMPILE_STATS_H
@@ -0,0 +1,302 @@
+#include "escape_analysis.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace orion {
+
+namespace {
+
+// How the parent of an expression uses its value
+enum class Use {
+    ESCAPE,  // May be kept after the expression: returned, stored, passed on
+    READ,    // Consumed on the spot
+    MUTATE,  // Changed in place: append(), pop(), index assignment
+    BIND     // Initializer of a variable declaration
+};
+
+// Variables and allocation sites of one function body (or of the top level)
+struct Scope {
+    std::unordered_map<std::string, int> assignments;
+    std::unordered_map<std::string, const Expression*> bound;  // Variable -> site it is declared with
+    std::unordered_set<std::string> escaped;
+    std::unordered_set<std::string> mentioned;
+    std::vector<const Expression*> consumed;  // Sites used up where they are created
+    std::unordered_map<std::string, const Identifier*> lastMention;  // Null when it is inside a loop or not a read
+    std::unordered_map<std::string, std::vector<const VariableDeclaration*>> declarations;
+    std::unordered_map<std::string, std::string> heldType;  // Type of every declared value, empty once they differ
+    std::unordered_set<std::string> rebound;  // Also bound by a loop, the caller or a tuple assignment
+};
+
+// Longer list literals stay on the heap to bound the size of stack frames
+const size_t MAX_FRAME_LIST_ELEMENTS = 256;
+
+// Type of the value a declaration binds, empty when the type checker left it open
+std::string boundType(const Expression* value) {
+    switch (value->inferredType.kind) {
+        case TypeKind::INT32:
+        case TypeKind::INT64: return "int";
+        case TypeKind::FLOAT32:
+        case TypeKind::FLOAT64: return "float";
+        case TypeKind::BOOL: return "bool";
+        case TypeKind::STRING: return "string";
+        case TypeKind::LIST: return "list";
+        case TypeKind::DICT: return "dict";
+        case TypeKind::RANGE: return "range";
+        default: return "";
+    }
+}
+
+bool isComparison(BinaryOp op) {
+    return op == BinaryOp::EQ || op == BinaryOp::NE || op == BinaryOp::LT ||
+           op == BinaryOp::LE || op == BinaryOp::GT || op == BinaryOp::GE;
+}
+
+// Walks one scope, classifying every use of its variables and allocation
+// sites. Nested function declarations are collected, not entered.
+class ScopeWalker : public ASTVisitor {
+public:
+    ScopeWalker(Scope& scope, std::vector<FunctionDeclaration*>& functions, std::unordered_set<std::string>& globals, long& sites)
+        : scope(scope), functions(functions), globals(globals), sites(sites) {}
+
+    void walk(Expression* expr, Use exprUse) {
+        if (!expr) return;
+        Use saved = use;
+        use = exprUse;
+        expr->accept(*this);
+        use = saved;
+    }
+    void walkAll(std::vector<std::unique_ptr<Statement>>& statements) {
+        for (auto& stmt : statements) {
+            if (stmt) stmt->accept(*this);
+        }
+    }
+
+    void visit(IntLiteral&) override {}
+    void visit(FloatLiteral&) override {}
+    void visit(StringLiteral&) override {}
+    void visit(InterpolatedString& node) override {
+        bool constant = true;
+        for (auto& part : node.parts) {
+            if (part.isExpression) {
+                constant = false;
+                walk(part.expression.get(), Use::READ);  // Formatted into the new string
+            }
+        }
+        if (!constant) allocation(node);
+    }
+    void visit(BoolLiteral&) override {}
+    void visit(Identifier& node) override {
+        scope.mentioned.insert(node.name);
+        scope.lastMention[node.name] = loopDepth == 0 ? &node : nullptr;
+        if (use == Use::ESCAPE || use == Use::BIND) {
+            scope.escaped.insert(node.name);
+        }
+    }
+    void visit(BinaryExpression& node) override {
+        // Comparisons only look at their operands; list + and * build a new list
+        bool listOp = (node.op == BinaryOp::ADD || node.op == BinaryOp::MUL);
+        walk(node.left.get(), isComparison(node.op) || (listOp && node.left->inferredType.kind == TypeKind::LIST) ? Use::READ : Use::ESCAPE);
+        walk(node.right.get(), isComparison(node.op) || (listOp && node.right->inferredType.kind == TypeKind::LIST) ? Use::READ : Use::ESCAPE);
+    }
+    void visit(UnaryExpression& node) override {
+        walk(node.operand.get(), Use::ESCAPE);
+    }
+    void visit(FunctionCall& node) override {
+        // Builtins that only inspect or convert their arguments
+        static const std::unordered_set<std::string> readers = {"len", "out", "dtype", "int", "flt", "input", "keys", "values", "items"};
+        if (node.name == "range") {
+            allocation(node);
+        }
+        for (size_t i = 0; i < node.arguments.size(); i++) {
+            Use argUse = Use::ESCAPE;
+            if (readers.count(node.name)) {
+                argUse = Use::READ;
+            } else if ((node.name == "append" || node.name == "pop") && i == 0) {
+                argUse = Use::MUTATE;
+            }
+            walk(node.arguments[i].get(), argUse);
+        }
+    }
+    void visit(TupleExpression& node) override {
+        for (auto& element : node.elements) walk(element.get(), Use::ESCAPE);
+    }
+    void visit(ListLiteral& node) override {
+        if (node.elements.size() <= MAX_FRAME_LIST_ELEMENTS) {
+            allocation(node);
+        } else {
+            sites++;
+        }
+        for (auto& element : node.elements) walk(element.get(), Use::ESCAPE);
+    }
+    void visit(DictLiteral& node) override {
+        for (auto& key : node.keys) walk(key.get(), Use::ESCAPE);
+        for (auto& value : node.values) walk(value.get(), Use::ESCAPE);
+    }
+    void visit(IndexExpression& node) override {
+        walk(node.object.get(), Use::READ);
+        walk(node.index.get(), Use::ESCAPE);
+    }
+    void visit(VariableDeclaration& node) override {
+        scope.assignments[node.name]++;
+        std::string type = node.initializer ? boundType(node.initializer.get()) : "";
+        auto held = scope.heldType.emplace(node.name, type).first;
+        if (held->second != type) held->second.clear();
+        scope.declarations[node.name].push_back(&node);
+        binding = node.name;
+        walk(node.initializer.get(), Use::BIND);
+    }
+    void visit(FunctionDeclaration& node) override {
+        functions.push_back(&node);
+    }
+    void visit(BlockStatement& node) override {
+        walkAll(node.statements);
+    }
+    void visit(ExpressionStatement& node) override {
+        walk(node.expression.get(), Use::READ);
+    }
+    void visit(TupleAssignment& node) override {
+        for (auto& target : node.targets) {
+            if (auto id = dynamic_cast<Identifier*>(target.get())) scope.rebound.insert(id->name);
+            walk(target.get(), Use::ESCAPE);
+        }
+        for (auto& value : node.values) walk(value.get(), Use::ESCAPE);
+    }
+    void visit(ChainAssignment& node) override {
+        for (auto& name : node.variables) {
+            scope.escaped.insert(name);
+            scope.rebound.insert(name);
+            scope.mentioned.insert(name);
+            scope.lastMention[name] = nullptr;
+        }
+        walk(node.value.get(), Use::ESCAPE);
+    }
+    void visit(IndexAssignment& node) override {
+        walk(node.object.get(), Use::MUTATE);
+        walk(node.index.get(), Use::ESCAPE);
+        walk(node.value.get(), Use::ESCAPE);
+    }
+    void visit(GlobalStatement& node) override {
+        globals.insert(node.variables.begin(), node.variables.end());
+    }
+    void visit(LocalStatement&) override {}
+    void visit(ReturnStatement& node) override {
+        walk(node.value.get(), Use::ESCAPE);
+    }
+    void visit(IfStatement& node) override {
+        walk(node.condition.get(), Use::READ);
+        node.thenBranch->accept(*this);
+        if (node.elseBranch) node.elseBranch->accept(*this);
+    }
+    void visit(WhileStatement& node) override {
+        loopDepth++;
+        walk(node.condition.get(), Use::READ);
+        node.body->accept(*this);
+        loopDepth--;
+    }
+    void visit(ForInStatement& node) override {
+        loopDepth++;
+        scope.escaped.insert(node.variable);  // Assigned by the loop itself
+        scope.rebound.insert(node.variable);
+        scope.mentioned.insert(node.variable);
+        scope.lastMention[node.variable] = nullptr;
+        if (!node.valueVariable.empty()) {
+            scope.escaped.insert(node.valueVariable);
+            scope.rebound.insert(node.valueVariable);
+            scope.mentioned.insert(node.valueVariable);
+            scope.lastMention[node.valueVariable] = nullptr;
+        }
+        walk(node.iterable.get(), Use::READ);
+        node.body->accept(*this);
+        loopDepth--;
+    }
+    void visit(BreakStatement&) override {}
+    void visit(ContinueStatement&) override {}
+    void visit(PassStatement&) override {}
+    void visit(StructDeclaration&) override {}
+    void visit(EnumDeclaration&) override {}
+    void visit(Program& node) override {
+        walkAll(node.statements);
+    }
+
+private:
+    Scope& scope;
+    std::vector<FunctionDeclaration*>& functions;
+    std::unordered_set<std::string>& globals;
+    long& sites;
+    Use use = Use::READ;
+    int loopDepth = 0;
+    std::string binding;  // Variable being declared while walking a Use::BIND initializer
+
+    void allocation(Expression& site) {
+        sites++;
+        if (use == Use::READ) {
+            scope.consumed.push_back(&site);
+        } else if (use == Use::BIND) {
+            scope.bound[binding] = &site;
+        }
+    }
+};
+
+} // namespace
+
+void EscapeAnalysis::analyze(Program& program) {
+    frameSites.clear();
+    lastUses.clear();
+    oneTypeDeclarations.clear();
+    sites = 0;
+    std::unordered_set<std::string> globals;
+    std::vector<FunctionDeclaration*> functions;
+
+    Scope topLevel;
+    ScopeWalker(topLevel, functions, globals, sites).visit(program);
+
+    // Function bodies, including nested ones; parameters are assigned by the caller
+    std::vector<Scope> bodies;
+    for (size_t i = 0; i < functions.size(); i++) {
+        FunctionDeclaration* func = functions[i];
+        bodies.emplace_back();
+        Scope& scope = bodies.back();
+        for (const auto& param : func->parameters) {
+            scope.escaped.insert(param.name);
+            scope.rebound.insert(param.name);
+        }
+        ScopeWalker walker(scope, functions, globals, sites);
+        if (func->isSingleExpression) {
+            walker.walk(func->expression.get(), Use::ESCAPE);
+        } else {
+            walker.walkAll(func->body);
+        }
+    }
+
+    // Top-level variables are globals: any function naming one may see it,
+    // so it neither stays in the frame nor has a last use at the top level
+    for (const Scope& scope : bodies) {
+        topLevel.escaped.insert(scope.mentioned.begin(), scope.mentioned.end());
+        for (const auto& name : scope.mentioned) topLevel.lastMention.erase(name);
+    }
+    bodies.push_back(std::move(topLevel));
+
+    for (const Scope& scope : bodies) {
+        frameSites.insert(scope.consumed.begin(), scope.consumed.end());
+        for (const auto& entry : scope.lastMention) {
+            if (entry.second && !globals.count(entry.first)) {
+                lastUses.insert(entry.second);
+            }
+        }
+        for (const auto& entry : scope.bound) {
+            const std::string& name = entry.first;
+            if (scope.assignments.at(name) == 1 && !scope.escaped.count(name) && !globals.count(name)) {
+                frameSites.insert(entry.second);
+            }
+        }
+        for (const auto& entry : scope.declarations) {
+            const std::string& name = entry.first;
+            if (!scope.heldType.at(name).empty() && !scope.rebound.count(name) && !globals.count(name)) {
+                oneTypeDeclarations.insert(entry.second.begin(), entry.second.end());
+            }
+        }
+    }
+}
+
+} // namespace orion
@@ -0,0 +1,49 @@
+#ifndef ESCAPE_ANALYSIS_H
+#define ESCAPE_ANALYSIS_H
+
+#include "ast.h"
+#include <unordered_set>
+
+namespace orion {
+
+// Finds the list literals, range() calls and interpolated strings whose value
+// cannot outlive the function that creates it, so codegen can place them in
+// the stack frame instead of the heap and skip their reference counting.
+//
+// A value escapes when it is returned, stored into a container or a global,
+// passed to a user function, or copied into another variable. A value that is
+// consumed where it is created (a for-in iterable, an argument of len() or
+// out(), an operand of a comparison) never escapes. A value bound to a
+// variable does not escape if that is the variable's only assignment in the
+// function and every use of the variable reads or mutates it in place.
+//
+// The same walk finds the last use of each variable: its final mention in the
+// function, outside any loop. Codegen moves a reference out of a variable at
+// its last use instead of retaining it and releasing it at function exit.
+//
+// It also finds the variables that only ever hold one type of value: every
+// assignment is a declaration of the same type, and no loop, parameter or
+// tuple binds the name. Codegen releases such a variable's old value on each
+// assignment, also when a declaration inside a loop runs again.
+class EscapeAnalysis {
+public:
+    void analyze(Program& program);
+
+    bool isFrameAllocated(const Expression* site) const { return frameSites.count(site) > 0; }
+    bool isLastUse(const Identifier* use) const { return lastUses.count(use) > 0; }
+    bool holdsOneType(const VariableDeclaration* decl) const { return oneTypeDeclarations.count(decl) > 0; }
+
+    // Allocation sites seen and how many of them were placed in the frame
+    long allocationSites() const { return sites; }
+    long frameAllocations() const { return static_cast<long>(frameSites.size()); }
+
+private:
+    std::unordered_set<const Expression*> frameSites;
+    std::unordered_set<const Identifier*> lastUses;
+    std::unordered_set<const VariableDeclaration*> oneTypeDeclarations;
+    long sites = 0;
+};
+
+} // namespace orion
+
+#endif // ESCAPE_ANALYSIS_H
@@ -310,74 +310,37 @@ Token Lexer::number(char first, int tokenLine, int tokenColumn) {
     }
 
 Token Lexer::string(char quote, int tokenLine, int tokenColumn) {
-        // First, scan the string to see if it contains interpolation
-        size_t savePos = current;
-        int saveLine = line;
-        int saveColumn = column;
-        bool hasInterpolation = false;
+        // Escapes are decoded here for plain and interpolated strings alike;
+        // the parser splits the ${...} parts out of the decoded text, so the
+        // code generator sees every string as its final bytes
+        std::string value;
         
         while (!isAtEnd() && peek() != quote) {
-            if (peek() == '$' && peekNext() == '{') {
-                hasInterpolation = true;
-                break;
-            }
-            if (peek() == '\\') {
-                advance(); // skip escape
-                if (!isAtEnd()) advance(); // skip escaped char
+            char c = peek();
+            if (c == '\\') {
+                advance(); // skip '\'
+                if (!isAtEnd()) {
+                    char escaped = advance();
+                    switch (escaped) {
+                        case 'n': value += '\n'; break;
+                        case 't': value += '\t'; break;
+                        case 'r': value += '\r'; break;
+                        case '\\': value += '\\'; break;
+                        case '"': value += '"'; break;
+                        case '\'': value += '\''; break;
+                        default: value += escaped; break;
+                    }
+                }
             } else {
-                advance();
+                value += advance();
             }
         }
         
-        // Reset position
-        current = savePos;
-        line = saveLine;
-        column = saveColumn;
-        
-        // If no interpolation, handle as regular string
-        if (!hasInterpolation) {
-            std::string value;
-            
-            while (!isAtEnd() && peek() != quote) {
-                char c = peek();
-                if (c == '\\') {
-                    advance(); // skip '\'
-                    if (!isAtEnd()) {
-                        char escaped = advance();
-                        switch (escaped) {
-                            case 'n': value += '\n'; break;
-                            case 't': value += '\t'; break;
-                            case 'r': value += '\r'; break;
-                            case '\\': value += '\\'; break;
-                            case '"': value += '"'; break;
-                            case '\'': value += '\''; break;
-                            default: value += escaped; break;
-                        }
-                    }
-                } else {
-                    value += advance();
-                }
-            }
-            
-            if (!isAtEnd()) {
-                advance(); // consume closing quote
-            }
-            
-            return Token(TokenType::STRING, value, tokenLine, tokenColumn);
-        } else {
-            // This is an interpolated string, but we need to handle it differently
-            // For now, return a special token and handle interpolation in the parser
-            std::string fullString;
-            while (!isAtEnd() && peek() != quote) {
-                fullString += advance();
-            }
-            if (!isAtEnd()) {
-                advance(); // consume closing quote
-            }
-            
-            // Return the full string with a special marker for interpolation
-            return Token(TokenType::STRING, fullString, tokenLine, tokenColumn);
+        if (!isAtEnd()) {
+            advance(); // consume closing quote
         }
+        
+        return Token(TokenType::STRING, value, tokenLine, tokenColumn);
     }
 
 Token Lexer::identifier(char first, int tokenLine, int tokenColumn) {
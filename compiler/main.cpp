@@ -2,6 +2,10 @@
 #include "lexer.h"
 #include "simple_parser.h"
 #include "types.cpp"
+#include "compile_cache.h"
+#include "compile_stats.h"
+#include "profile_data.h"
+#include "escape_analysis.h"
 #include <iostream>
 #include <fstream>
 #include <string>
@@ -10,10 +14,12 @@
 #include <cstdlib>
 #include <cstring>
 #include <sstream>
+#include <iomanip>
 #include <sys/wait.h>
 #include <unistd.h>
 #include <unordered_set>
 #include <stack>
+#include <algorithm>
 
 namespace orion {
 
@@ -30,6 +36,8 @@ private:
         std::string type;
         bool isGlobal;
         bool isConstant;
+        bool inFrame = false;     // Holds an object escape analysis placed in the stack frame
+        bool mixedTypes = false;  // May hold values of other types too, so it is never released
     };
     std::unordered_map<std::string, VariableInfo> globalVariables; // Global scope variables
     std::unordered_map<std::string, VariableInfo> localVariables; // Current function scope variables
@@ -45,14 +53,48 @@ private:
     
     std::unordered_map<std::string, FunctionScope> functionScopes; // Scope name -> functions in that scope
     std::vector<std::string> functionCallStack; // Track current function execution stack
-    std::unordered_map<std::string, std::string> functionReturnTypes; // Function name -> return type
+    std::unordered_map<std::string, std::string> functionReturnTypes; // Function label -> return type
+    TypeChecker* typeChecker = nullptr;    // Owns the annotations and the monomorphized copies of functions
+    const EscapeAnalysis* escapeAnalysis = nullptr;  // Allocation sites that live in the stack frame
+    
+    // Byte ranges [low, high] (as %rbp offsets) of the objects placed in the
+    // current frame; they are initialized when created, not zeroed on entry
+    std::vector<std::pair<int, int>> frameObjects;
     
     int stackOffset = 0;
     bool inFunction = false;
     std::string currentFunctionName = "";  // Track current function being generated
+    std::string currentReturnLabel = "";   // Epilogue label of the function being generated
+    bool profiling = false;                // --profile: instrument function entry and exit
+    bool arena = false;                    // --arena: objects live until exit or arena_reset(), no reference counting
+    std::string sourcePath;                // Recorded in .file for the DWARF line table
+    
+    // Profile-guided optimization: --profile-generate counts branches, loops and
+    // call sites; --profile-use feeds the counts back into layout and inlining
+    bool pgoGenerate = false;
+    std::string pgoOutputPath;
+    std::vector<std::string> pgoCounterNames;  // Counter index -> profile key
+    const ProfileData* pgoProfile = nullptr;
+    std::ostringstream coldAsm;                // Cold blocks of the current function, placed after its ret
+    std::unordered_set<std::string> inliningFunctions;  // Guards against recursive inlining
+    // Reference counting emitted for one function, reported by --refcount-report
+    struct RefCountStats {
+        long retains = 0;   // <type>_retain calls
+        long releases = 0;  // <type>_release calls
+        long owned = 0;     // Fresh objects stored or returned without a retain
+        long moves = 0;     // References moved out of a variable on return or at its last use
+        long borrowed = 0;  // Container parameters used without a retain/release pair
+    };
+    RefCountStats refCounts;  // Function being generated
+    // Every emitted function in text order; index 0 is the top-level program (C main).
+    // Indices double as profiler ids and order the runtime symbol table.
+    struct EmittedFunction {
+        std::string name;
+        std::string label;
+        RefCountStats refCounts = {};
+    };
+    std::vector<EmittedFunction> emittedFunctions;
     int labelCounter = 0;
-    bool lastExprWasNewHeapObject = false;  // Track if last expression created a new heap object
-    std::string lastExprType = "";  // Track the type of the last expression
     
     // For managing nested loops and break/continue statements
     std::stack<std::string> breakLabels;
@@ -62,27 +104,95 @@ private:
         return prefix + std::to_string(labelCounter++);
     }
     
+    // Heap objects whose lifetime is managed with <type>_retain/<type>_release.
+    // String literals and frame strings carry a refcount both of them ignore.
+    static bool isRefCountedType(const std::string& type) {
+        return type == "list" || type == "range" || type == "dict" || type == "string";
+    }
+    
+    // Expressions that evaluate to a reference nobody else holds: the object was
+    // just created, or a function handed its reference over on return. Storing
+    // one takes that reference over instead of retaining another.
+    bool producesOwnedReference(Expression* expr) {
+        if (dynamic_cast<ListLiteral*>(expr) || dynamic_cast<DictLiteral*>(expr)) return true;
+        // Interpolations build a new string; literals are static and need no reference
+        if (dynamic_cast<InterpolatedString*>(expr) || dynamic_cast<StringLiteral*>(expr)) return true;
+        if (auto call = dynamic_cast<FunctionCall*>(expr)) {
+            if (call->name == "range" || call->name == "keys" || call->name == "values" || call->name == "input") return true;
+            if (call->name == "str") {
+                // str() of a string hands its argument back
+                ExprKind kind = call->arguments.empty() ? ExprKind::UNKNOWN : annotatedKind(call->arguments[0].get());
+                return kind == ExprKind::INT || kind == ExprKind::FLOAT || kind == ExprKind::BOOL;
+            }
+            auto returnType = functionReturnTypes.find(returnTypeKey(*call));
+            return returnType != functionReturnTypes.end() && isRefCountedType(returnType->second);
+        }
+        if (auto binary = dynamic_cast<BinaryExpression*>(expr)) {
+            // list + list and list * n build a new list
+            return (binary->op == BinaryOp::ADD || binary->op == BinaryOp::MUL) && annotatedKind(expr) == ExprKind::LIST;
+        }
+        return false;
+    }
+    
+    // A variable whose reference can be handed on instead of retained: a local
+    // being returned, or any variable at the last use escape analysis found.
+    // The caller clears its slot so that cleanup skips it.
+    VariableInfo* movableVariable(Expression* expr, bool returning) {
+        auto id = dynamic_cast<Identifier*>(expr);
+        if (!id) return nullptr;
+        VariableInfo* varInfo = lookupVariable(id->name);
+        if (arena || !varInfo || !isRefCountedType(varInfo->type) || varInfo->inFrame || varInfo->mixedTypes) return nullptr;
+        if (returning) return varInfo->isGlobal ? nullptr : varInfo;
+        return escapeAnalysis && escapeAnalysis->isLastUse(id) ? varInfo : nullptr;
+    }
+    
+    // Containers never release their elements, but the variable a stored value
+    // came from releases its reference; the container gets one of its own.
+    // The value is in %rax and stays there
+    void emitRetainStoredValue(Expression* value) {
+        auto id = dynamic_cast<Identifier*>(value);
+        if (!id || arena) return;
+        std::string type = typeName(id->inferredType);
+        VariableInfo* varInfo = lookupVariable(id->name);
+        if (type.empty() && varInfo) type = varInfo->type;
+        if (!isRefCountedType(type) || (varInfo && varInfo->inFrame)) return;
+        assembly << "    mov %rax, %rdi\n";
+        assembly << "    call " << type << "_retain  # Reference held by the container\n";
+        refCounts.retains++;
+    }
+    
+    void emitMove(const std::string& name, VariableInfo* varInfo) {
+        assembly << "    movq $0, -" << varInfo->stackOffset << "(%rbp)  # Move the reference out of " << name << "\n";
+        refCounts.moves++;
+    }
+    
     // Generate code to release a heap-allocated variable
     void releaseVariable(const std::string& varName, VariableInfo* varInfo, std::ostringstream& output) {
         if (!varInfo) return;
         
-        // Only release heap-allocated types
-        if (varInfo->type == "list" || varInfo->type == "string" || varInfo->type == "range") {
+        // Frame objects are not refcounted; a list only frees the storage it grew into
+        if (varInfo->inFrame) {
+            if (varInfo->type != "list") return;
+            output << "    # Releasing grown storage of frame list: " << varName << "\n";
+            output << "    mov -" << varInfo->stackOffset << "(%rbp), %rdi  # Load " << varName << "\n";
+            output << "    test %rdi, %rdi  # Not created yet\n";
+            std::string skipLabel = newLabel("skip_release");
+            output << "    jz " << skipLabel << "\n";
+            output << "    call list_release_frame\n";
+            output << skipLabel << ":\n";
+            return;
+        }
+        
+        // Only release heap-allocated types; arena objects are never freed one by one
+        if (isRefCountedType(varInfo->type) && !varInfo->mixedTypes && !arena) {
             output << "    # Releasing " << varInfo->type << " variable: " << varName << "\n";
             output << "    mov -" << varInfo->stackOffset << "(%rbp), %rdi  # Load " << varName << "\n";
             output << "    test %rdi, %rdi  # Check if null\n";
             std::string skipLabel = newLabel("skip_release");
             output << "    jz " << skipLabel << "  # Skip if null\n";
-            
-            if (varInfo->type == "list") {
-                output << "    call list_release\n";
-            } else if (varInfo->type == "string") {
-                output << "    call string_release\n";
-            } else if (varInfo->type == "range") {
-                output << "    call range_release\n";
-            }
-            
+            output << "    call " << varInfo->type << "_release\n";
             output << skipLabel << ":\n";
+            refCounts.releases++;
         }
     }
     
@@ -98,7 +208,8 @@ private:
         setVariable(varName, valueRegister, "unknown");
     }
     
-    void setVariable(const std::string& varName, const std::string& valueRegister, const std::string& varType) {
+    // An owned value hands its reference over to the variable instead of being retained
+    void setVariable(const std::string& varName, const std::string& valueRegister, const std::string& varType, bool owned = false) {
         // Look up existing variable
         auto varInfo = lookupVariable(varName);
         
@@ -123,7 +234,7 @@ private:
             }
         } else {
             // If reassigning a heap-allocated variable, release the old value first
-            if (varInfo->type == "list" || varInfo->type == "string" || varInfo->type == "range") {
+            if (isRefCountedType(varInfo->type)) {
                 assembly << "    # Releasing old value before reassignment\n";
                 assembly << "    push " << valueRegister << "  # Save new value\n";
                 releaseVariable(varName, varInfo, assembly);
@@ -137,20 +248,16 @@ private:
         }
         
         // If storing a heap-allocated value, retain it to increment reference count
-        if (varType == "list" || varType == "string" || varType == "range") {
+        if (isRefCountedType(varType) && owned) {
+            assembly << "    # Storing new " << varType << " - no retain needed (refcount=1)\n";
+            refCounts.owned++;
+        } else if (isRefCountedType(varType) && !arena) {
             assembly << "    # Retaining " << varType << " before storing to " << varName << "\n";
             assembly << "    push %rax  # Save if value is in rax\n";
             assembly << "    mov " << valueRegister << ", %rdi\n";
-            
-            if (varType == "list") {
-                assembly << "    call list_retain\n";
-            } else if (varType == "string") {
-                assembly << "    call string_retain\n";
-            } else if (varType == "range") {
-                assembly << "    call range_retain\n";
-            }
-            
+            assembly << "    call " << varType << "_retain\n";
             assembly << "    pop %rax  # Restore rax\n";
+            refCounts.retains++;
         }
         
         // Store value from register to variable's stack slot
@@ -158,68 +265,55 @@ private:
     }
     
     bool isFloatExpression(Expression* expr) {
-        if (auto floatLit = dynamic_cast<FloatLiteral*>(expr)) {
-            return true;
-        }
-        if (auto id = dynamic_cast<Identifier*>(expr)) {
-            auto varInfo = lookupVariable(id->name);
-            return varInfo && varInfo->type == "float";
-        }
-        return false;
+        return annotatedKind(expr) == ExprKind::FLOAT;
     }
     
-    // Expression kind inference for type safety
-    enum class ExprKind { INT, FLOAT, BOOL, STRING, LIST, UNKNOWN };
+    // Expression kinds the code generator dispatches on
+    enum class ExprKind { INT, FLOAT, BOOL, STRING, LIST, DICT, RANGE, UNKNOWN };
     
-    ExprKind inferExprKind(Expression* expr) {
-        if (auto intLit = dynamic_cast<IntLiteral*>(expr)) {
-            return ExprKind::INT;
-        }
-        if (auto floatLit = dynamic_cast<FloatLiteral*>(expr)) {
-            return ExprKind::FLOAT;
-        }
-        if (auto boolLit = dynamic_cast<BoolLiteral*>(expr)) {
-            return ExprKind::BOOL;
-        }
-        if (auto strLit = dynamic_cast<StringLiteral*>(expr)) {
-            return ExprKind::STRING;
-        }
-        if (auto listLit = dynamic_cast<ListLiteral*>(expr)) {
-            return ExprKind::LIST;
+    // Kind resolved by the TypeChecker pass; UNKNOWN where inference gave up
+    static ExprKind annotatedKind(Expression* expr) {
+        return annotatedKindOf(expr->inferredType);
+    }
+    
+    static ExprKind annotatedKindOf(const Type& type) {
+        switch (type.kind) {
+            case TypeKind::INT32:
+            case TypeKind::INT64: return ExprKind::INT;
+            case TypeKind::FLOAT32:
+            case TypeKind::FLOAT64: return ExprKind::FLOAT;
+            case TypeKind::BOOL: return ExprKind::BOOL;
+            case TypeKind::STRING: return ExprKind::STRING;
+            case TypeKind::LIST: return ExprKind::LIST;
+            case TypeKind::DICT: return ExprKind::DICT;
+            case TypeKind::RANGE: return ExprKind::RANGE;
+            default: return ExprKind::UNKNOWN;
         }
-        if (auto id = dynamic_cast<Identifier*>(expr)) {
-            auto var = lookupVariable(id->name);
-            if (var) {
-                if (var->type == "int") return ExprKind::INT;
-                if (var->type == "float") return ExprKind::FLOAT;
-                if (var->type == "bool") return ExprKind::BOOL;
-                if (var->type == "string") return ExprKind::STRING;
-                if (var->type == "list") return ExprKind::LIST;
-            }
+    }
+    
+    // VariableInfo type name for a resolved type, empty when there is none
+    static std::string typeName(const Type& type) {
+        switch (type.kind) {
+            case TypeKind::INT32:
+            case TypeKind::INT64: return "int";
+            case TypeKind::FLOAT32:
+            case TypeKind::FLOAT64: return "float";
+            case TypeKind::BOOL: return "bool";
+            case TypeKind::STRING: return "string";
+            case TypeKind::LIST: return "list";
+            case TypeKind::DICT: return "dict";
+            case TypeKind::RANGE: return "range";
+            default: return "";
         }
-        if (auto binExpr = dynamic_cast<BinaryExpression*>(expr)) {
-            ExprKind leftKind = inferExprKind(binExpr->left.get());
-            ExprKind rightKind = inferExprKind(binExpr->right.get());
-            
-            if (binExpr->op == BinaryOp::ADD) {
-                if (leftKind == ExprKind::LIST && rightKind == ExprKind::LIST) {
-                    return ExprKind::LIST;  // List concatenation
-                }
-            }
-            if (binExpr->op == BinaryOp::MUL) {
-                if ((leftKind == ExprKind::LIST && rightKind == ExprKind::INT) ||
-                    (leftKind == ExprKind::INT && rightKind == ExprKind::LIST)) {
-                    return ExprKind::LIST;  // List repetition
-                }
-            }
-            
-            // Default to numeric operations
-            if (leftKind == ExprKind::FLOAT || rightKind == ExprKind::FLOAT) {
-                return ExprKind::FLOAT;
-            }
-            return ExprKind::INT;
+    }
+    
+    // Label of the string dtype() prints for a VariableInfo type
+    static std::string dtypeLabel(const std::string& type) {
+        if (type == "int" || type == "string" || type == "bool" || type == "float" || type == "list" ||
+            type == "dict" || type == "range") {
+            return "dtype_" + type;
         }
-        return ExprKind::UNKNOWN;
+        return "dtype_unknown";
     }
     
     int addStringLiteral(const std::string& str) {
@@ -233,6 +327,46 @@ private:
     }
     
 public:
+    void setProfiling(bool enabled) { profiling = enabled; }
+    void setArena(bool enabled) { arena = enabled; }
+    void setSourcePath(const std::string& path) { sourcePath = path; }
+    void setProfileGenerate(const std::string& outputPath) {
+        pgoGenerate = true;
+        pgoOutputPath = outputPath;
+    }
+    void setProfileUse(const ProfileData* profile) { pgoProfile = profile; }
+    void setTypeChecker(TypeChecker* checker) { typeChecker = checker; }
+    void setEscapeAnalysis(const EscapeAnalysis* analysis) { escapeAnalysis = analysis; }
+    
+    // --refcount-report: retain/release calls emitted per function of the last
+    // generate(), next to the ones ownership let it leave out
+    std::string formatRefCountReport() const {
+        std::ostringstream out;
+        out << "===------------------------------------------------------------------===\n";
+        out << "                    Orion reference counting report\n";
+        out << "===------------------------------------------------------------------===\n";
+        out << std::left << std::setw(28) << "  Function"
+            << std::right << std::setw(9) << "Retains" << std::setw(10) << "Releases"
+            << std::setw(8) << "Owned" << std::setw(8) << "Moves" << std::setw(10) << "Borrowed" << "\n";
+        RefCountStats total;
+        for (const auto& function : emittedFunctions) {
+            const RefCountStats& counts = function.refCounts;
+            out << "  " << std::left << std::setw(26) << function.name
+                << std::right << std::setw(9) << counts.retains << std::setw(10) << counts.releases
+                << std::setw(8) << counts.owned << std::setw(8) << counts.moves << std::setw(10) << counts.borrowed << "\n";
+            total.retains += counts.retains;
+            total.releases += counts.releases;
+            total.owned += counts.owned;
+            total.moves += counts.moves;
+            total.borrowed += counts.borrowed;
+        }
+        out << "  " << std::left << std::setw(26) << "total"
+            << std::right << std::setw(9) << total.retains << std::setw(10) << total.releases
+            << std::setw(8) << total.owned << std::setw(8) << total.moves << std::setw(10) << total.borrowed << "\n";
+        out << "  Elided: " << total.owned + total.moves + total.borrowed << " retains and " << total.moves + total.borrowed << " releases\n";
+        return out.str();
+    }
+    
     std::string generate(Program& program) {
         assembly.str("");
         assembly.clear();
@@ -245,10 +379,17 @@ public:
         constantVariables.clear();
         inFunction = false;
         stackOffset = 0;
+        frameObjects.clear();
         labelCounter = 0;
+        pgoCounterNames.clear();
+        coldAsm.str("");
+        coldAsm.clear();
+        emittedFunctions.assign(1, EmittedFunction{"<toplevel>", "main"});
+        refCounts = RefCountStats();
         
         // Visit program to collect strings and generate code
         program.accept(*this);
+        emittedFunctions[0].refCounts = refCounts;
         
         // Generate complete assembly
         std::ostringstream fullAssembly;
@@ -258,19 +399,19 @@ public:
         fullAssembly << "format_int: .string \"%d\\n\"\n";
         fullAssembly << "format_str: .string \"%s\"\n";
         fullAssembly << "format_float: .string \"%.2f\\n\"\n";
-        fullAssembly << "dtype_int: .string \"datatype: int\\n\"\n";
-        fullAssembly << "dtype_string: .string \"datatype: string\\n\"\n";
-        fullAssembly << "dtype_bool: .string \"datatype: bool\\n\"\n";
-        fullAssembly << "dtype_float: .string \"datatype: float\\n\"\n";
-        fullAssembly << "dtype_list: .string \"datatype: list\\n\"\n";
-        fullAssembly << "dtype_unknown: .string \"datatype: unknown\\n\"\n";
-        fullAssembly << "str_true: .string \"True\\n\"\n";
-        fullAssembly << "str_false: .string \"False\\n\"\n";
+        for (const char* type : {"int", "string", "bool", "float", "list", "dict", "range", "unknown"}) {
+            emitStringObject(fullAssembly, std::string("dtype_") + type, std::string("datatype: ") + type + "\n");
+        }
+        // Global so the runtime can recognize bool values stored into bool lists
+        fullAssembly << ".globl str_true\n";
+        emitStringObject(fullAssembly, "str_true", "True\n");
+        fullAssembly << ".globl str_false\n";
+        emitStringObject(fullAssembly, "str_false", "False\n");
         fullAssembly << "str_index_error: .string \"Index Error\\n\"\n";
         
         // String literals
         for (size_t i = 0; i < stringLiterals.size(); i++) {
-            fullAssembly << "str_" << i << ": .string \"" << stringLiterals[i] << "\"\n";
+            emitStringObject(fullAssembly, "str_" + std::to_string(i), stringLiterals[i]);
         }
         
         // Add float literals  
@@ -278,8 +419,55 @@ public:
             fullAssembly << "float_" << i << ": .quad " << *reinterpret_cast<uint64_t*>(&floatLiterals[i]) << "\n";
         }
         
+        // Function names, shared by the symbol table and the profiler
+        for (size_t i = 0; i < emittedFunctions.size(); i++) {
+            fullAssembly << "fn_name_" << i << ": .string \"" << emittedFunctions[i].name << "\"\n";
+        }
+        
+        // Address ranges of all functions, used by the sampling profiler
+        // to map return addresses back to Orion functions
+        fullAssembly << ".global __orion_symbol_table\n";
+        fullAssembly << ".global __orion_symbol_count\n";
+        fullAssembly << ".balign 8\n";
+        fullAssembly << "__orion_symbol_table:\n";
+        for (size_t i = 0; i < emittedFunctions.size(); i++) {
+            fullAssembly << "    .quad " << emittedFunctions[i].label << ", .Lorion_end_" << i
+                         << ", fn_name_" << i << "\n";
+        }
+        fullAssembly << "__orion_symbol_count: .quad " << emittedFunctions.size() << "\n";
+        
+        // Profile counters and their keys for --profile-generate
+        if (pgoGenerate) {
+            fullAssembly << ".balign 8\n";
+            fullAssembly << "pgo_counters: .zero " << std::max<size_t>(pgoCounterNames.size(), 1) * 8 << "\n";
+            for (size_t i = 0; i < pgoCounterNames.size(); i++) {
+                fullAssembly << "pgo_name_" << i << ": .string \"" << pgoCounterNames[i] << "\"\n";
+            }
+            fullAssembly << ".balign 8\n";
+            fullAssembly << "pgo_names:";
+            for (size_t i = 0; i < pgoCounterNames.size(); i++) {
+                fullAssembly << (i == 0 ? " .quad " : ", ") << "pgo_name_" << i;
+            }
+            fullAssembly << (pgoCounterNames.empty() ? " .quad 0\n" : "\n");
+            fullAssembly << "pgo_output: .string \"" << escapeAssemblyString(pgoOutputPath) << "\"\n";
+        }
+        
+        // Profiler name table, indexed by the ids passed to __orion_prof_enter
+        if (profiling) {
+            fullAssembly << "prof_names:";
+            for (size_t i = 0; i < emittedFunctions.size(); i++) {
+                fullAssembly << (i == 0 ? " .quad " : ", ") << "fn_name_" << i;
+            }
+            fullAssembly << "\n";
+        }
+        
         // Text section
         fullAssembly << "\n.section .text\n";
+        if (!sourcePath.empty()) {
+            // The assembler turns .file/.loc into .debug_line and .debug_info,
+            // so perf and gdb map addresses back to Orion source lines
+            fullAssembly << ".file 1 \"" << escapeAssemblyString(sourcePath) << "\"\n";
+        }
         fullAssembly << ".global main\n";
         fullAssembly << ".extern printf\n";
         fullAssembly << ".extern orion_malloc\n";
@@ -291,6 +479,7 @@ public:
         // Enhanced list runtime functions
         fullAssembly << ".extern list_new\n";
         fullAssembly << ".extern list_from_data\n";
+        fullAssembly << ".extern list_from_data_kind\n";
         fullAssembly << ".extern list_len\n";
         fullAssembly << ".extern list_get\n";
         fullAssembly << ".extern list_set\n";
@@ -300,12 +489,21 @@ public:
         fullAssembly << ".extern list_concat\n";
         fullAssembly << ".extern list_repeat\n";
         fullAssembly << ".extern list_extend\n";
+        for (const char* suffix : {"_int", "_float", "_bool"}) {
+            fullAssembly << ".extern list_get" << suffix << "\n";
+            fullAssembly << ".extern list_set" << suffix << "\n";
+            fullAssembly << ".extern list_append" << suffix << "\n";
+        }
         fullAssembly << ".extern list_retain\n";
         fullAssembly << ".extern list_release\n";
+        fullAssembly << ".extern list_init_frame\n";
+        fullAssembly << ".extern list_release_frame\n";
         // Dictionary runtime functions
         fullAssembly << ".extern dict_new\n";
+        fullAssembly << ".extern dict_new_str\n";
         fullAssembly << ".extern dict_get\n";
         fullAssembly << ".extern dict_set\n";
+        fullAssembly << ".extern dict_set_str\n";
         fullAssembly << ".extern dict_delete\n";
         fullAssembly << ".extern dict_contains\n";
         fullAssembly << ".extern dict_pop\n";
@@ -317,29 +515,67 @@ public:
         fullAssembly << ".extern dict_update\n";
         fullAssembly << ".extern dict_retain\n";
         fullAssembly << ".extern dict_release\n";
+        fullAssembly << ".extern iter_init\n";
+        fullAssembly << ".extern iter_next\n";
         fullAssembly << ".extern orion_input\n";
         fullAssembly << ".extern orion_input_prompt\n";
         // String conversion and concatenation functions
-        fullAssembly << ".extern int_to_string\n";
-        fullAssembly << ".extern float_to_string\n";
-        fullAssembly << ".extern bool_to_string\n";
         fullAssembly << ".extern string_to_string\n";
-        fullAssembly << ".extern string_concat_parts\n";
+        fullAssembly << ".extern string_builder_reserve\n";
+        fullAssembly << ".extern string_builder_append_str\n";
+        fullAssembly << ".extern string_builder_append_int\n";
+        fullAssembly << ".extern string_builder_append_float\n";
+        fullAssembly << ".extern string_builder_finish\n";
+        fullAssembly << ".extern string_concat_into\n";
+        fullAssembly << ".extern int_to_string_into\n";
+        fullAssembly << ".extern float_to_string_into\n";
         fullAssembly << ".extern string_retain\n";
         fullAssembly << ".extern string_release\n";
-        fullAssembly << ".extern print_smart\n";
-        fullAssembly << ".extern detect_type\n";
+        fullAssembly << ".extern string_equal\n";
+        fullAssembly << ".extern range_print\n";
+        fullAssembly << ".extern orion_type_error\n";
+        fullAssembly << ".extern range_init\n";
         fullAssembly << ".extern range_retain\n";
-        fullAssembly << ".extern range_release\n\n";
+        fullAssembly << ".extern range_release\n";
+        fullAssembly << ".extern orion_arena_reset\n";
+        if (arena) {
+            fullAssembly << ".extern __orion_arena_start\n";
+        }
+        if (pgoGenerate) {
+            fullAssembly << ".extern __orion_pgo_register\n";
+        }
+        if (profiling) {
+            fullAssembly << ".extern __orion_prof_start\n";
+            fullAssembly << ".extern __orion_prof_enter\n";
+            fullAssembly << ".extern __orion_prof_exit\n";
+        }
+        fullAssembly << "\n";
         
         // Emit user-defined functions first
         fullAssembly << funcsAsm.str();
         
         // Main function (C runtime entry point)
+        int frameBytes = frameSize();
+        fullAssembly << ".type main, @function\n";
         fullAssembly << "main:\n";
-        fullAssembly << "    push %rbp\n";
-        fullAssembly << "    mov %rsp, %rbp\n";
-        fullAssembly << "    sub $64, %rsp\n";  // Allocate 64 bytes of stack space for variables
+        emitPrologue(fullAssembly);
+        fullAssembly << "    sub $" << frameBytes << ", %rsp\n";  // Stack space for top-level variables
+        emitZeroSlots(8, frameBytes, fullAssembly);
+        if (arena) {
+            fullAssembly << "    call __orion_arena_start  # Before the first allocation\n";
+        }
+        if (profiling) {
+            fullAssembly << "    mov $prof_names, %rdi\n";
+            fullAssembly << "    mov $" << emittedFunctions.size() << ", %rsi\n";
+            fullAssembly << "    call __orion_prof_start  # Report is written at exit\n";
+        }
+        if (pgoGenerate) {
+            fullAssembly << "    mov $pgo_counters, %rdi\n";
+            fullAssembly << "    mov $pgo_names, %rsi\n";
+            fullAssembly << "    mov $" << pgoCounterNames.size() << ", %rdx\n";
+            fullAssembly << "    mov $pgo_output, %rcx\n";
+            fullAssembly << "    call __orion_pgo_register  # Counts are merged into the profile at exit\n";
+        }
         
         // Program code (top-level statements and calls)
         fullAssembly << assembly.str();
@@ -349,9 +585,10 @@ public:
         
         // Return 0
         fullAssembly << "    mov $0, %rax\n";
-        fullAssembly << "    add $64, %rsp\n";  // Restore stack pointer
-        fullAssembly << "    pop %rbp\n";
-        fullAssembly << "    ret\n";
+        fullAssembly << "    mov %rbp, %rsp\n";  // Restore stack pointer
+        emitEpilogue(fullAssembly, coldAsm.str());
+        fullAssembly << ".Lorion_end_0:\n";
+        fullAssembly << ".size main, .-main\n";
         
         return fullAssembly.str();
     }
@@ -369,45 +606,21 @@ public:
         // Fourth pass: execute only non-function statements and function calls
         for (auto& stmt : node.statements) {
             if (dynamic_cast<FunctionDeclaration*>(stmt.get()) == nullptr) {
-                stmt->accept(*this);
+                emitStatement(*stmt);
             }
         }
         
         // Main function will be called from C main in generate() method
     }
     
+    // Return types come from the type checker's inference over the whole call
+    // graph, by label, so every monomorphized copy has its own
     void inferReturnTypes() {
-        // Scan all collected functions to infer their return types
-        for (auto& scopePair : functionScopes) {
-            for (auto& funcPair : scopePair.second.functions) {
-                FunctionDeclaration* func = funcPair.second;
-                std::string funcName = funcPair.first;
-                
-                // Look for return statements in the function body
-                if (!func->isSingleExpression && !func->body.empty()) {
-                    for (auto& stmt : func->body) {
-                        if (auto retStmt = dynamic_cast<ReturnStatement*>(stmt.get())) {
-                            if (retStmt->value) {
-                                // Infer type from return value
-                                if (dynamic_cast<ListLiteral*>(retStmt->value.get())) {
-                                    functionReturnTypes[funcName] = "list";
-                                } else if (auto id = dynamic_cast<Identifier*>(retStmt->value.get())) {
-                                    // Can't fully infer from identifier without executing
-                                    // Will be set during actual generation
-                                } else if (dynamic_cast<StringLiteral*>(retStmt->value.get())) {
-                                    functionReturnTypes[funcName] = "string";
-                                } else if (dynamic_cast<IntLiteral*>(retStmt->value.get())) {
-                                    functionReturnTypes[funcName] = "int";
-                                } else if (dynamic_cast<FloatLiteral*>(retStmt->value.get())) {
-                                    functionReturnTypes[funcName] = "float";
-                                } else if (dynamic_cast<BoolLiteral*>(retStmt->value.get())) {
-                                    functionReturnTypes[funcName] = "bool";
-                                }
-                            }
-                            break; // Found a return statement
-                        }
-                    }
-                }
+        if (!typeChecker) return;
+        for (const auto& entry : typeChecker->getReturnTypes()) {
+            std::string type = typeName(entry.second);
+            if (!type.empty()) {
+                functionReturnTypes[entry.first] = type;
             }
         }
     }
@@ -440,182 +653,250 @@ public:
         // Process non-main functions first, then main, to ensure return types are known
         for (const auto& scope : functionScopes) {
             for (const auto& funcPair : scope.second.functions) {
-                const std::string& funcName = funcPair.first;
-                if (funcName == "main") continue;  // Skip main for now
-                FunctionDeclaration* func = funcPair.second;
-                
-                // Use fn_ prefix to avoid collision with C main
-                std::string labelName = (funcName == "main") ? "fn_main" : funcName;
-                
-                funcsAsm << "\n" << labelName << ":\n";
-                funcsAsm << "    push %rbp\n";
-                funcsAsm << "    mov %rsp, %rbp\n";
-                funcsAsm << "    sub $64, %rsp  # Allocate stack space for local variables\n";
-                
-                // Save current state and enter function scope
-                bool wasInFunction = inFunction;
-                auto savedLocalVars = localVariables;
-                int savedStackOffset = stackOffset;
-                std::ostringstream* savedOutput = nullptr;
-                
-                // Temporarily redirect output to funcsAsm for function body
-                savedOutput = &assembly;
-                
-                inFunction = true;
-                currentFunctionName = funcName;
-                localVariables.clear();
-                stackOffset = 0;
-                
-                // Set up parameters - move from calling convention registers to stack
-                const std::string callingConventionRegs[] = {"%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9"};
-                
-                funcsAsm << "    # Setting up function parameters for " << funcName << "\n";
-                for (size_t i = 0; i < func->parameters.size() && i < 6; i++) {
-                    const auto& param = func->parameters[i];
-                    
-                    // Allocate stack slot for parameter
-                    stackOffset += 8;
-                    VariableInfo paramInfo;
-                    paramInfo.stackOffset = stackOffset;
-                    // Try to infer parameter type from calling context, default to string for flexibility
-                    paramInfo.type = (param.type.toString() != "unknown") ? param.type.toString() : "string";
-                    paramInfo.isGlobal = false;
-                    paramInfo.isConstant = false;
-                    
-                    // Register parameter in local variables
-                    localVariables[param.name] = paramInfo;
-                    
-                    // Move parameter from register to stack
-                    funcsAsm << "    mov " << callingConventionRegs[i] << ", -" << stackOffset 
-                             << "(%rbp)  # Parameter " << param.name << " (type: " << paramInfo.type << ")\n";
-                }
-                
-                // Redirect assembly output to funcsAsm for function body generation
-                std::string currentAssembly = assembly.str();
-                assembly.str("");
-                assembly.clear();
-                
-                // Generate function body
-                if (func->isSingleExpression) {
-                    func->expression->accept(*this);
-                } else {
-                    for (auto& stmt : func->body) {
-                        stmt->accept(*this);
-                    }
+                if (funcPair.first != "main") {
+                    emitFunctionCopies(funcPair.first, funcPair.second);
                 }
-                
-                // Move generated body code to funcsAsm and restore assembly
-                funcsAsm << assembly.str();
-                assembly.str("");
-                assembly.clear();
-                assembly << currentAssembly;
-                
-                // Cleanup: Release all local variables before function return
-                funcsAsm << "    # Cleanup local variables\n";
-                cleanupVariables(localVariables, funcsAsm);
-                
-                // Function epilogue - user functions should return to caller
-                funcsAsm << "    add $64, %rsp  # Restore stack space\n";
-                funcsAsm << "    pop %rbp\n";
-                funcsAsm << "    ret\n";
-                
-                // Restore previous state
-                inFunction = wasInFunction;
-                currentFunctionName = "";
-                localVariables = savedLocalVars;
-                stackOffset = savedStackOffset;
             }
         }
-        
-        // Now process main function last
         for (const auto& scope : functionScopes) {
-            for (const auto& funcPair : scope.second.functions) {
-                const std::string& funcName = funcPair.first;
-                if (funcName != "main") continue;  // Only process main now
-                FunctionDeclaration* func = funcPair.second;
-                
-                // Use fn_ prefix to avoid collision with C main
-                std::string labelName = "fn_main";
-                
-                funcsAsm << "\n" << labelName << ":\n";
-                funcsAsm << "    push %rbp\n";
-                funcsAsm << "    mov %rsp, %rbp\n";
-                funcsAsm << "    sub $64, %rsp  # Allocate stack space for local variables\n";
-                
-                // Save current state and enter function scope
-                bool wasInFunction = inFunction;
-                auto savedLocalVars = localVariables;
-                int savedStackOffset = stackOffset;
-                std::ostringstream* savedOutput = nullptr;
-                
-                // Temporarily redirect output to funcsAsm for function body
-                savedOutput = &assembly;
-                
-                inFunction = true;
-                currentFunctionName = funcName;
-                localVariables.clear();
-                stackOffset = 0;
-                
-                // Set up parameters - move from calling convention registers to stack
-                const std::string callingConventionRegs[] = {"%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9"};
-                
-                funcsAsm << "    # Setting up function parameters for " << funcName << "\n";
-                for (size_t i = 0; i < func->parameters.size() && i < 6; i++) {
-                    const auto& param = func->parameters[i];
-                    
-                    // Allocate stack slot for parameter
-                    stackOffset += 8;
-                    VariableInfo paramInfo;
-                    paramInfo.stackOffset = stackOffset;
-                    // Try to infer parameter type from calling context, default to string for flexibility
-                    paramInfo.type = (param.type.toString() != "unknown") ? param.type.toString() : "string";
-                    paramInfo.isGlobal = false;
-                    paramInfo.isConstant = false;
-                    
-                    // Register parameter in local variables
-                    localVariables[param.name] = paramInfo;
-                    
-                    // Move parameter from register to stack
-                    funcsAsm << "    mov " << callingConventionRegs[i] << ", -" << stackOffset 
-                             << "(%rbp)  # Parameter " << param.name << " (type: " << paramInfo.type << ")\n";
-                }
-                
-                // Redirect assembly output to funcsAsm for function body generation
-                std::string currentAssembly = assembly.str();
-                assembly.str("");
-                assembly.clear();
-                
-                // Generate function body
-                if (func->isSingleExpression) {
-                    func->expression->accept(*this);
-                } else {
-                    for (auto& stmt : func->body) {
-                        stmt->accept(*this);
-                    }
-                }
-                
-                // Move generated body code to funcsAsm and restore assembly
-                funcsAsm << assembly.str();
-                assembly.str("");
-                assembly.clear();
-                assembly << currentAssembly;
-                
-                // Cleanup: Release all local variables before function return
-                funcsAsm << "    # Cleanup local variables\n";
-                cleanupVariables(localVariables, funcsAsm);
-                
-                // Function epilogue - user functions should return to caller
-                funcsAsm << "    add $64, %rsp  # Restore stack space\n";
-                funcsAsm << "    pop %rbp\n";
-                funcsAsm << "    ret\n";
-                
-                // Restore previous state
-                inFunction = wasInFunction;
-                currentFunctionName = "";
-                localVariables = savedLocalVars;
-                stackOffset = savedStackOffset;
+            auto mainIt = scope.second.functions.find("main");
+            if (mainIt != scope.second.functions.end()) {
+                emitFunctionCopies(mainIt->first, mainIt->second);
+            }
+        }
+    }
+    
+    // The generic body, then one copy per argument type tuple the type checker
+    // found at the call sites, each compiled with its parameters fully typed
+    void emitFunctionCopies(const std::string& funcName, FunctionDeclaration* func) {
+        // Use fn_ prefix to avoid collision with C main
+        emitFunction(funcName, funcName == "main" ? "fn_main" : funcName, func);
+        if (!typeChecker) return;
+        for (const auto& copy : typeChecker->specializationsOf(funcName)) {
+            std::string previous = typeChecker->specialize(*func, copy.label);
+            emitFunction(funcName, copy.label, func);
+            typeChecker->specialize(*func, previous);
+        }
+    }
+    
+    // Functions record their return type under their label, so each copy of a
+    // monomorphized function has its own
+    static const std::string& returnTypeKey(const FunctionCall& call) {
+        return call.specialization.empty() ? call.name : call.specialization;
+    }
+    
+    // Stack frame size for the slots allocated so far, keeping %rsp 16-byte aligned
+    int frameSize() const {
+        return (stackOffset + 15) / 16 * 16;
+    }
+    
+    // Zero every slot so that cleanup never releases an uninitialized pointer
+    void emitZeroSlots(int firstOffset, int frameBytes, std::ostringstream& output) {
+        for (int offset = firstOffset; offset <= frameBytes; offset += 8) {
+            bool inObject = false;
+            for (const auto& object : frameObjects) {
+                inObject = inObject || (offset >= object.first && offset <= object.second);
+            }
+            if (!inObject) output << "    movq $0, -" << offset << "(%rbp)\n";
+        }
+    }
+    
+    bool isFrameAllocated(const Expression* site) const {
+        return escapeAnalysis && escapeAnalysis->isFrameAllocated(site);
+    }
+    
+    // Reserves bytes in the current frame for an object that does not escape;
+    // returns the %rbp offset of its lowest address
+    int allocateFrameObject(int bytes) {
+        int low = stackOffset + 8;
+        stackOffset += (bytes + 7) / 8 * 8;
+        frameObjects.emplace_back(low, stackOffset);
+        return stackOffset;
+    }
+    
+    // Frame setup with call frame information, so unwinders (perf --call-graph,
+    // gdb backtraces) can walk through generated functions
+    void emitPrologue(std::ostringstream& output) {
+        output << "    .cfi_startproc\n";
+        output << "    push %rbp\n";
+        output << "    .cfi_def_cfa_offset 16\n";
+        output << "    .cfi_offset %rbp, -16\n";
+        output << "    mov %rsp, %rbp\n";
+        output << "    .cfi_def_cfa_register %rbp\n";
+    }
+    
+    // Cold blocks moved out of line by profile-guided layout follow the ret
+    // and still run inside the frame, so their unwind state is the body's
+    void emitEpilogue(std::ostringstream& output, const std::string& coldCode = "") {
+        if (!coldCode.empty()) output << "    .cfi_remember_state\n";
+        output << "    pop %rbp\n";
+        output << "    .cfi_def_cfa %rsp, 8\n";
+        output << "    ret\n";
+        if (!coldCode.empty()) {
+            output << "    .cfi_restore_state\n";
+            output << "    # Cold blocks (profile-guided layout)\n";
+            output << coldCode;
+        }
+        output << "    .cfi_endproc\n";
+    }
+    
+    // Statements record the source position of their first token
+    void emitStatement(Statement& stmt) {
+        if (!sourcePath.empty() && stmt.line > 0) {
+            assembly << "    .loc 1 " << stmt.line << " " << stmt.column << "\n";
+        }
+        stmt.accept(*this);
+    }
+    
+    static std::string escapeAssemblyString(const std::string& text) {
+        std::string result;
+        for (char c : text) {
+            unsigned char byte = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                result += '\\';
+                result += c;
+            } else if (c == '\n') {
+                result += "\\n";
+            } else if (c == '\t') {
+                result += "\\t";
+            } else if (byte < 0x20 || byte == 0x7F) {
+                char octal[8];
+                snprintf(octal, sizeof(octal), "\\%03o", byte);
+                result += octal;
+            } else {
+                result += c;
+            }
+        }
+        return result;
+    }
+    
+    // A string constant laid out as the runtime's strings are: an
+    // OrionStringHeader that retain and release ignore, then the characters
+    static void emitStringObject(std::ostringstream& out, const std::string& label, const std::string& text) {
+        out << ".balign 8\n";
+        out << "    .quad " << STRING_STATIC_REFCOUNT << ", " << text.size() << ", " << text.size() << ", 0\n";
+        out << label << ": .string \"" << escapeAssemblyString(text) << "\"\n";
+    }
+    
+    void emitFunction(const std::string& funcName, const std::string& labelName, FunctionDeclaration* func) {
+        // Monomorphized copies are generated, profiled and typed under their own label
+        std::string copyName = labelName == "fn_main" ? funcName : labelName;
+        
+        // Save current state and enter function scope
+        bool wasInFunction = inFunction;
+        auto savedLocalVars = localVariables;
+        int savedStackOffset = stackOffset;
+        auto savedFrameObjects = frameObjects;
+        std::string savedReturnLabel = currentReturnLabel;
+        RefCountStats savedRefCounts = refCounts;
+        
+        inFunction = true;
+        currentFunctionName = copyName;
+        currentReturnLabel = newLabel("return_");
+        localVariables.clear();
+        stackOffset = 0;
+        frameObjects.clear();
+        refCounts = RefCountStats();
+        
+        // Set up parameters - move from calling convention registers to stack
+        const std::string callingConventionRegs[] = {"%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9"};
+        std::ostringstream paramAsm;
+        paramAsm << "    # Setting up function parameters for " << copyName << "\n";
+        for (size_t i = 0; i < func->parameters.size() && i < 6; i++) {
+            const auto& param = func->parameters[i];
+            
+            // Allocate stack slot for parameter
+            stackOffset += 8;
+            VariableInfo paramInfo;
+            paramInfo.stackOffset = stackOffset;
+            // Untyped parameters stay "unknown": they are neither released nor assumed to be strings.
+            // Containers and strings are borrowed from the caller, so they are not released either
+            std::string paramType = typeName(param.type);
+            paramInfo.type = paramType.empty() || isRefCountedType(paramType) ? "unknown" : paramType;
+            if (isRefCountedType(paramType)) refCounts.borrowed++;
+            paramInfo.isGlobal = false;
+            paramInfo.isConstant = false;
+            
+            // Register parameter in local variables
+            localVariables[param.name] = paramInfo;
+            
+            // Move parameter from register to stack
+            paramAsm << "    mov " << callingConventionRegs[i] << ", -" << stackOffset
+                     << "(%rbp)  # Parameter " << param.name << " (type: " << paramInfo.type << ")\n";
+        }
+        int firstLocalOffset = stackOffset + 8;
+        stackOffset += 8;
+        int returnSlot = stackOffset;
+        
+        // Cold blocks belong to the function they were split from
+        std::string savedColdAsm = coldAsm.str();
+        coldAsm.str("");
+        coldAsm.clear();
+        
+        // Redirect assembly output so the body is generated before the frame size is known
+        std::string currentAssembly = assembly.str();
+        assembly.str("");
+        assembly.clear();
+        
+        // Generate function body
+        if (func->isSingleExpression) {
+            emitReturnValue(func->expression.get());
+        } else {
+            for (auto& stmt : func->body) {
+                emitStatement(*stmt);
             }
         }
+        std::string bodyAsm = assembly.str();
+        assembly.str("");
+        assembly.clear();
+        assembly << currentAssembly;
+        
+        int frameBytes = frameSize();
+        funcsAsm << "\n.type " << labelName << ", @function\n";
+        funcsAsm << labelName << ":\n";
+        emitPrologue(funcsAsm);
+        if (func->line > 0) {
+            funcsAsm << "    .loc 1 " << func->line << " " << func->column << "\n";
+        }
+        funcsAsm << "    sub $" << frameBytes << ", %rsp  # Allocate stack space for local variables\n";
+        funcsAsm << paramAsm.str();
+        emitZeroSlots(firstLocalOffset, frameBytes, funcsAsm);
+        size_t functionId = emittedFunctions.size();
+        emittedFunctions.push_back(EmittedFunction{copyName, labelName});
+        if (profiling) {
+            funcsAsm << "    mov $" << functionId << ", %rdi\n";
+            funcsAsm << "    call __orion_prof_enter\n";
+        }
+        funcsAsm << bodyAsm;
+        
+        // Every return jumps here; the return value survives cleanup in its own slot
+        funcsAsm << currentReturnLabel << ":\n";
+        funcsAsm << "    mov %rax, -" << returnSlot << "(%rbp)  # Save return value\n";
+        funcsAsm << "    # Cleanup local variables\n";
+        cleanupVariables(localVariables, funcsAsm);
+        emittedFunctions[functionId].refCounts = refCounts;
+        if (profiling) {
+            funcsAsm << "    mov $" << functionId << ", %rdi\n";
+            funcsAsm << "    call __orion_prof_exit\n";
+        }
+        funcsAsm << "    mov -" << returnSlot << "(%rbp), %rax  # Restore return value\n";
+        
+        // Function epilogue - user functions should return to caller
+        funcsAsm << "    mov %rbp, %rsp  # Restore stack space\n";
+        emitEpilogue(funcsAsm, coldAsm.str());
+        coldAsm.str(savedColdAsm);
+        coldAsm.seekp(0, std::ios::end);
+        funcsAsm << ".Lorion_end_" << functionId << ":\n";
+        funcsAsm << ".size " << labelName << ", .-" << labelName << "\n";
+        
+        // Restore previous state
+        inFunction = wasInFunction;
+        currentFunctionName = "";
+        currentReturnLabel = savedReturnLabel;
+        localVariables = savedLocalVars;
+        stackOffset = savedStackOffset;
+        frameObjects = savedFrameObjects;
+        refCounts = savedRefCounts;
     }
     
     void visit(FunctionDeclaration& node) override {
@@ -754,78 +1035,16 @@ public:
         }
         
         if (node.initializer) {
-            // Determine variable type from initializer
-            std::string varType = "unknown";
-            if (auto intLit = dynamic_cast<IntLiteral*>(node.initializer.get())) {
-                varType = "int";
-            } else if (auto strLit = dynamic_cast<StringLiteral*>(node.initializer.get())) {
-                varType = "string";
-            } else if (auto boolLit = dynamic_cast<BoolLiteral*>(node.initializer.get())) {
-                varType = "bool";
-            } else if (auto floatLit = dynamic_cast<FloatLiteral*>(node.initializer.get())) {
-                varType = "float";
-            } else if (auto listLit = dynamic_cast<ListLiteral*>(node.initializer.get())) {
-                varType = "list";
-            } else if (auto id = dynamic_cast<Identifier*>(node.initializer.get())) {
-                // Variable assignment: copy type from source variable
-                auto varInfo = lookupVariable(id->name);
-                if (varInfo != nullptr) {
-                    varType = varInfo->type;
-                }
-            } else if (auto binExpr = dynamic_cast<BinaryExpression*>(node.initializer.get())) {
-                // Binary expression: infer type from operands
-                // For arithmetic operations, the result is typically int
-                switch (binExpr->op) {
-                    case BinaryOp::ADD:
-                    case BinaryOp::SUB:
-                    case BinaryOp::MUL:
-                    case BinaryOp::DIV:
-                    case BinaryOp::MOD:
-                    case BinaryOp::FLOOR_DIV:
-                    case BinaryOp::POWER:
-                        // Check if either operand is a float
-                        if (isFloatExpression(binExpr->left.get()) || isFloatExpression(binExpr->right.get())) {
-                            varType = "float";
-                        } else {
-                            varType = "int";
-                        }
-                        break;
-                    case BinaryOp::EQ:
-                    case BinaryOp::NE:
-                    case BinaryOp::LT:
-                    case BinaryOp::LE:
-                    case BinaryOp::GT:
-                    case BinaryOp::GE:
-                    case BinaryOp::AND:
-                    case BinaryOp::OR:
-                        varType = "bool";  // Comparison/logical operations result in bool
-                        break;
-                    default:
-                        varType = "int";  // Default to int for unknown operations
-                        break;
-                }
-            } else if (auto funcCall = dynamic_cast<FunctionCall*>(node.initializer.get())) {
-                // Function call: infer return type based on function name
-                if (funcCall->name == "input") {
-                    varType = "string";  // input() returns a string
-                } else if (funcCall->name == "len") {
-                    varType = "int";     // len() returns an integer
-                } else if (funcCall->name == "dtype") {
-                    varType = "string";  // dtype() returns a string representation
-                } else if (funcCall->name == "range") {
-                    varType = "range";   // range() returns a range object
-                } else {
-                    // Check if we have return type info for user-defined functions
-                    if (functionReturnTypes.find(funcCall->name) != functionReturnTypes.end()) {
-                        varType = functionReturnTypes[funcCall->name];
-                    } else {
-                        // For user-defined functions without known return type
-                        // Default to string as a safe fallback
-                        varType = "string";
-                    }
-                }
+            // Variable type from the TypeChecker; "unknown" where it gave up
+            std::string varType = typeName(node.initializer->inferredType);
+            if (varType.empty()) {
+                varType = "unknown";
             }
             
+            // A variable that only ever holds this type has a null slot or an
+            // earlier value of the type, so its old value can always be released
+            bool oneType = escapeAnalysis && escapeAnalysis->holdsOneType(&node);
+            
             // Check if variable already exists - if so, treat as reassignment
             VariableInfo* existingVar = lookupVariable(node.name);
             if (existingVar) {
@@ -838,14 +1057,9 @@ public:
                     throw std::runtime_error("Error: You are trying to change the value of a constant variable '" + node.name + "'");
                 }
                 
-                // Release old value if it's a heap-allocated type
-                if (existingVar->type == "list" || existingVar->type == "string" || existingVar->type == "range") {
-                    assembly << "    # Releasing old value of " << node.name << " before reassignment\n";
-                    releaseVariable(node.name, existingVar, assembly);
-                }
-                
                 // Update type if needed, but keep existing slot and scope
                 existingVar->type = varType;
+                existingVar->mixedTypes = existingVar->mixedTypes || !oneType;
             } else {
                 // Variable doesn't exist - create new variable
                 // Python-style scoping rules - PRE-DECLARE variable before evaluating initializer
@@ -857,6 +1071,7 @@ public:
                     varInfo.type = varType;
                     varInfo.isGlobal = true;
                     varInfo.isConstant = node.isConstant;
+                    varInfo.mixedTypes = !oneType;
                     globalVariables[node.name] = varInfo;
                     
                     if (node.isConstant) {
@@ -870,6 +1085,7 @@ public:
                     varInfo.type = varType;
                     varInfo.isGlobal = false;
                     varInfo.isConstant = node.isConstant;
+                    varInfo.mixedTypes = !oneType;
                     localVariables[node.name] = varInfo;
                     
                     if (node.isConstant) {
@@ -878,36 +1094,47 @@ public:
                 }
             }
             
+            // A declaration inside a loop re-creates its frame object in place;
+            // a list first frees the storage the previous one grew into
+            if (isFrameAllocated(node.initializer.get())) {
+                VariableInfo* frameVar = lookupVariable(node.name);
+                frameVar->inFrame = true;
+                releaseVariable(node.name, frameVar, assembly);
+            }
+            
             // Now evaluate initializer - variable is already declared
             node.initializer->accept(*this);
             
             // Store the result in the pre-allocated variable slot using recorded offset
             VariableInfo* varInfo = lookupVariable(node.name);
             if (varInfo != nullptr) {
-                // Use lastExprType if available, otherwise use varInfo->type
-                std::string actualType = lastExprType.empty() ? varInfo->type : lastExprType;
+                std::string actualType = varInfo->type;
                 
                 // If storing a heap-allocated value:
                 // - New objects (lists, ranges created fresh): already have refcount=1, no retain needed
-                // - Existing references (from variables, parameters): need retain to share ownership
-                if ((actualType == "list" || actualType == "string" || actualType == "range") && !lastExprWasNewHeapObject) {
+                // - A variable at its last use: its reference moves over
+                // - Other existing references (from variables, parameters): need retain to share ownership
+                VariableInfo* source = isRefCountedType(actualType) ? movableVariable(node.initializer.get(), false) : nullptr;
+                if (producesOwnedReference(node.initializer.get())) {
+                    assembly << "    # Storing new " << actualType << " - no retain needed (refcount=1)\n";
+                    if (!varInfo->inFrame) refCounts.owned++;
+                } else if (source) {
+                    emitMove(static_cast<Identifier*>(node.initializer.get())->name, source);
+                } else if (isRefCountedType(actualType) && !arena) {
                     assembly << "    # Retaining " << actualType << " before storing to " << node.name << " (existing reference)\n";
                     assembly << "    mov %rax, %rdi\n";
-                    
-                    if (actualType == "list") {
-                        assembly << "    call list_retain\n";
-                    } else if (actualType == "string") {
-                        assembly << "    call string_retain\n";
-                    } else if (actualType == "range") {
-                        assembly << "    call range_retain\n";
-                    }
-                } else if (lastExprWasNewHeapObject) {
-                    assembly << "    # Storing new " << actualType << " - no retain needed (refcount=1)\n";
+                    assembly << "    call " << actualType << "_retain\n";
+                    refCounts.retains++;
+                }
+                
+                // The old value goes once the new one is evaluated, which may read it
+                if (isRefCountedType(varInfo->type) && !varInfo->inFrame && !varInfo->mixedTypes && !arena) {
+                    assembly << "    push %rax  # Save new value\n";
+                    releaseVariable(node.name, varInfo, assembly);
+                    assembly << "    pop %rax  # Restore new value\n";
                 }
                 
                 assembly << "    mov %rax, -" << varInfo->stackOffset << "(%rbp)  # store " << (varInfo->isGlobal ? "global" : "local") << " " << node.name << "\n";
-                lastExprWasNewHeapObject = false;  // Reset after use
-                lastExprType = "";  // Reset after use
             }
         }
     }
@@ -934,7 +1161,8 @@ public:
     }
     
     void visit(FunctionCall& node) override {
-        // Handle built-in type conversion functions
+        // Handle built-in type conversion functions; the argument's inferred
+        // type picks the runtime helper
         if (node.name == "str") {
             if (node.arguments.size() != 1) {
                 throw std::runtime_error("str() function requires exactly 1 argument");
@@ -942,57 +1170,28 @@ public:
             assembly << "    # str() type conversion function call\n";
             
             // Evaluate the argument
-            node.arguments[0]->accept(*this);
+            Expression* argExpr = node.arguments[0].get();
+            argExpr->accept(*this);
             
-            // Determine the type of the argument and call appropriate runtime helper
-            auto argExpr = node.arguments[0].get();
-            if (auto intLit = dynamic_cast<IntLiteral*>(argExpr)) {
-                assembly << "    mov %rax, %rdi  # int argument\n";
-                assembly << "    call __orion_int_to_string\n";
-            } else if (auto floatLit = dynamic_cast<FloatLiteral*>(argExpr)) {
-                assembly << "    movq %rax, %xmm0  # float argument\n";
-                assembly << "    call __orion_float_to_string\n";
-            } else if (auto boolLit = dynamic_cast<BoolLiteral*>(argExpr)) {
-                assembly << "    mov %rax, %rdi  # bool argument\n";
-                assembly << "    call __orion_bool_to_string\n";
-            } else if (auto strLit = dynamic_cast<StringLiteral*>(argExpr)) {
-                // String to string is identity - result already in %rax
-                assembly << "    # String to string conversion (identity)\n";
-            } else if (auto id = dynamic_cast<Identifier*>(argExpr)) {
-                // Variable - determine type from variable info
-                auto varInfo = lookupVariable(id->name);
-                if (varInfo) {
-                    if (varInfo->type == "int") {
-                        assembly << "    mov %rax, %rdi  # int variable\n";
-                        assembly << "    call __orion_int_to_string\n";
-                    } else if (varInfo->type == "float") {
-                        assembly << "    movq %rax, %xmm0  # float variable\n";
-                        assembly << "    call __orion_float_to_string\n";
-                    } else if (varInfo->type == "bool") {
-                        assembly << "    mov %rax, %rdi  # bool variable\n";
-                        assembly << "    call __orion_bool_to_string\n";
-                    } else if (varInfo->type == "string") {
-                        // String to string is identity
-                        assembly << "    # String variable to string conversion (identity)\n";
-                    }
-                }
-            } else if (auto funcCall = dynamic_cast<FunctionCall*>(argExpr)) {
-                // Handle function call arguments to str()
-                if (funcCall->name == "flt") {
-                    assembly << "    movq %rax, %xmm0  # flt() result as float\n";
+            switch (annotatedKind(argExpr)) {
+                case ExprKind::STRING:
+                    assembly << "    # String to string conversion (identity)\n";
+                    break;
+                case ExprKind::FLOAT:
+                    assembly << "    movq %rax, %xmm0  # float argument\n";
                     assembly << "    call __orion_float_to_string\n";
-                } else if (funcCall->name == "int") {
-                    assembly << "    mov %rax, %rdi  # int() result as integer\n";
-                    assembly << "    call __orion_int_to_string\n";
-                } else {
-                    // Other function calls default to int for now
-                    assembly << "    mov %rax, %rdi  # other function result\n";
+                    break;
+                case ExprKind::BOOL:
+                    assembly << "    mov %rax, %rdi  # bool argument\n";
+                    assembly << "    call __orion_bool_to_string\n";
+                    break;
+                case ExprKind::INT:
+                    assembly << "    mov %rax, %rdi  # int argument\n";
                     assembly << "    call __orion_int_to_string\n";
-                }
-            } else {
-                // For other complex expressions, default to int conversion
-                assembly << "    mov %rax, %rdi  # complex expression argument\n";
-                assembly << "    call __orion_int_to_string  # Default to int conversion\n";
+                    break;
+                default:
+                    emitTypeError(node.line, "str() of a value of unknown type");
+                    break;
             }
             return;
         } else if (node.name == "int") {
@@ -1002,43 +1201,28 @@ public:
             assembly << "    # int() type conversion function call\n";
             
             // Evaluate the argument
-            node.arguments[0]->accept(*this);
+            Expression* argExpr = node.arguments[0].get();
+            argExpr->accept(*this);
             
-            // Determine the type of the argument and call appropriate runtime helper
-            auto argExpr = node.arguments[0].get();
-            if (auto intLit = dynamic_cast<IntLiteral*>(argExpr)) {
-                // Int to int is identity - result already in %rax
-                assembly << "    # Int to int conversion (identity)\n";
-            } else if (auto floatLit = dynamic_cast<FloatLiteral*>(argExpr)) {
-                assembly << "    movq %rax, %xmm0  # float argument\n";
-                assembly << "    call __orion_float_to_int\n";
-            } else if (auto boolLit = dynamic_cast<BoolLiteral*>(argExpr)) {
-                assembly << "    mov %rax, %rdi  # bool argument\n";
-                assembly << "    call __orion_bool_to_int\n";
-            } else if (auto strLit = dynamic_cast<StringLiteral*>(argExpr)) {
-                assembly << "    mov %rax, %rdi  # string argument\n";
-                assembly << "    call __orion_string_to_int\n";
-            } else if (auto id = dynamic_cast<Identifier*>(argExpr)) {
-                // Variable - determine type from variable info
-                auto varInfo = lookupVariable(id->name);
-                if (varInfo) {
-                    if (varInfo->type == "int") {
-                        assembly << "    # Int variable to int conversion (identity)\n";
-                    } else if (varInfo->type == "float") {
-                        assembly << "    movq %rax, %xmm0  # float variable\n";
-                        assembly << "    call __orion_float_to_int\n";
-                    } else if (varInfo->type == "bool") {
-                        assembly << "    mov %rax, %rdi  # bool variable\n";
-                        assembly << "    call __orion_bool_to_int\n";
-                    } else if (varInfo->type == "string") {
-                        assembly << "    mov %rax, %rdi  # string variable\n";
-                        assembly << "    call __orion_string_to_int\n";
-                    }
-                }
-            } else {
-                // For complex expressions, default to int conversion
-                assembly << "    mov %rax, %rdi  # complex expression argument\n";
-                assembly << "    call __orion_int_to_int  # Default to int identity\n";
+            switch (annotatedKind(argExpr)) {
+                case ExprKind::FLOAT:
+                    assembly << "    movq %rax, %xmm0  # float argument\n";
+                    assembly << "    call __orion_float_to_int\n";
+                    break;
+                case ExprKind::BOOL:
+                    assembly << "    mov %rax, %rdi  # bool argument\n";
+                    assembly << "    call __orion_bool_to_int\n";
+                    break;
+                case ExprKind::STRING:
+                    assembly << "    mov %rax, %rdi  # string argument\n";
+                    assembly << "    call __orion_string_to_int\n";
+                    break;
+                case ExprKind::INT:
+                    assembly << "    # Int to int conversion (identity)\n";
+                    break;
+                default:
+                    emitTypeError(node.line, "int() of a value of unknown type");
+                    break;
             }
             return;
         } else if (node.name == "flt") {
@@ -1048,43 +1232,28 @@ public:
             assembly << "    # flt() type conversion function call\n";
             
             // Evaluate the argument
-            node.arguments[0]->accept(*this);
+            Expression* argExpr = node.arguments[0].get();
+            argExpr->accept(*this);
             
-            // Determine the type of the argument and call appropriate runtime helper
-            auto argExpr = node.arguments[0].get();
-            if (auto intLit = dynamic_cast<IntLiteral*>(argExpr)) {
-                assembly << "    mov %rax, %rdi  # int argument\n";
-                assembly << "    call __orion_int_to_float\n";
-            } else if (auto floatLit = dynamic_cast<FloatLiteral*>(argExpr)) {
-                // Float to float is identity - result already in %rax
-                assembly << "    # Float to float conversion (identity)\n";
-            } else if (auto boolLit = dynamic_cast<BoolLiteral*>(argExpr)) {
-                assembly << "    mov %rax, %rdi  # bool argument\n";
-                assembly << "    call __orion_bool_to_float\n";
-            } else if (auto strLit = dynamic_cast<StringLiteral*>(argExpr)) {
-                assembly << "    mov %rax, %rdi  # string argument\n";
-                assembly << "    call __orion_string_to_float\n";
-            } else if (auto id = dynamic_cast<Identifier*>(argExpr)) {
-                // Variable - determine type from variable info
-                auto varInfo = lookupVariable(id->name);
-                if (varInfo) {
-                    if (varInfo->type == "int") {
-                        assembly << "    mov %rax, %rdi  # int variable\n";
-                        assembly << "    call __orion_int_to_float\n";
-                    } else if (varInfo->type == "float") {
-                        assembly << "    # Float variable to float conversion (identity)\n";
-                    } else if (varInfo->type == "bool") {
-                        assembly << "    mov %rax, %rdi  # bool variable\n";
-                        assembly << "    call __orion_bool_to_float\n";
-                    } else if (varInfo->type == "string") {
-                        assembly << "    mov %rax, %rdi  # string variable\n";
-                        assembly << "    call __orion_string_to_float\n";
-                    }
-                }
-            } else {
-                // For complex expressions, default to int to float conversion
-                assembly << "    mov %rax, %rdi  # complex expression argument\n";
-                assembly << "    call __orion_int_to_float  # Default to int to float\n";
+            switch (annotatedKind(argExpr)) {
+                case ExprKind::FLOAT:
+                    assembly << "    # Float to float conversion (identity)\n";
+                    break;
+                case ExprKind::BOOL:
+                    assembly << "    mov %rax, %rdi  # bool argument\n";
+                    assembly << "    call __orion_bool_to_float\n";
+                    break;
+                case ExprKind::STRING:
+                    assembly << "    mov %rax, %rdi  # string argument\n";
+                    assembly << "    call __orion_string_to_float\n";
+                    break;
+                case ExprKind::INT:
+                    assembly << "    mov %rax, %rdi  # int argument\n";
+                    assembly << "    call __orion_int_to_float\n";
+                    break;
+                default:
+                    emitTypeError(node.line, "flt() of a value of unknown type");
+                    break;
             }
             return;
         }
@@ -1096,24 +1265,41 @@ public:
             }
             assembly << "    # len() function call\n";
             
-            // Check if the argument is a range() function call
-            if (auto funcCall = dynamic_cast<FunctionCall*>(node.arguments[0].get())) {
-                if (funcCall->name == "range") {
-                    // This is a range object - call range_len
-                    node.arguments[0]->accept(*this);  // Evaluate range argument
-                    assembly << "    mov %rax, %rdi  # Range pointer as argument\n";
-                    assembly << "    call range_len  # Get range length\n";
-                    // Result in %rax
+            // The argument's type picks the length: a runtime call for ranges,
+            // dicts and lists, the string header for strings
+            Expression* argExpr = node.arguments[0].get();
+            ExprKind kind = annotatedKind(argExpr);
+            argExpr->accept(*this);
+            switch (kind) {
+                case ExprKind::STRING:
+                    assembly << "    mov -" << STRING_LENGTH_OFFSET << "(%rax), %rax  # Length from the string header\n";
+                    return;
+                case ExprKind::RANGE:
+                case ExprKind::DICT:
+                case ExprKind::LIST: {
+                    const char* container = kind == ExprKind::RANGE ? "range" : kind == ExprKind::DICT ? "dict" : "list";
+                    assembly << "    mov %rax, %rdi  # " << container << " pointer as argument\n";
+                    assembly << "    call " << container << "_len\n";
                     return;
                 }
+                default:
+                    emitTypeError(node.line, "len() of a value of unknown type");
+                    return;
             }
-            
-            // Default to list behavior for other cases
-            node.arguments[0]->accept(*this);  // Evaluate list argument
-            assembly << "    mov %rax, %rdi  # List pointer as argument\n";
-            assembly << "    call list_len  # Get list length\n";
-            // Result in %rax
-            return;
+        }
+        
+        // Outside a for-in loop a view is copied into a new list
+        if (node.name == "keys" || node.name == "values") {
+            if (node.arguments.size() != 1) {
+                throw std::runtime_error(node.name + "() function requires exactly 1 argument");
+            }
+            node.arguments[0]->accept(*this);
+            assembly << "    mov %rax, %rdi  # Dict pointer as argument\n";
+            assembly << "    call dict_" << node.name << "  # Copy " << node.name << " into a list\n";
+            return;
+        }
+        if (node.name == "items") {
+            throw std::runtime_error("items() can only be iterated by a for-in loop");
         }
         
         if (node.name == "append") {
@@ -1129,6 +1315,26 @@ public:
             
             // Evaluate element argument
             node.arguments[1]->accept(*this);
+            
+            // Elements of the list's own type go through its typed entry point
+            std::string suffix = typedListSuffix(node.arguments[0].get());
+            ExprKind valueKind = annotatedKind(node.arguments[1].get());
+            if ((suffix == "_int" && valueKind == ExprKind::INT) ||
+                (suffix == "_float" && (valueKind == ExprKind::FLOAT || valueKind == ExprKind::INT)) ||
+                (suffix == "_bool" && valueKind == ExprKind::BOOL)) {
+                if (suffix == "_bool") emitTruthValue();
+                if (suffix == "_float" && valueKind == ExprKind::INT) {
+                    assembly << "    cvtsi2sd %rax, %xmm0  # Int element converted for float list\n";
+                } else if (suffix == "_float") {
+                    assembly << "    movq %rax, %xmm0  # Element value as float argument\n";
+                } else {
+                    assembly << "    mov %rax, %rsi  # Element value as second argument\n";
+                }
+                assembly << "    pop %rdi  # Restore list pointer\n";
+                assembly << "    call list_append" << suffix << "  # Append element to typed list\n";
+                return;
+            }
+            emitRetainStoredValue(node.arguments[1].get());
             assembly << "    mov %rax, %rsi  # Element value as second argument\n";
             assembly << "    pop %rdi  # Restore list pointer\n";
             
@@ -1157,6 +1363,29 @@ public:
             
             assembly << "    # range() function call\n";
             
+            if (isFrameAllocated(&node)) {
+                // The range does not escape: initialize it in the frame
+                for (auto& argument : node.arguments) {
+                    argument->accept(*this);
+                    assembly << "    push %rax\n";
+                }
+                if (node.arguments.size() == 3) {
+                    assembly << "    pop %rcx  # Step\n";
+                } else {
+                    assembly << "    mov $1, %rcx  # Step\n";
+                }
+                assembly << "    pop %rdx  # Stop\n";
+                if (node.arguments.size() == 1) {
+                    assembly << "    xor %esi, %esi  # Start\n";
+                } else {
+                    assembly << "    pop %rsi  # Start\n";
+                }
+                int base = allocateFrameObject(FRAME_RANGE_BYTES);
+                assembly << "    lea -" << base << "(%rbp), %rdi  # Range in the frame\n";
+                assembly << "    call range_init\n";
+                return;
+            }
+            
             if (node.arguments.size() == 1) {
                 // range(stop) - start=0, step=1
                 node.arguments[0]->accept(*this);  // Evaluate stop argument
@@ -1199,184 +1428,84 @@ public:
             if (!node.arguments.empty()) {
                 auto& arg = node.arguments[0];
                 
-                // Check if the argument is a special function call
-                if (auto funcCall = dynamic_cast<FunctionCall*>(arg.get())) {
-                    // Handle built-in type conversion functions
-                    if (funcCall->name == "str") {
-                        assembly << "    # Call out() with str() result\n";
-                        funcCall->accept(*this);  // This calls str() and puts result in %rax
-                        assembly << "    mov %rax, %rsi  # String pointer as argument\n";
-                        assembly << "    mov $format_str, %rdi  # Use string format\n";
-                        assembly << "    xor %rax, %rax\n";
-                        assembly << "    call printf\n";
-                        return;
-                    } else if (funcCall->name == "int") {
-                        assembly << "    # Call out() with int() result\n";
-                        funcCall->accept(*this);  // This calls int() and puts result in %rax
-                        assembly << "    mov %rax, %rsi  # Integer value as argument\n";
-                        assembly << "    mov $format_int, %rdi  # Use integer format\n";
-                        assembly << "    xor %rax, %rax\n";
-                        assembly << "    call printf\n";
-                        return;
-                    } else if (funcCall->name == "flt") {
-                        assembly << "    # Call out() with flt() result\n";
-                        funcCall->accept(*this);  // This calls flt() and puts result in %rax
-                        assembly << "    movq %rax, %xmm0  # Float value to XMM register\n";
-                        assembly << "    mov $format_float, %rdi  # Use float format\n";
-                        assembly << "    mov $1, %rax  # Number of vector registers used\n";
-                        assembly << "    call printf\n";
-                        return;
-                    } else if (funcCall->name == "dtype" && !funcCall->arguments.empty()) {
-                        // Handle dtype() call inside out()
-                        auto dtypeArg = funcCall->arguments[0].get();
-                        if (auto id = dynamic_cast<Identifier*>(dtypeArg)) {
-                            auto varIt = lookupVariable(id->name);
-                            if (varIt != nullptr) {
-                                assembly << "    # Call out(dtype(" << id->name << "))\n";
-                                std::string dtypeLabel;
-                                if (varIt->type == "int") {
-                                    dtypeLabel = "dtype_int";
-                                } else if (varIt->type == "string") {
-                                    dtypeLabel = "dtype_string";
-                                } else if (varIt->type == "bool") {
-                                    dtypeLabel = "dtype_bool";
-                                } else if (varIt->type == "float") {
-                                    dtypeLabel = "dtype_float";
-                                } else if (varIt->type == "list") {
-                                    dtypeLabel = "dtype_list";
-                                } else {
-                                    dtypeLabel = "dtype_unknown";
-                                }
-                                assembly << "    mov $" << dtypeLabel << ", %rsi\n";
-                                assembly << "    mov $format_str, %rdi\n";
-                                assembly << "    xor %rax, %rax\n";
-                                assembly << "    call printf\n";
-                            } else {
-                                throw std::runtime_error("Line " + std::to_string(id->line) + ": Error: Undefined variable '" + id->name + "'");
-                            }
-                        } else if (auto indexExpr = dynamic_cast<IndexExpression*>(dtypeArg)) {
-                            // Handle dtype(a[i]) - list element type detection
-                            assembly << "    # Call out(dtype(list[index]))\n";
-                            indexExpr->accept(*this);  // Evaluate the index access, result in %rax
-                            // Call smart type detection function
-                            assembly << "    mov %rax, %rdi  # Value to check\n";
-                            assembly << "    call detect_type  # Detect if string or integer\n";
-                            // Result in %rax is a pointer to the dtype string
-                            assembly << "    mov %rax, %rsi  # dtype string pointer\n";
-                            assembly << "    mov $format_str, %rdi\n";
-                            assembly << "    xor %rax, %rax\n";
-                            assembly << "    call printf\n";
-                        }
-                        return;
+                // dtype() inside out() prints the type name directly
+                if (auto funcCall = dynamic_cast<FunctionCall*>(arg.get());
+                    funcCall && funcCall->name == "dtype" && !funcCall->arguments.empty()) {
+                    Expression* dtypeArg = funcCall->arguments[0].get();
+                    std::string type = typeName(dtypeArg->inferredType);
+                    if (auto id = dynamic_cast<Identifier*>(dtypeArg); id && !lookupVariable(id->name)) {
+                        throw std::runtime_error("Line " + std::to_string(id->line) + ": Error: Undefined variable '" + id->name + "'");
                     }
+                    assembly << "    # Call out(dtype(...)) - type: " << type << "\n";
+                    assembly << "    mov $" << dtypeLabel(type) << ", %rsi\n";
+                    assembly << "    mov $format_str, %rdi\n";
+                    assembly << "    xor %rax, %rax\n";
+                    assembly << "    call printf\n";
+                    return;
                 }
                 
-                // Check the type of argument to determine format
+                // Literals are printed without evaluating them into %rax first
                 if (auto intLit = dynamic_cast<IntLiteral*>(arg.get())) {
                     assembly << "    # Call out() with integer\n";
                     assembly << "    mov $" << intLit->value << ", %rsi\n";
                     assembly << "    mov $format_int, %rdi\n";
                     assembly << "    xor %rax, %rax\n";
                     assembly << "    call printf\n";
-                } else if (auto strLit = dynamic_cast<StringLiteral*>(arg.get())) {
+                    return;
+                }
+                if (auto strLit = dynamic_cast<StringLiteral*>(arg.get())) {
                     int index = addStringLiteral(strLit->value);
                     assembly << "    # Call out() with string\n";
                     assembly << "    mov $str_" << index << ", %rsi\n";
                     assembly << "    mov $format_str, %rdi\n";
                     assembly << "    xor %rax, %rax\n";
                     assembly << "    call printf\n";
-                } else if (auto id = dynamic_cast<Identifier*>(arg.get())) {
-                    // Variable reference - use correct format based on type
-                    auto it = lookupVariable(id->name);
-                    if (it != nullptr) {
-                        assembly << "    # Call out() with variable: " << id->name << " (type: " << it->type << ")\n";
-                        assembly << "    mov -" << it->stackOffset << "(%rbp), %rsi\n";
-                        
-                        if (it->type == "int") {
-                            assembly << "    mov $format_int, %rdi\n";
-                            assembly << "    xor %rax, %rax\n";
-                        } else if (it->type == "bool") {
-                            assembly << "    mov $format_str, %rdi\n";
-                            assembly << "    xor %rax, %rax\n";
-                        } else if (it->type == "float") {
-                            assembly << "    movq -" << it->stackOffset << "(%rbp), %xmm0\n";  // Load float into XMM register  
-                            assembly << "    mov $format_float, %rdi\n";
-                            assembly << "    mov $1, %rax\n";  // Number of vector registers used
-                        } else {
-                            assembly << "    mov $format_str, %rdi\n";
-                            assembly << "    xor %rax, %rax\n";
-                        }
-                        
-                        assembly << "    call printf\n";
-                    } else {
-                        throw std::runtime_error("Error: Undefined variable '" + id->name + "'");
-                    }
-                } else if (auto boolLit = dynamic_cast<BoolLiteral*>(arg.get())) {
-                    // Boolean literal - output as string
+                    return;
+                }
+                if (auto boolLit = dynamic_cast<BoolLiteral*>(arg.get())) {
                     assembly << "    # Call out() with boolean literal\n";
                     assembly << "    mov $" << (boolLit->value ? "str_true" : "str_false") << ", %rsi\n";
                     assembly << "    mov $format_str, %rdi\n";
                     assembly << "    xor %rax, %rax\n";
                     assembly << "    call printf\n";
-                } else if (auto interpolated = dynamic_cast<InterpolatedString*>(arg.get())) {
-                    // Handle interpolated string - evaluate it and treat result as string
-                    assembly << "    # Call out() with interpolated string\n";
-                    arg->accept(*this);  // This calls our InterpolatedString visitor
-                    assembly << "    mov %rax, %rsi  # String pointer from interpolation result\n";
-                    assembly << "    mov $format_str, %rdi  # Use string format\n";
-                    assembly << "    xor %rax, %rax\n";
-                    assembly << "    call printf\n";
-                } else if (auto indexExpr = dynamic_cast<IndexExpression*>(arg.get())) {
-                    // Handle index access (like a[i]) - could be string or integer
-                    assembly << "    # Call out() with indexed access\n";
-                    indexExpr->accept(*this);  // Evaluate the index access
-                    // Call smart print that detects string vs integer
-                    assembly << "    mov %rax, %rdi  # Value to print\n";
-                    assembly << "    call print_smart  # Smart print handles strings and integers\n";
-                } else {
-                    // Generic expression (like arithmetic operations or comparisons)
-                    // Check if the expression result is a float
-                    bool isFloatResult = false;
-                    bool isComparisonResult = false;
-                    
-                    if (auto binExpr = dynamic_cast<BinaryExpression*>(arg.get())) {
-                        // Check if it's a comparison or logical operation
-                        if (binExpr->op == BinaryOp::EQ || binExpr->op == BinaryOp::NE ||
-                            binExpr->op == BinaryOp::LT || binExpr->op == BinaryOp::LE ||
-                            binExpr->op == BinaryOp::GT || binExpr->op == BinaryOp::GE ||
-                            binExpr->op == BinaryOp::AND || binExpr->op == BinaryOp::OR) {
-                            isComparisonResult = true;
-                        } else {
-                            isFloatResult = isFloatExpression(binExpr->left.get()) || isFloatExpression(binExpr->right.get());
-                        }
-                    } else if (auto unaryExpr = dynamic_cast<UnaryExpression*>(arg.get())) {
-                        // Check if it's a NOT operation (returns string)
-                        if (unaryExpr->op == UnaryOp::NOT) {
-                            isComparisonResult = true;
-                        }
-                    } else if (auto floatLit = dynamic_cast<FloatLiteral*>(arg.get())) {
-                        isFloatResult = true;
-                    }
-                    
-                    arg->accept(*this);
-                    assembly << "    # Call out() with expression result\n";
-                    
-                    if (isComparisonResult) {
-                        // Comparison results are string addresses (str_true/str_false)
+                    return;
+                }
+                
+                // Everything else is evaluated and printed with the format of its type
+                ExprKind kind = annotatedKind(arg.get());
+                arg->accept(*this);
+                switch (kind) {
+                    case ExprKind::INT:
+                        assembly << "    # Call out() with int\n";
                         assembly << "    mov %rax, %rsi\n";
-                        assembly << "    mov $format_str, %rdi\n";  // Use string format for comparison results
+                        assembly << "    mov $format_int, %rdi\n";
                         assembly << "    xor %rax, %rax\n";
-                    } else if (isFloatResult) {
+                        break;
+                    case ExprKind::FLOAT:
+                        assembly << "    # Call out() with float\n";
                         assembly << "    movq %rax, %xmm0  # Load float result into XMM register\n";
                         assembly << "    mov $format_float, %rdi\n";
                         assembly << "    mov $1, %rax  # Number of vector registers used\n";
-                    } else {
+                        break;
+                    case ExprKind::BOOL:
+                        emitBoolToString();
+                        [[fallthrough]];
+                    case ExprKind::STRING:
+                        assembly << "    # Call out() with string\n";
                         assembly << "    mov %rax, %rsi\n";
-                        assembly << "    mov $format_int, %rdi\n";  // Use integer format for computed results
+                        assembly << "    mov $format_str, %rdi\n";
                         assembly << "    xor %rax, %rax\n";
-                    }
-                    assembly << "    call printf\n";
+                        break;
+                    case ExprKind::RANGE:
+                        assembly << "    # Call out() with range\n";
+                        assembly << "    mov %rax, %rdi\n";
+                        assembly << "    call range_print\n";
+                        return;
+                    default:
+                        emitTypeError(node.line, "out() of a value of unknown type");
+                        return;
                 }
+                assembly << "    call printf\n";
             }
         } else if (node.name == "input") {
             // Handle input() function calls
@@ -1413,65 +1542,165 @@ public:
                 throw std::runtime_error("Error: input() function takes 0 or 1 argument");
             }
             return;
+        } else if (node.name == "arena_reset") {
+            // Frees every object at once when compiled with --arena; a no-op otherwise
+            if (!node.arguments.empty()) {
+                throw std::runtime_error("arena_reset() takes no arguments");
+            }
+            assembly << "    call orion_arena_reset\n";
         } else if (node.name == "dtype") {
             // Handle standalone dtype() calls (though typically used inside out())
             if (!node.arguments.empty()) {
                 auto& arg = node.arguments[0];
-                if (auto id = dynamic_cast<Identifier*>(arg.get())) {
-                    auto varIt = lookupVariable(id->name);
-                    if (varIt != nullptr) {
-                        assembly << "    # dtype(" << id->name << ") - type: " << varIt->type << "\n";
-                        // For standalone dtype(), we could return a type indicator
-                        // For now, just put the type string address in %rax
-                        std::string dtypeLabel;
-                        if (varIt->type == "int") {
-                            dtypeLabel = "dtype_int";
-                        } else if (varIt->type == "string") {
-                            dtypeLabel = "dtype_string";
-                        } else if (varIt->type == "bool") {
-                            dtypeLabel = "dtype_bool";
-                        } else if (varIt->type == "float") {
-                            dtypeLabel = "dtype_float";
-                        } else {
-                            dtypeLabel = "dtype_unknown";
-                        }
-                        assembly << "    mov $" << dtypeLabel << ", %rax\n";
-                    } else {
-                        throw std::runtime_error("Line " + std::to_string(id->line) + ": Error: Undefined variable '" + id->name + "'");
-                    }
+                if (auto id = dynamic_cast<Identifier*>(arg.get()); id && !lookupVariable(id->name)) {
+                    throw std::runtime_error("Line " + std::to_string(id->line) + ": Error: Undefined variable '" + id->name + "'");
                 }
+                // The type string address is the result
+                std::string type = typeName(arg->inferredType);
+                assembly << "    # dtype() - type: " << type << "\n";
+                assembly << "    mov $" << dtypeLabel(type) << ", %rax\n";
             }
         } else {
             // Handle user-defined function calls - generate proper assembly
+            std::string callKey = ProfileData::callKey(node.line, node.column, node.name);
+            if (tryInlineCall(node, profileCount(callKey))) {
+                return;
+            }
             assembly << "    # User-defined function call: " << node.name << "\n";
+            emitProfileCounter(callKey);
             
             // Prepare arguments in calling convention registers
             const std::string callingConventionRegs[] = {"%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9"};
             
-            for (size_t i = 0; i < node.arguments.size() && i < 6; i++) {
+            // Evaluate every argument onto the stack first; evaluating a later
+            // argument may itself make calls that clobber the argument registers
+            size_t argCount = std::min<size_t>(node.arguments.size(), 6);
+            for (size_t i = 0; i < argCount; i++) {
                 assembly << "    # Preparing argument " << i << "\n";
                 node.arguments[i]->accept(*this);  // Result in %rax
-                assembly << "    mov %rax, " << callingConventionRegs[i] << "  # Arg " << i << " to " << callingConventionRegs[i] << "\n";
+                assembly << "    push %rax  # Save argument " << i << "\n";
+            }
+            for (size_t i = argCount; i-- > 0;) {
+                assembly << "    pop " << callingConventionRegs[i] << "  # Arg " << i << " to " << callingConventionRegs[i] << "\n";
             }
             
-            // Generate the function call with correct label name
-            std::string callLabel = (node.name == "main") ? "fn_main" : node.name;
+            // Generate the function call with correct label name; calls the
+            // type checker resolved to a monomorphized copy go straight to it
+            std::string callLabel = !node.specialization.empty() ? node.specialization
+                                  : node.name == "main" ? "fn_main" : node.name;
             assembly << "    call " << callLabel << "\n";
-            
-            // Set the expression type based on function return type (if known)
-            if (functionReturnTypes.find(node.name) != functionReturnTypes.end()) {
-                lastExprType = functionReturnTypes[node.name];
-                lastExprWasNewHeapObject = false;  // Function returns are existing references
+        }
+    }
+    
+    // Expression a function returns when its whole body is "return <expr>"
+    static Expression* singleReturnExpression(FunctionDeclaration* func) {
+        if (func->isSingleExpression) return func->expression.get();
+        if (func->body.size() != 1) return nullptr;
+        auto ret = dynamic_cast<ReturnStatement*>(func->body[0].get());
+        return ret ? ret->value.get() : nullptr;
+    }
+    
+    // True if every identifier in the expression names one of the parameters
+    static bool usesOnlyParameters(Expression* expr, const std::unordered_set<std::string>& params) {
+        if (!expr) return true;
+        if (auto id = dynamic_cast<Identifier*>(expr)) return params.count(id->name) > 0;
+        if (auto bin = dynamic_cast<BinaryExpression*>(expr)) {
+            return usesOnlyParameters(bin->left.get(), params) && usesOnlyParameters(bin->right.get(), params);
+        }
+        if (auto unary = dynamic_cast<UnaryExpression*>(expr)) return usesOnlyParameters(unary->operand.get(), params);
+        if (auto call = dynamic_cast<FunctionCall*>(expr)) {
+            for (auto& arg : call->arguments) {
+                if (!usesOnlyParameters(arg.get(), params)) return false;
+            }
+            return true;
+        }
+        return dynamic_cast<IntLiteral*>(expr) || dynamic_cast<FloatLiteral*>(expr) ||
+               dynamic_cast<BoolLiteral*>(expr);
+    }
+    
+    // --profile-use: a hot call to a function whose body is a single scalar
+    // "return <expr>" is expanded in place. Arguments go to fresh caller
+    // slots bound to the parameter names, with the parameters' declared
+    // types, so the expression compiles exactly as it does in the callee.
+    // Calls to a monomorphized copy expand the body as typed for that copy.
+    bool tryInlineCall(FunctionCall& node, uint64_t callCount) {
+        const uint64_t HOT_CALL_SITE = 1000;
+        if (callCount < HOT_CALL_SITE || inliningFunctions.count(node.name)) return false;
+        FunctionDeclaration* func = findFunction(node.name);
+        if (!func || func->parameters.size() != node.arguments.size() || func->parameters.size() > 6) {
+            return false;
+        }
+        if (!typeChecker || node.specialization.empty()) {
+            return inlineCall(node, func, callCount);
+        }
+        std::string previous = typeChecker->specialize(*func, node.specialization);
+        bool inlined = inlineCall(node, func, callCount);
+        typeChecker->specialize(*func, previous);
+        return inlined;
+    }
+    
+    bool inlineCall(FunctionCall& node, FunctionDeclaration* func, uint64_t callCount) {
+        Expression* body = singleReturnExpression(func);
+        if (!body) return false;
+        auto returnType = functionReturnTypes.find(returnTypeKey(node));
+        if (returnType != functionReturnTypes.end() &&
+            (isRefCountedType(returnType->second) || returnType->second == "string")) {
+            return false;
+        }
+        std::unordered_set<std::string> params;
+        for (const auto& param : func->parameters) {
+            if (isRefCountedType(param.type.toString()) || param.type.toString() == "string") return false;
+            params.insert(param.name);
+        }
+        ExprKind kind = annotatedKind(body);
+        if (!usesOnlyParameters(body, params) || kind == ExprKind::LIST || kind == ExprKind::DICT ||
+            kind == ExprKind::STRING) {
+            return false;
+        }
+        
+        assembly << "    # Inlined call to " << node.name << " (hot call site: " << callCount << " calls)\n";
+        std::vector<VariableInfo> bindings;
+        for (size_t i = 0; i < node.arguments.size(); i++) {
+            node.arguments[i]->accept(*this);
+            stackOffset += 8;
+            VariableInfo binding;
+            binding.stackOffset = stackOffset;
+            binding.type = func->parameters[i].type.toString();
+            binding.isGlobal = !inFunction;
+            binding.isConstant = false;
+            assembly << "    mov %rax, -" << stackOffset << "(%rbp)  # " << node.name << " parameter "
+                     << func->parameters[i].name << "\n";
+            bindings.push_back(binding);
+        }
+        
+        // Parameters shadow same-named variables of the caller for the expansion
+        auto& scope = inFunction ? localVariables : globalVariables;
+        std::vector<std::pair<std::string, std::unique_ptr<VariableInfo>>> shadowed;
+        for (size_t i = 0; i < func->parameters.size(); i++) {
+            const std::string& name = func->parameters[i].name;
+            auto it = scope.find(name);
+            shadowed.emplace_back(name, it != scope.end() ? std::make_unique<VariableInfo>(it->second) : nullptr);
+            scope[name] = bindings[i];
+        }
+        inliningFunctions.insert(node.name);
+        body->accept(*this);
+        inliningFunctions.erase(node.name);
+        for (auto& entry : shadowed) {
+            if (entry.second) {
+                scope[entry.first] = *entry.second;
+            } else {
+                scope.erase(entry.first);
             }
         }
+        return true;
     }
     
     void visit(BinaryExpression& node) override {
         // Check for list operations first
         if (node.op == BinaryOp::ADD) {
             // Use type inference for robust two-sided validation
-            ExprKind leftKind = inferExprKind(node.left.get());
-            ExprKind rightKind = inferExprKind(node.right.get());
+            ExprKind leftKind = annotatedKind(node.left.get());
+            ExprKind rightKind = annotatedKind(node.right.get());
             
             // If either operand is a list, require both to be lists
             if (leftKind == ExprKind::LIST || rightKind == ExprKind::LIST) {
@@ -1499,8 +1728,8 @@ public:
         
         if (node.op == BinaryOp::MUL) {
             // Use type inference for robust validation
-            ExprKind leftKind = inferExprKind(node.left.get());
-            ExprKind rightKind = inferExprKind(node.right.get());
+            ExprKind leftKind = annotatedKind(node.left.get());
+            ExprKind rightKind = annotatedKind(node.right.get());
             
             // Check for list * int or int * list (valid repetition)
             if (leftKind == ExprKind::LIST && rightKind == ExprKind::INT) {
@@ -1550,8 +1779,8 @@ public:
         }
         
         // Check if both operands are strings for string comparison
-        ExprKind leftKind = inferExprKind(node.left.get());
-        ExprKind rightKind = inferExprKind(node.right.get());
+        ExprKind leftKind = annotatedKind(node.left.get());
+        ExprKind rightKind = annotatedKind(node.right.get());
         bool isStringComparison = (leftKind == ExprKind::STRING && rightKind == ExprKind::STRING);
         
         if (isStringComparison && (node.op == BinaryOp::EQ || node.op == BinaryOp::NE || 
@@ -1570,23 +1799,20 @@ public:
             assembly << "    mov %rax, %rsi  # Second string as second argument\n";
             assembly << "    pop %rdi  # Restore first string\n";
             
+            // Equality compares the stored lengths before any bytes
+            if (node.op == BinaryOp::EQ || node.op == BinaryOp::NE) {
+                assembly << "    call string_equal  # 1 if equal, 0 if not\n";
+                if (node.op == BinaryOp::NE) {
+                    assembly << "    xor $1, %rax\n";
+                }
+                return;
+            }
+            
             // Call strcmp to compare strings
             assembly << "    call strcmp  # Compare strings\n";
             
             // strcmp returns: 0 if equal, <0 if first < second, >0 if first > second
             switch (node.op) {
-                case BinaryOp::EQ:
-                    // Set %rax to 1 if equal (strcmp returned 0), otherwise 0
-                    assembly << "    cmp $0, %eax  # Compare strcmp result with 0\n";
-                    assembly << "    sete %al      # Set %al to 1 if equal, 0 if not\n";
-                    assembly << "    movzx %al, %rax  # Zero-extend to full register\n";
-                    break;
-                case BinaryOp::NE:
-                    // Set %rax to 1 if not equal (strcmp returned non-zero), otherwise 0
-                    assembly << "    cmp $0, %eax  # Compare strcmp result with 0\n";
-                    assembly << "    setne %al     # Set %al to 1 if not equal, 0 if equal\n";
-                    assembly << "    movzx %al, %rax  # Zero-extend to full register\n";
-                    break;
                 case BinaryOp::LT:
                     assembly << "    test %rax, %rax\n";
                     assembly << "    js slt_true_" << labelCounter << "\n";
@@ -1649,7 +1875,7 @@ public:
             } else {
                 assembly << "    cvtsi2sd %rax, %xmm0  # Convert int to float (left)\n";
             }
-            assembly << "    subq $8, %rsp\n";
+            assembly << "    subq $16, %rsp\n";
             assembly << "    movsd %xmm0, (%rsp)  # Save left operand on stack\n";
             
             // Evaluate right operand
@@ -1662,7 +1888,7 @@ public:
             
             // Load left operand back
             assembly << "    movsd (%rsp), %xmm0  # Restore left operand\n";
-            assembly << "    addq $8, %rsp\n";
+            assembly << "    addq $16, %rsp\n";
             
             // Perform floating-point operation
             switch (node.op) {
@@ -1783,13 +2009,16 @@ public:
             // Handle integer arithmetic (original code)
             assembly << "    # Integer binary operation\n";
             
-            // Evaluate left operand
+            // Evaluate left operand; the spill slot is padded to 16 bytes so
+            // calls made while evaluating the right operand see an aligned stack
             node.left->accept(*this);
-            assembly << "    push %rax\n";
+            assembly << "    sub $16, %rsp\n";
+            assembly << "    mov %rax, (%rsp)\n";
             
             // Evaluate right operand
             node.right->accept(*this);
-            assembly << "    pop %rbx\n";
+            assembly << "    mov (%rsp), %rbx\n";
+            assembly << "    add $16, %rsp\n";
             
             // Perform operation
             switch (node.op) {
@@ -1806,13 +2035,13 @@ public:
                 case BinaryOp::DIV:
                     assembly << "    mov %rax, %rcx\n";
                     assembly << "    mov %rbx, %rax\n";
-                    assembly << "    xor %rdx, %rdx\n";
+                    assembly << "    cqo  # Sign-extend dividend into %rdx\n";
                     assembly << "    idiv %rcx\n";
                     break;
                 case BinaryOp::MOD:
                     assembly << "    mov %rax, %rcx\n";
                     assembly << "    mov %rbx, %rax\n";
-                    assembly << "    xor %rdx, %rdx\n";
+                    assembly << "    cqo  # Sign-extend dividend into %rdx\n";
                     assembly << "    idiv %rcx\n";
                     assembly << "    mov %rdx, %rax\n";
                     break;
@@ -1820,7 +2049,7 @@ public:
                     // Integer division (same as DIV for integers)
                     assembly << "    mov %rax, %rcx\n";
                     assembly << "    mov %rbx, %rax\n";
-                    assembly << "    xor %rdx, %rdx\n";
+                    assembly << "    cqo  # Sign-extend dividend into %rdx\n";
                     assembly << "    idiv %rcx\n";
                     break;
                 case BinaryOp::POWER:
@@ -1828,13 +2057,14 @@ public:
                     assembly << "    mov %rbx, %rcx  # base\n";
                     assembly << "    mov %rax, %rdx  # exponent\n";
                     assembly << "    mov $1, %rax    # result = 1\n";
-                    assembly << "power_loop:\n";
+                    assembly << "power_loop_" << labelCounter << ":\n";
                     assembly << "    test %rdx, %rdx\n";
-                    assembly << "    jz power_done\n";
+                    assembly << "    jz power_done_" << labelCounter << "\n";
                     assembly << "    imul %rcx, %rax\n";
                     assembly << "    dec %rdx\n";
-                    assembly << "    jmp power_loop\n";
-                    assembly << "power_done:\n";
+                    assembly << "    jmp power_loop_" << labelCounter << "\n";
+                    assembly << "power_done_" << labelCounter << ":\n";
+                    labelCounter++;
                     break;
                 case BinaryOp::EQ:
                     assembly << "    cmp %rax, %rbx\n";
@@ -1970,6 +2200,141 @@ public:
         assembly << "    mov $str_" << index << ", %rax\n";
     }
     
+    // How an interpolated part is formatted: scalars and strings, UNKNOWN for
+    // anything else
+    static ExprKind interpolatedPartKind(Expression* expr) {
+        ExprKind kind = annotatedKind(expr);
+        if (kind == ExprKind::INT || kind == ExprKind::FLOAT || kind == ExprKind::BOOL || kind == ExprKind::STRING) {
+            return kind;
+        }
+        return ExprKind::UNKNOWN;
+    }
+    
+    // Interpolated string that does not escape: numbers are formatted into
+    // scratch strings and the parts concatenated into a string, all in the
+    // frame, each buffer starting with room for the string header
+    void emitFrameInterpolation(InterpolatedString& node) {
+        int count = static_cast<int>(node.parts.size());
+        int partsBase = allocateFrameObject(count * 8);
+        int capacity = 1;
+        assembly << "    # Interpolated string does not escape: built in the frame\n";
+        for (int i = 0; i < count; i++) {
+            const auto& part = node.parts[i];
+            if (!part.isExpression) {
+                capacity += part.text.size();
+                assembly << "    mov $str_" << addStringLiteral(part.text) << ", %rax\n";
+            } else {
+                Expression* expr = part.expression.get();
+                expr->accept(*this);
+                ExprKind kind = interpolatedPartKind(expr);
+                if (kind == ExprKind::INT) {
+                    int scratch = allocateFrameObject(STRING_HEADER_BYTES + 32);
+                    capacity += 32;
+                    assembly << "    mov %rax, %rsi\n";
+                    assembly << "    lea -" << scratch << "(%rbp), %rdi\n";
+                    assembly << "    call int_to_string_into\n";
+                } else if (kind == ExprKind::FLOAT) {
+                    int scratch = allocateFrameObject(STRING_HEADER_BYTES + 64);
+                    capacity += 64;
+                    assembly << "    movq %rax, %xmm0\n";
+                    assembly << "    lea -" << scratch << "(%rbp), %rdi\n";
+                    assembly << "    call float_to_string_into\n";
+                } else if (kind == ExprKind::BOOL) {
+                    std::string falseLabel = newLabel("bool_false_");
+                    std::string doneLabel = newLabel("bool_done_");
+                    capacity += 5;
+                    emitJumpIfFalse(falseLabel);
+                    assembly << "    mov $str_" << addStringLiteral("True") << ", %rax\n";
+                    assembly << "    jmp " << doneLabel << "\n";
+                    assembly << falseLabel << ":\n";
+                    assembly << "    mov $str_" << addStringLiteral("False") << ", %rax\n";
+                    assembly << doneLabel << ":\n";
+                } else if (kind == ExprKind::STRING) {
+                    capacity += 64;  // Strings of unknown length; longer results go to the heap
+                } else {
+                    emitTypeError(expr->line, "Cannot interpolate a value of unknown type");
+                }
+            }
+            assembly << "    mov %rax, -" << (partsBase - 8 * i) << "(%rbp)  # Part " << i << "\n";
+        }
+        capacity = (capacity + 7) / 8 * 8;
+        int bufferBase = allocateFrameObject(STRING_HEADER_BYTES + capacity);
+        assembly << "    lea -" << bufferBase << "(%rbp), %rdi  # Buffer\n";
+        assembly << "    mov $" << capacity << ", %rsi\n";
+        assembly << "    lea -" << partsBase << "(%rbp), %rdx  # Parts\n";
+        assembly << "    mov $" << count << ", %rcx\n";
+        assembly << "    call string_concat_into\n";
+    }
+    
+    // Interpolated string on the heap: one OrionStringBuilder in the frame,
+    // reserved for the literal text plus an estimate per formatted part, and
+    // every part appended in place
+    void emitBuilderInterpolation(InterpolatedString& node) {
+        int builder = allocateFrameObject(24);  // OrionStringBuilder: data, length, capacity
+        int reserve = 0;
+        for (const auto& part : node.parts) {
+            if (!part.isExpression) {
+                reserve += part.text.size();
+                continue;
+            }
+            switch (interpolatedPartKind(part.expression.get())) {
+                case ExprKind::INT: reserve += 20; break;
+                case ExprKind::FLOAT: reserve += 24; break;
+                case ExprKind::BOOL: reserve += 5; break;
+                default: reserve += 16; break;  // Strings grow the buffer when longer
+            }
+        }
+        assembly << "    # Interpolated string: single-pass builder\n";
+        assembly << "    lea -" << builder << "(%rbp), %rdi  # Builder\n";
+        assembly << "    mov $" << reserve << ", %rsi\n";
+        assembly << "    call string_builder_reserve\n";
+        for (const auto& part : node.parts) {
+            if (!part.isExpression) {
+                assembly << "    mov $str_" << addStringLiteral(part.text) << ", %rsi\n";
+                assembly << "    lea -" << builder << "(%rbp), %rdi\n";
+                assembly << "    call string_builder_append_str\n";
+                continue;
+            }
+            Expression* expr = part.expression.get();
+            expr->accept(*this);
+            switch (interpolatedPartKind(expr)) {
+                case ExprKind::INT:
+                    assembly << "    mov %rax, %rsi\n";
+                    assembly << "    lea -" << builder << "(%rbp), %rdi\n";
+                    assembly << "    call string_builder_append_int\n";
+                    break;
+                case ExprKind::FLOAT:
+                    assembly << "    movq %rax, %xmm0\n";
+                    assembly << "    lea -" << builder << "(%rbp), %rdi\n";
+                    assembly << "    call string_builder_append_float\n";
+                    break;
+                case ExprKind::BOOL: {
+                    std::string falseLabel = newLabel("bool_false_");
+                    std::string doneLabel = newLabel("bool_done_");
+                    emitJumpIfFalse(falseLabel);
+                    assembly << "    mov $str_" << addStringLiteral("True") << ", %rsi\n";
+                    assembly << "    jmp " << doneLabel << "\n";
+                    assembly << falseLabel << ":\n";
+                    assembly << "    mov $str_" << addStringLiteral("False") << ", %rsi\n";
+                    assembly << doneLabel << ":\n";
+                    assembly << "    lea -" << builder << "(%rbp), %rdi\n";
+                    assembly << "    call string_builder_append_str\n";
+                    break;
+                }
+                case ExprKind::UNKNOWN:
+                    emitTypeError(expr->line, "Cannot interpolate a value of unknown type");
+                    break;
+                default:
+                    assembly << "    mov %rax, %rsi\n";
+                    assembly << "    lea -" << builder << "(%rbp), %rdi\n";
+                    assembly << "    call string_builder_append_str\n";
+                    break;
+            }
+        }
+        assembly << "    lea -" << builder << "(%rbp), %rdi\n";
+        assembly << "    call string_builder_finish\n";
+    }
+    
     void visit(InterpolatedString& node) override {
         assembly << "    # Interpolated string - proper implementation\n";
         
@@ -1980,143 +2345,30 @@ public:
             return;
         }
         
+        if (isFrameAllocated(&node)) {
+            emitFrameInterpolation(node);
+            return;
+        }
+        
         if (node.parts.size() == 1) {
             // Single part - handle directly
             const auto& part = node.parts[0];
-            if (part.isExpression) {
-                // Evaluate expression
-                part.expression->accept(*this);
-                
-                // Convert expression result to string based on type
-                if (auto id = dynamic_cast<Identifier*>(part.expression.get())) {
-                    auto varInfo = lookupVariable(id->name);
-                    if (varInfo) {
-                        assembly << "    mov %rax, %rdi  # Expression result as argument\n";
-                        if (varInfo->type == "int") {
-                            assembly << "    call int_to_string  # Convert int to string\n";
-                        } else if (varInfo->type == "float") {
-                            assembly << "    call float_to_string  # Convert float to string\n";
-                        } else if (varInfo->type == "bool") {
-                            assembly << "    call bool_to_string  # Convert bool to string\n";
-                        } else if (varInfo->type == "string") {
-                            assembly << "    call string_to_string  # Copy string\n";
-                        } else {
-                            // Unknown type, treat as string pointer
-                            assembly << "    call string_to_string  # Copy as string\n";
-                        }
-                    } else {
-                        // Variable not found, treat as int by default
-                        assembly << "    mov %rax, %rdi  # Expression result as argument\n";
-                        assembly << "    call int_to_string  # Convert to string\n";
-                    }
-                } else {
-                    // Direct expression (literal)
-                    assembly << "    mov %rax, %rdi  # Expression result as argument\n";
-                    if (dynamic_cast<IntLiteral*>(part.expression.get())) {
-                        assembly << "    call int_to_string  # Convert int literal to string\n";
-                    } else if (dynamic_cast<FloatLiteral*>(part.expression.get())) {
-                        assembly << "    call float_to_string  # Convert float literal to string\n";
-                    } else if (dynamic_cast<BoolLiteral*>(part.expression.get())) {
-                        assembly << "    call bool_to_string  # Convert bool literal to string\n";
-                    } else if (dynamic_cast<StringLiteral*>(part.expression.get())) {
-                        assembly << "    call string_to_string  # Copy string literal\n";
-                    } else {
-                        // Default to int conversion for other expressions
-                        assembly << "    call int_to_string  # Convert expression to string\n";
-                    }
-                }
-            } else {
+            if (!part.isExpression) {
                 // Single text part
                 int textIndex = addStringLiteral(part.text);
                 assembly << "    mov $str_" << textIndex << ", %rax\n";
+                return;
             }
-            return;
-        }
-        
-        // Multiple parts - simplified concatenation approach
-        assembly << "    # Multiple parts - simplified concatenation\n";
-        
-        // For now, let's implement a simpler approach that builds the string incrementally
-        // Start with an empty result string
-        assembly << "    mov $0, %r12  # Initialize result string to null\n";
-        
-        for (size_t i = 0; i < node.parts.size(); i++) {
-            const auto& part = node.parts[i];
-            
-            assembly << "    # Process part " << i << "\n";
-            
-            if (part.isExpression) {
-                assembly << "    # Expression part " << i << "\n";
-                // Evaluate expression
+            if (interpolatedPartKind(part.expression.get()) == ExprKind::STRING) {
+                // A lone string part shares the string itself
                 part.expression->accept(*this);
-                
-                // Convert to string based on type
-                if (auto id = dynamic_cast<Identifier*>(part.expression.get())) {
-                    auto varInfo = lookupVariable(id->name);
-                    if (varInfo) {
-                        assembly << "    mov %rax, %rdi\n";
-                        if (varInfo->type == "int") {
-                            assembly << "    call int_to_string\n";
-                        } else if (varInfo->type == "float") {
-                            assembly << "    call float_to_string\n";
-                        } else if (varInfo->type == "bool") {
-                            assembly << "    call bool_to_string\n";
-                        } else if (varInfo->type == "string") {
-                            assembly << "    call string_to_string\n";
-                        } else {
-                            assembly << "    call string_to_string\n";
-                        }
-                    } else {
-                        assembly << "    mov %rax, %rdi\n";
-                        assembly << "    call int_to_string\n";
-                    }
-                } else {
-                    assembly << "    mov %rax, %rdi\n";
-                    if (dynamic_cast<IntLiteral*>(part.expression.get())) {
-                        assembly << "    call int_to_string\n";
-                    } else if (dynamic_cast<FloatLiteral*>(part.expression.get())) {
-                        assembly << "    call float_to_string\n";
-                    } else if (dynamic_cast<BoolLiteral*>(part.expression.get())) {
-                        assembly << "    call bool_to_string\n";
-                    } else if (dynamic_cast<StringLiteral*>(part.expression.get())) {
-                        assembly << "    call string_to_string\n";
-                    } else {
-                        assembly << "    call int_to_string\n";
-                    }
-                }
-            } else {
-                assembly << "    # Text part " << i << ": \"" << part.text << "\"\n";
-                // Text part - get string literal address
-                int textIndex = addStringLiteral(part.text);
-                assembly << "    mov $str_" << textIndex << ", %rax\n";
                 assembly << "    mov %rax, %rdi\n";
-                assembly << "    call string_to_string  # Copy string literal\n";
-            }
-            
-            // Now %rax contains the current part as a string
-            if (i == 0) {
-                // First part - just store it
-                assembly << "    mov %rax, %r12  # Store first part\n";
-            } else {
-                // Subsequent parts - concatenate with previous result
-                assembly << "    # Concatenate with previous result\n";
-                assembly << "    push %rax  # Save current part\n";
-                assembly << "    sub $16, %rsp  # Allocate space for 2 pointers\n";
-                assembly << "    mov %r12, 0(%rsp)  # Store previous result\n";
-                assembly << "    mov 16(%rsp), %rdi  # Get current part from stack\n";
-                assembly << "    mov %rdi, 8(%rsp)  # Store current part\n";
-                assembly << "    mov %rsp, %rdi  # Array of 2 string pointers\n";
-                assembly << "    mov $2, %rsi  # Number of parts to concatenate\n";
-                assembly << "    call string_concat_parts\n";
-                assembly << "    add $16, %rsp  # Clean up array space\n";
-                assembly << "    add $8, %rsp  # Clean up saved part\n";
-                assembly << "    mov %rax, %r12  # Store new result\n";
+                assembly << "    call string_to_string\n";
+                return;
             }
         }
         
-        // Final result is in %r12
-        assembly << "    mov %r12, %rax  # Move result to return register\n";
-        assembly << "    # Multiple parts concatenation complete\n";
+        emitBuilderInterpolation(node);
     }
     
     void visit(Identifier& node) override {
@@ -2124,7 +2376,6 @@ public:
         VariableInfo* varInfo = lookupVariable(node.name);
         if (varInfo != nullptr) {
             assembly << "    mov -" << varInfo->stackOffset << "(%rbp), %rax  # load " << (varInfo->isGlobal ? "global" : "local") << " " << node.name << "\n";
-            lastExprWasNewHeapObject = false;  // Loading existing reference
         } else {
             std::string errorMsg = "Error: Undefined variable '" + node.name + "'";
             if (node.line > 0) {
@@ -2223,8 +2474,10 @@ public:
         // Value is now in %rax - no need to push/pop, just assign directly to each variable
         
         // Determine variable type from the value expression
-        std::string varType = "unknown";
-        if (auto intLit = dynamic_cast<IntLiteral*>(node.value.get())) {
+        std::string varType = typeName(node.value->inferredType);
+        if (!varType.empty()) {
+            // Resolved by the TypeChecker
+        } else if (auto intLit = dynamic_cast<IntLiteral*>(node.value.get())) {
             varType = "int";
         } else if (auto strLit = dynamic_cast<StringLiteral*>(node.value.get())) {
             varType = "string";
@@ -2272,11 +2525,17 @@ public:
                     break;
             }
         }
+        if (varType.empty()) {
+            varType = "unknown";
+        }
         
-        // Assign the same value to ALL variables in the chain
+        // Assign the same value to ALL variables in the chain; each holds its own
+        // reference, the first taking over the one a fresh object comes with
+        bool owned = producesOwnedReference(node.value.get());
         for (const std::string& varName : node.variables) {
             // Find or create variable - use setVariable for consistency
-            setVariable(varName, "%rax");
+            setVariable(varName, "%rax", isRefCountedType(varType) ? varType : "unknown", owned);
+            owned = false;
             
             // Update type information for existing variable
             VariableInfo* varInfo = lookupVariable(varName);
@@ -2293,20 +2552,49 @@ public:
         
         // Evaluate the list expression
         node.object->accept(*this);
-        assembly << "    mov %rax, %r12  # Save list pointer in %r12\n";
+        assembly << "    push %rax  # Save container pointer\n";
         
-        // Evaluate the index expression
+        // Evaluate the index expression; a dict keeps the key
         node.index->accept(*this);
-        assembly << "    mov %rax, %r13  # Save index in %r13\n";
+        if (annotatedKind(node.object.get()) == ExprKind::DICT) emitRetainStoredValue(node.index.get());
+        assembly << "    push %rax  # Save index\n";
         
         // Evaluate the value expression  
         node.value->accept(*this);
+        
+        // Values of a typed list's element type go through its typed entry point
+        std::string suffix = typedListSuffix(node.object.get());
+        ExprKind valueKind = annotatedKind(node.value.get());
+        if ((suffix == "_int" && valueKind == ExprKind::INT) ||
+            (suffix == "_float" && (valueKind == ExprKind::FLOAT || valueKind == ExprKind::INT)) ||
+            (suffix == "_bool" && valueKind == ExprKind::BOOL)) {
+            if (suffix == "_bool") emitTruthValue();
+            if (suffix == "_float" && valueKind == ExprKind::INT) {
+                assembly << "    cvtsi2sd %rax, %xmm0  # Int value converted for float list\n";
+            } else if (suffix == "_float") {
+                assembly << "    movq %rax, %xmm0  # Float value argument\n";
+            } else {
+                assembly << "    mov %rax, %rdx  # Value in %rdx (third argument)\n";
+            }
+            assembly << "    pop %rsi  # Index as second argument\n";
+            assembly << "    pop %rdi  # List pointer as first argument\n";
+            assembly << "    call list_set" << suffix << "  # Set element of typed list\n";
+            return;
+        }
+        emitRetainStoredValue(node.value.get());
         assembly << "    mov %rax, %rdx  # Value in %rdx (third argument)\n";
+        assembly << "    pop %rsi  # Index as second argument\n";
+        assembly << "    pop %rdi  # Container pointer as first argument\n";
         
+        if (annotatedKind(node.object.get()) == ExprKind::DICT) {
+            if (annotatedKind(node.index.get()) == ExprKind::STRING) {
+                assembly << "    call dict_set_str  # Set dict[key] = value, key compared by content\n";
+            } else {
+                assembly << "    call dict_set  # Set dict[key] = value\n";
+            }
+            return;
+        }
         // Call list_set(list, index, value)
-        assembly << "    mov %r12, %rdi  # List pointer as first argument\n";
-        assembly << "    mov %r13, %rsi  # Index as second argument\n";
-        assembly << "    # Value already in %rdx as third argument\n";
         assembly << "    call list_set  # Set list[index] = value\n";
     }
 
@@ -2346,70 +2634,226 @@ public:
             case UnaryOp::MINUS:
                 // Unary minus - negate the operand
                 node.operand->accept(*this);
-                assembly << "    neg %rax\n";
+                if (isFloatExpression(node.operand.get())) {
+                    assembly << "    btc $63, %rax  # Flip float sign bit\n";
+                } else {
+                    assembly << "    neg %rax\n";
+                }
                 break;
         }
     }
     void visit(BlockStatement& node) override { 
         for (auto& stmt : node.statements) {
-            stmt->accept(*this);
+            emitStatement(*stmt);
+        }
+    }
+    // Return value ownership transfer:
+    // - New objects: refcount=1, just return (caller takes ownership)
+    // - Local variables: the reference moves to the caller, cleanup skips the slot
+    // - Other existing references: borrowed from a parameter or container, so retain first
+    void emitReturnValue(Expression* value) {
+        value->accept(*this);
+        if (producesOwnedReference(value)) {
+            refCounts.owned++;
+            return;
+        }
+        if (VariableInfo* varInfo = movableVariable(value, true)) {
+            emitMove(static_cast<Identifier*>(value)->name, varInfo);
+            return;
+        }
+        std::string heapType = typeName(value->inferredType);
+        if (isRefCountedType(heapType) && !arena) {
+            assembly << "    # Retaining " << heapType << " return value to survive cleanup\n";
+            assembly << "    push %rax\n";
+            assembly << "    mov %rax, %rdi\n";
+            assembly << "    call " << heapType << "_retain\n";
+            assembly << "    pop %rax\n";
+            refCounts.retains++;
         }
     }
     void visit(ReturnStatement& node) override { 
         if (node.value) {
-            node.value->accept(*this);
-            
-            // Infer and record the function's return type
-            if (!currentFunctionName.empty()) {
-                if (auto id = dynamic_cast<Identifier*>(node.value.get())) {
-                    VariableInfo* varInfo = lookupVariable(id->name);
-                    if (varInfo) {
-                        functionReturnTypes[currentFunctionName] = varInfo->type;
-                    }
-                } else if (dynamic_cast<ListLiteral*>(node.value.get())) {
-                    functionReturnTypes[currentFunctionName] = "list";
-                }
-            }
-            
-            // Return value ownership transfer:
-            // - New objects: refcount=1, just return (caller takes ownership)
-            // - Existing references: will be released by cleanup, so retain first
-            if (!lastExprWasNewHeapObject) {
-                // Check if returning a variable with heap type
-                if (auto id = dynamic_cast<Identifier*>(node.value.get())) {
-                    VariableInfo* varInfo = lookupVariable(id->name);
-                    if (varInfo && (varInfo->type == "list" || varInfo->type == "string" || varInfo->type == "range")) {
-                        assembly << "    # Retaining " << varInfo->type << " return value to survive cleanup\n";
-                        assembly << "    mov %rax, %rdi\n";
-                        
-                        if (varInfo->type == "list") {
-                            assembly << "    call list_retain\n";
-                        } else if (varInfo->type == "string") {
-                            assembly << "    call string_retain\n";
-                        } else if (varInfo->type == "range") {
-                            assembly << "    call range_retain\n";
-                        }
-                    }
-                }
-            }
+            emitReturnValue(node.value.get());
+        }
+        if (!currentReturnLabel.empty()) {
+            assembly << "    jmp " << currentReturnLabel << "  # return\n";
+        }
+    }
+    // A value the TypeChecker could not type is not guessed at: reaching it stops
+    // the program. Generic bodies of monomorphized functions are compiled too,
+    // so this cannot be a compile error
+    void emitTypeError(int line, const std::string& message) {
+        int index = addStringLiteral("Line " + std::to_string(line) + ": " + message);
+        assembly << "    mov $str_" << index << ", %rdi\n";
+        assembly << "    call orion_type_error  # Does not return\n";
+    }
+    
+    // Comparisons yield 0/1 while bool literals are the str_true/str_false
+    // pointers; turns either form in %rax into the pointer
+    void emitBoolToString() {
+        std::string falseLabel = newLabel("bool_false_");
+        std::string doneLabel = newLabel("bool_done_");
+        emitJumpIfFalse(falseLabel);
+        assembly << "    mov $str_true, %rax\n";
+        assembly << "    jmp " << doneLabel << "\n";
+        assembly << falseLabel << ":\n";
+        assembly << "    mov $str_false, %rax\n";
+        assembly << doneLabel << ":\n";
+    }
+    
+    // Turns a condition value in %rax (0/1 or a bool pointer) into 0/1
+    void emitTruthValue() {
+        std::string falseLabel = newLabel("truth_false_");
+        std::string doneLabel = newLabel("truth_done_");
+        emitJumpIfFalse(falseLabel);
+        assembly << "    mov $1, %rax\n";
+        assembly << "    jmp " << doneLabel << "\n";
+        assembly << falseLabel << ":\n";
+        assembly << "    xor %eax, %eax\n";
+        assembly << doneLabel << ":\n";
+    }
+    
+    // Element storage of a list (ORION_ELEM_* in runtime.c). Lists of known
+    // element type get dense storage and typed runtime entry points
+    enum class ListStorage { INT64 = 0, FLOAT = 1, BOOL = 2, INT32 = 3 };
+    
+    // sizeof(OrionList) and sizeof(OrionRange) in runtime.c, for frame allocation
+    static constexpr int FRAME_LIST_HEADER_BYTES = 40;
+    static constexpr int FRAME_RANGE_BYTES = 40;
+    
+    // OrionStringHeader in runtime.c sits just before a string's characters:
+    // refcount, length, capacity, hash
+    static constexpr int STRING_HEADER_BYTES = 32;
+    static constexpr int STRING_LENGTH_OFFSET = 24;  // Length field, counted back from the characters
+    static constexpr long long STRING_STATIC_REFCOUNT = INT64_MAX;  // ORION_FRAME_REFCOUNT
+    
+    // Storage for lists whose elements have this inferred type
+    static ListStorage listStorageFor(const Type& elementType) {
+        switch (annotatedKindOf(elementType)) {
+            case ExprKind::FLOAT: return ListStorage::FLOAT;
+            case ExprKind::BOOL: return ListStorage::BOOL;
+            default: return ListStorage::INT64;
         }
     }
+    
+    // Suffix of the typed runtime entry points (list_get_float, ...) for a list
+    // expression, empty when its element type is unknown
+    static std::string typedListSuffix(Expression* list) {
+        const Type& listType = list->inferredType;
+        if (listType.kind != TypeKind::LIST || !listType.elementType) return "";
+        switch (annotatedKindOf(*listType.elementType)) {
+            case ExprKind::INT: return "_int";
+            case ExprKind::FLOAT: return "_float";
+            case ExprKind::BOOL: return "_bool";
+            default: return "";
+        }
+    }
+    
+    // Branch on a condition value in %rax. Integer comparisons yield 0/1, while
+    // bool values are the str_true/str_false pointers, so both 0 and str_false are false.
+    void emitJumpIfFalse(const std::string& label) {
+        assembly << "    test %rax, %rax\n";
+        assembly << "    jz " << label << "\n";
+        assembly << "    cmp $str_false, %rax\n";
+        assembly << "    je " << label << "\n";
+    }
+    
+    void emitJumpIfTrue(const std::string& label) {
+        std::string skipLabel = newLabel("not_taken_");
+        assembly << "    test %rax, %rax\n";
+        assembly << "    jz " << skipLabel << "\n";
+        assembly << "    cmp $str_false, %rax\n";
+        assembly << "    jne " << label << "\n";
+        assembly << skipLabel << ":\n";
+    }
+    
+    // --profile-generate: bump a named counter (flags are dead at block starts)
+    void emitProfileCounter(const std::string& key) {
+        if (!pgoGenerate) return;
+        size_t index = pgoCounterNames.size();
+        pgoCounterNames.push_back(key);
+        assembly << "    incq pgo_counters+" << index * 8 << "(%rip)  # " << key << "\n";
+    }
+    
+    uint64_t profileCount(const std::string& key) const {
+        return pgoProfile ? pgoProfile->count(key) : 0;
+    }
+    
+    // An arm is cold when the other one ran at least 16 times as often
+    static bool isColdPath(uint64_t count, uint64_t otherCount) {
+        return otherCount >= 64 && count * 16 <= otherCount;
+    }
+    
+    // Loops that run many iterations per entry are rotated so that each
+    // iteration takes a single conditional branch at the bottom
+    bool isHotLoop(int line, int column) const {
+        uint64_t entries = profileCount(ProfileData::loopKey(line, column, "entry"));
+        uint64_t iterations = profileCount(ProfileData::loopKey(line, column, "body"));
+        return iterations >= 64 && iterations >= entries * 4;
+    }
+    
+    // Generate a subtree into its own buffer instead of the current position
+    template <typename Generate>
+    std::string captureAssembly(Generate generate) {
+        std::string saved = assembly.str();
+        assembly.str("");
+        assembly.clear();
+        generate();
+        std::string captured = assembly.str();
+        assembly.str(saved);
+        assembly.seekp(0, std::ios::end);
+        return captured;
+    }
+    
     void visit(IfStatement& node) override {
         std::string elseLabel = "else_" + std::to_string(labelCounter);
         std::string endLabel = "end_if_" + std::to_string(labelCounter);
         labelCounter++;
         
+        std::string thenKey = ProfileData::branchKey(node.line, node.column, "then");
+        std::string elseKey = ProfileData::branchKey(node.line, node.column, "else");
+        uint64_t thenCount = profileCount(thenKey);
+        uint64_t elseCount = profileCount(elseKey);
+        
         // Evaluate condition
         node.condition->accept(*this);
-        assembly << "    test %rax, %rax\n";
-        assembly << "    jz " << elseLabel << "\n";
+        
+        if (isColdPath(thenCount, elseCount)) {
+            // Rarely taken then branch: fall through into the else path and
+            // move the then block out of line
+            std::string coldLabel = "then_cold_" + std::to_string(labelCounter++);
+            emitJumpIfTrue(coldLabel);
+            if (node.elseBranch) {
+                node.elseBranch->accept(*this);
+            }
+            assembly << endLabel << ":\n";
+            std::string coldCode = captureAssembly([&] { node.thenBranch->accept(*this); });
+            coldAsm << coldLabel << ":  # then branch ran " << thenCount << " of "
+                    << thenCount + elseCount << " times\n" << coldCode;
+            coldAsm << "    jmp " << endLabel << "\n";
+            return;
+        }
+        
+        emitJumpIfFalse(elseLabel);
         
         // Then branch
+        emitProfileCounter(thenKey);
         node.thenBranch->accept(*this);
+        
+        if (node.elseBranch && isColdPath(elseCount, thenCount)) {
+            // Rarely taken else branch: the then path falls straight through
+            assembly << endLabel << ":\n";
+            std::string coldCode = captureAssembly([&] { node.elseBranch->accept(*this); });
+            coldAsm << elseLabel << ":  # else branch ran " << elseCount << " of "
+                    << thenCount + elseCount << " times\n" << coldCode;
+            coldAsm << "    jmp " << endLabel << "\n";
+            return;
+        }
         assembly << "    jmp " << endLabel << "\n";
         
         // Else branch
         assembly << elseLabel << ":\n";
+        emitProfileCounter(elseKey);
         if (node.elseBranch) {
             node.elseBranch->accept(*this);
         }
@@ -2425,15 +2869,32 @@ public:
         breakLabels.push(endLabel);
         continueLabels.push(loopLabel);
         
+        emitProfileCounter(ProfileData::loopKey(node.line, node.column, "entry"));
+        
+        if (isHotLoop(node.line, node.column)) {
+            // Rotated loop: test at the bottom, entered through the test
+            std::string bodyLabel = "loop_body_" + std::to_string(labelCounter++);
+            assembly << "    jmp " << loopLabel << "  # Hot loop (profile): condition at the bottom\n";
+            assembly << bodyLabel << ":\n";
+            node.body->accept(*this);
+            assembly << loopLabel << ":\n";
+            node.condition->accept(*this);
+            emitJumpIfTrue(bodyLabel);
+            assembly << endLabel << ":\n";
+            breakLabels.pop();
+            continueLabels.pop();
+            return;
+        }
+        
         // Loop start
         assembly << loopLabel << ":\n";
         
         // Evaluate condition
         node.condition->accept(*this);
-        assembly << "    test %rax, %rax\n";
-        assembly << "    jz " << endLabel << "\n";
+        emitJumpIfFalse(endLabel);
         
         // Loop body
+        emitProfileCounter(ProfileData::loopKey(node.line, node.column, "body"));
         node.body->accept(*this);
         
         // Jump back to condition check
@@ -2449,115 +2910,225 @@ public:
     
     // ForStatement removed - only ForInStatement is supported
     
+    // Runtime iterator kinds (ORION_ITER_* in runtime.c)
+    enum IteratorKind { ITER_LIST = 0, ITER_RANGE = 1, ITER_STRING = 2, ITER_DICT_KEYS = 3, ITER_DICT_VALUES = 4, ITER_DICT_ITEMS = 5 };
+    
+    // Iterables walked through the runtime iterator protocol: dicts and their
+    // keys()/values()/items() views, and strings. Sets the iterator kind and
+    // returns the object to iterate; null for everything else, which is
+    // opened into an index loop.
+    Expression* iteratorSource(ForInStatement& node, IteratorKind& kind) {
+        if (auto call = dynamic_cast<FunctionCall*>(node.iterable.get())) {
+            if (call->arguments.size() == 1 && (call->name == "keys" || call->name == "values" || call->name == "items")) {
+                kind = call->name == "keys" ? ITER_DICT_KEYS : call->name == "values" ? ITER_DICT_VALUES : ITER_DICT_ITEMS;
+                return call->arguments[0].get();
+            }
+        }
+        switch (annotatedKind(node.iterable.get())) {
+            case ExprKind::DICT: kind = ITER_DICT_KEYS; return node.iterable.get();
+            case ExprKind::STRING: kind = ITER_STRING; return node.iterable.get();
+            default: return nullptr;
+        }
+    }
+    
+    // For-in through an OrionIter kept in hidden stack slots: iter_init once,
+    // then iter_next per element. For dicts iter_next fails if a key is added
+    // or removed while the loop runs
+    void emitIteratorForIn(ForInStatement& node, Expression* source, IteratorKind kind) {
+        std::string loopLabel = "forin_loop_" + std::to_string(labelCounter);
+        std::string endLabel = "forin_end_" + std::to_string(labelCounter);
+        labelCounter++;
+        breakLabels.push(endLabel);
+        continueLabels.push(loopLabel);
+        
+        stackOffset += 48;
+        int iterSlot = stackOffset;  // OrionIter: kind, source, position, limit, value, second
+        
+        assembly << "    # For-in loop through runtime iterator (kind " << kind << ")\n";
+        source->accept(*this);
+        assembly << "    lea -" << iterSlot << "(%rbp), %rdi  # Iterator\n";
+        assembly << "    mov $" << kind << ", %rsi  # Iterator kind\n";
+        assembly << "    mov %rax, %rdx  # Iterable\n";
+        assembly << "    call iter_init\n";
+        emitProfileCounter(ProfileData::loopKey(node.line, node.column, "entry"));
+        
+        assembly << loopLabel << ":\n";
+        assembly << "    lea -" << iterSlot << "(%rbp), %rdi  # Iterator\n";
+        assembly << "    call iter_next  # Next element, 0 after the last\n";
+        assembly << "    test %rax, %rax\n";
+        assembly << "    jz " << endLabel << "\n";
+        emitProfileCounter(ProfileData::loopKey(node.line, node.column, "body"));
+        
+        std::string valueType = "string";
+        std::string secondType;
+        if (kind != ITER_STRING) {
+            const Type& dictType = source->inferredType;
+            std::string keyType = dictType.keyType ? typeName(*dictType.keyType) : "";
+            secondType = dictType.elementType ? typeName(*dictType.elementType) : "";
+            if (keyType.empty()) keyType = "unknown";
+            if (secondType.empty()) secondType = "unknown";
+            valueType = kind == ITER_DICT_VALUES ? secondType : keyType;
+        }
+        assembly << "    mov -" << (iterSlot - 32) << "(%rbp), %rax  # Current element\n";
+        setVariable(node.variable, "%rax", valueType);
+        if (kind == ITER_DICT_ITEMS) {
+            assembly << "    mov -" << (iterSlot - 40) << "(%rbp), %rax  # Current dict value\n";
+            setVariable(node.valueVariable, "%rax", secondType);
+        }
+        
+        node.body->accept(*this);
+        assembly << "    jmp " << loopLabel << "\n";
+        assembly << endLabel << ":\n";
+        
+        breakLabels.pop();
+        continueLabels.pop();
+    }
+    
+    // Loads list[index] for a for-in loop over a list: list pointer in %rcx,
+    // index in %rax, element left in %rax. Typed lists go through their typed
+    // entry point; generic storage is read inline, with list_get for the rest
+    void emitListForInElement(Expression* list) {
+        std::string suffix = typedListSuffix(list);
+        if (!suffix.empty()) {
+            assembly << "    mov %rcx, %rdi  # List pointer\n";
+            assembly << "    mov %rax, %rsi  # Index\n";
+            assembly << "    call list_get" << suffix << "  # Element of typed list\n";
+            if (suffix == "_float") {
+                assembly << "    movq %xmm0, %rax  # Float element\n";
+            }
+            return;
+        }
+        std::string slowLabel = "forin_elem_slow_" + std::to_string(labelCounter);
+        std::string doneLabel = "forin_elem_done_" + std::to_string(labelCounter);
+        labelCounter++;
+        // OrionList: data at 24, kind at 32 (ORION_ELEM_INT64 = 0)
+        assembly << "    cmpq $0, 32(%rcx)  # Generic 8-byte storage?\n";
+        assembly << "    jne " << slowLabel << "\n";
+        assembly << "    mov 24(%rcx), %rdx  # Element array\n";
+        assembly << "    mov (%rdx,%rax,8), %rax  # Element\n";
+        assembly << "    jmp " << doneLabel << "\n";
+        assembly << slowLabel << ":\n";
+        assembly << "    mov %rcx, %rdi  # List pointer\n";
+        assembly << "    mov %rax, %rsi  # Index\n";
+        assembly << "    call list_get  # Element of specialized storage\n";
+        assembly << doneLabel << ":\n";
+    }
+    
     void visit(ForInStatement& node) override {
+        IteratorKind iteratorKind;
+        if (Expression* source = iteratorSource(node, iteratorKind)) {
+            emitIteratorForIn(node, source, iteratorKind);
+            return;
+        }
+        
+        // Lists and ranges are opened into index loops. Objects carry no tag
+        // the runtime could pick an iterator kind from, so an iterable of
+        // unknown type stops the program
+        ExprKind iterableKind = annotatedKind(node.iterable.get());
+        if (iterableKind != ExprKind::LIST && iterableKind != ExprKind::RANGE) {
+            node.iterable->accept(*this);
+            emitTypeError(node.line, "Cannot iterate over a value of unknown type");
+            return;
+        }
+        bool isRange = iterableKind == ExprKind::RANGE;
+        
         std::string loopLabel = "forin_loop_" + std::to_string(labelCounter);
+        std::string continueLabel = "forin_next_" + std::to_string(labelCounter);
         std::string endLabel = "forin_end_" + std::to_string(labelCounter);
-        std::string isRangeLabel = "forin_is_range_" + std::to_string(labelCounter);
-        std::string isListLabel = "forin_is_list_" + std::to_string(labelCounter);
         labelCounter++;
         
         // Store current loop labels for break/continue
         breakLabels.push(endLabel);
-        continueLabels.push(loopLabel);
+        continueLabels.push(continueLabel);
+        
+        // Loop state lives in hidden stack slots rather than registers so that
+        // nested loops and calls in the body cannot clobber it
+        stackOffset += 8;
+        int iterableSlot = stackOffset;
+        stackOffset += 8;
+        int indexSlot = stackOffset;
+        stackOffset += 8;
+        int lengthSlot = stackOffset;
         
-        // Evaluate iterable (can be a list or range)
         node.iterable->accept(*this);
-        assembly << "    mov %rax, %r12  # Store iterable pointer\n";
-        assembly << "    mov $0, %r13    # Initialize index\n";
-        
-        // Check if iterable is a range or list by checking if it's a result of range() call
-        // We'll use a simple heuristic: check if the iterable is a FunctionCall with name "range"
-        if (auto funcCall = dynamic_cast<FunctionCall*>(node.iterable.get())) {
-            if (funcCall->name == "range") {
-                // This is a range object
-                assembly << "    # For-in loop over range object\n";
-                
-                // Get range length
-                assembly << "    mov %r12, %rdi  # Range pointer\n";
-                assembly << "    call range_len  # Get range length\n";
-                assembly << "    mov %rax, %r14  # Store range length\n";
-                
-                // Loop start
-                assembly << loopLabel << ":\n";
-                
-                // Check if index < length
-                assembly << "    cmp %r14, %r13\n";
-                assembly << "    jge " << endLabel << "\n";
-                
-                // Store current index in loop variable (for C-style iteration)
-                assembly << "    mov %r13, %rax  # Move index to rax\n";
-                setVariable(node.variable, "%rax", "int");
-                
-                // Execute loop body
-                node.body->accept(*this);
-                
-                // Increment index
-                assembly << "    inc %r13\n";
-                
-                // Jump back to loop condition
-                assembly << "    jmp " << loopLabel << "\n";
-                
-                // Loop end
-                assembly << endLabel << ":\n";
+        assembly << "    mov %rax, -" << iterableSlot << "(%rbp)  # Store iterable pointer\n";
+        assembly << "    movq $0, -" << indexSlot << "(%rbp)  # Initialize index\n";
+        
+        if (isRange) {
+            assembly << "    # For-in loop over range object\n";
+            assembly << "    mov %rax, %rdi  # Range pointer\n";
+            assembly << "    call range_len  # Get range length\n";
+            assembly << "    mov %rax, -" << lengthSlot << "(%rbp)  # Store length\n";
+        } else {
+            assembly << "    # For-in loop over list object\n";
+        }
+        emitProfileCounter(ProfileData::loopKey(node.line, node.column, "entry"));
+        
+        // Index < length. A list's size (offset 8 in OrionList) is read on
+        // every step, so elements appended by the body are visited too
+        auto emitBoundsCheck = [&](const std::string& jump, const std::string& target) {
+            assembly << "    mov -" << indexSlot << "(%rbp), %rax\n";
+            if (isRange) {
+                assembly << "    cmp -" << lengthSlot << "(%rbp), %rax\n";
             } else {
-                // Default to list behavior for other function calls
-                assembly << "    # For-in loop over list object\n";
-                
-                // Get list length (size is at offset 8 in OrionList struct)
-                assembly << "    mov 8(%r12), %r14  # Load list length\n";
-                
-                // Loop start
-                assembly << loopLabel << ":\n";
-                
-                // Check if index < length
-                assembly << "    cmp %r14, %r13\n";
-                assembly << "    jge " << endLabel << "\n";
-                
-                // Store current index in loop variable (for C-style iteration with list[i])
-                assembly << "    mov %r13, %rax  # Move index to rax\n";
-                setVariable(node.variable, "%rax", "int");
-                
-                // Execute loop body
-                node.body->accept(*this);
-                
-                // Increment index
-                assembly << "    inc %r13\n";
-                
-                // Jump back to loop condition
-                assembly << "    jmp " << loopLabel << "\n";
-                
-                // Loop end
-                assembly << endLabel << ":\n";
+                assembly << "    mov -" << iterableSlot << "(%rbp), %rcx  # List pointer\n";
+                assembly << "    cmp 8(%rcx), %rax  # Against current list length\n";
             }
+            assembly << "    " << jump << " " << target << "\n";
+        };
+        
+        // Hot loops are rotated: the bounds check sits at the bottom and
+        // branches back to the body, so each iteration takes one branch
+        bool rotate = isHotLoop(node.line, node.column);
+        std::string checkLabel = "forin_check_" + std::to_string(labelCounter++);
+        if (rotate) {
+            assembly << "    jmp " << checkLabel << "  # Hot loop (profile): bounds check at the bottom\n";
+            assembly << loopLabel << ":\n";
+            assembly << "    mov -" << indexSlot << "(%rbp), %rax\n";
         } else {
-            // Default to list behavior for non-function call iterables
-            assembly << "    # For-in loop over list object (default)\n";
-            
-            // Get list length (size is at offset 8 in OrionList struct)
-            assembly << "    mov 8(%r12), %r14  # Load list length\n";
-            
             // Loop start
             assembly << loopLabel << ":\n";
-            
-            // Check if index < length
-            assembly << "    cmp %r14, %r13\n";
-            assembly << "    jge " << endLabel << "\n";
-            
-            // Store current index in loop variable (for C-style iteration with list[i])
-            assembly << "    mov %r13, %rax  # Move index to rax\n";
+            emitBoundsCheck("jge", endLabel);
+            emitProfileCounter(ProfileData::loopKey(node.line, node.column, "body"));
+            assembly << "    mov -" << indexSlot << "(%rbp), %rax\n";
+        }
+        
+        if (isRange) {
+            // Range element: start + index * step (OrionRange: start at 8, step at 24)
+            assembly << "    mov -" << iterableSlot << "(%rbp), %rcx  # Range pointer\n";
+            assembly << "    imul 24(%rcx), %rax  # index * step\n";
+            assembly << "    add 8(%rcx), %rax  # + start\n";
             setVariable(node.variable, "%rax", "int");
-            
-            // Execute loop body
-            node.body->accept(*this);
-            
-            // Increment index
-            assembly << "    inc %r13\n";
-            
-            // Jump back to loop condition
+        } else {
+            assembly << "    mov -" << iterableSlot << "(%rbp), %rcx  # List pointer\n";
+            emitListForInElement(node.iterable.get());
+            const Type& listType = node.iterable->inferredType;
+            std::string elementType = listType.kind == TypeKind::LIST && listType.elementType ? typeName(*listType.elementType) : "";
+            setVariable(node.variable, "%rax", elementType.empty() ? "unknown" : elementType);
+        }
+        
+        // Execute loop body
+        node.body->accept(*this);
+        
+        // Increment index and jump back to loop condition
+        assembly << continueLabel << ":\n";
+        assembly << "    incq -" << indexSlot << "(%rbp)\n";
+        if (rotate) {
+            assembly << checkLabel << ":\n";
+            emitBoundsCheck("jl", loopLabel);
+        } else {
             assembly << "    jmp " << loopLabel << "\n";
-            
-            // Loop end
-            assembly << endLabel << ":\n";
+        }
+        
+        // Loop end
+        assembly << endLabel << ":\n";
+        // A range or list nobody else holds was the loop's to release: a new
+        // one, or one a function handed over on return
+        if (producesOwnedReference(node.iterable.get()) && !isFrameAllocated(node.iterable.get()) && !arena) {
+            std::string type = isRange ? "range" : "list";
+            assembly << "    mov -" << iterableSlot << "(%rbp), %rdi\n";
+            assembly << "    call " << type << "_release  # Release temporary " << type << "\n";
+            refCounts.releases++;
         }
         
         // Restore previous loop labels
@@ -2600,11 +3171,45 @@ public:
     void visit(ListLiteral& node) override {
         assembly << "    # Enhanced list literal with " << node.elements.size() << " elements\n";
         
+        // Dense storage when the element type is known. Int literals (32-bit in
+        // the lexer) get int32 storage; the runtime widens the list if a larger
+        // value is stored later
+        const Type* elementType = node.inferredType.elementType.get();
+        ListStorage storage = elementType ? listStorageFor(*elementType) : ListStorage::INT64;
+        if (elementType && annotatedKindOf(*elementType) == ExprKind::INT) {
+            bool literals = true;
+            for (auto& element : node.elements) {
+                Expression* value = element.get();
+                auto unary = dynamic_cast<UnaryExpression*>(value);
+                if (unary && unary->op == UnaryOp::MINUS) value = unary->operand.get();
+                literals = literals && dynamic_cast<IntLiteral*>(value);
+            }
+            if (literals) storage = ListStorage::INT32;
+        }
+        
+        if (isFrameAllocated(&node)) {
+            // Header and elements in the stack frame: the values are written
+            // in place and the runtime narrows them to the list's storage
+            int capacity = std::max<int>(node.elements.size(), 4);
+            int base = allocateFrameObject(FRAME_LIST_HEADER_BYTES + capacity * 8);
+            assembly << "    # List does not escape: " << capacity << " elements in the frame at -" << base << "(%rbp)\n";
+            for (size_t i = 0; i < node.elements.size(); i++) {
+                node.elements[i]->accept(*this);
+                emitRetainStoredValue(node.elements[i].get());
+                assembly << "    movq %rax, -" << (base - FRAME_LIST_HEADER_BYTES - 8 * static_cast<int>(i)) << "(%rbp)  # Element " << i << "\n";
+            }
+            assembly << "    lea -" << base << "(%rbp), %rdi  # List header\n";
+            assembly << "    mov $" << capacity << ", %rsi  # Capacity\n";
+            assembly << "    mov $" << node.elements.size() << ", %rdx  # Element count\n";
+            assembly << "    mov $" << static_cast<int>(storage) << ", %rcx  # Element storage\n";
+            assembly << "    call list_init_frame\n";
+            return;
+        }
+        
         if (node.elements.empty()) {
             // Create empty list using runtime
             assembly << "    mov $4, %rdi  # Initial capacity for empty list\n";
             assembly << "    call list_new  # Create new empty list\n";
-            lastExprWasNewHeapObject = true;  // New list created
             return;
         }
         
@@ -2620,6 +3225,7 @@ public:
             assembly << "    # Evaluating element " << i << "\n";
             assembly << "    push %r12  # Save temp array pointer\n";
             node.elements[i]->accept(*this);  // Element value in %rax
+            emitRetainStoredValue(node.elements[i].get());
             assembly << "    pop %r12  # Restore temp array pointer\n";
             assembly << "    movq %rax, " << (i * 8) << "(%r12)  # Store in temp array\n";
         }
@@ -2627,22 +3233,31 @@ public:
         // Create list from temporary data
         assembly << "    mov %r12, %rdi  # Temp array pointer\n";
         assembly << "    mov $" << node.elements.size() << ", %rsi  # Element count\n";
-        assembly << "    call list_from_data  # Create list from data\n";
+        if (storage == ListStorage::INT64) {
+            assembly << "    call list_from_data  # Create list from data\n";
+        } else {
+            assembly << "    mov $" << static_cast<int>(storage) << ", %rdx  # Element storage\n";
+            assembly << "    call list_from_data_kind  # Create typed list from data\n";
+        }
         
         // Free temporary array - list_from_data made a copy
         assembly << "    push %rax  # Save list pointer\n";
         assembly << "    mov %r12, %rdi  # Temp array pointer\n";
         assembly << "    call orion_free  # Free temporary array\n";
         assembly << "    pop %rax  # Restore list pointer\n";
-        lastExprWasNewHeapObject = true;  // New list created
     }
     
     void visit(DictLiteral& node) override {
         assembly << "    # Dictionary literal with " << node.keys.size() << " key-value pairs\n";
         
-        // Create empty dictionary
+        // Create empty dictionary; string keys are hashed and compared by content
+        const Type* keyType = node.inferredType.keyType.get();
         assembly << "    mov $8, %rdi  # Initial capacity for dictionary\n";
-        assembly << "    call dict_new  # Create new dictionary\n";
+        if (keyType && keyType->kind == TypeKind::STRING) {
+            assembly << "    call dict_new_str  # Create new dictionary with string keys\n";
+        } else {
+            assembly << "    call dict_new  # Create new dictionary\n";
+        }
         assembly << "    mov %rax, %r12  # Save dict pointer in %r12\n";
         
         // Add each key-value pair
@@ -2652,6 +3267,7 @@ public:
             // Evaluate key
             assembly << "    push %r12  # Save dict pointer\n";
             node.keys[i]->accept(*this);  // Key value in %rax
+            emitRetainStoredValue(node.keys[i].get());
             assembly << "    mov %rax, %r13  # Save key in %r13\n";
             assembly << "    pop %r12  # Restore dict pointer\n";
             
@@ -2659,6 +3275,7 @@ public:
             assembly << "    push %r12  # Save dict pointer\n";
             assembly << "    push %r13  # Save key\n";
             node.values[i]->accept(*this);  // Value in %rax
+            emitRetainStoredValue(node.values[i].get());
             assembly << "    mov %rax, %r14  # Save value in %r14\n";
             assembly << "    pop %r13  # Restore key\n";
             assembly << "    pop %r12  # Restore dict pointer\n";
@@ -2672,20 +3289,32 @@ public:
         
         // Return dictionary pointer
         assembly << "    mov %r12, %rax  # Dict pointer as result\n";
-        lastExprWasNewHeapObject = true;  // New dictionary created
     }
     
     void visit(IndexExpression& node) override {
         assembly << "    # Enhanced index expression with negative indexing support\n";
         
-        // Evaluate the object (list) - result in %rax
+        // Evaluate the object (list or dict) - result in %rax
         node.object->accept(*this);
-        assembly << "    mov %rax, %rdi  # List pointer as first argument\n";
+        assembly << "    push %rax  # Save container pointer\n";
         
         // Evaluate the index - result in %rax
         node.index->accept(*this);
         assembly << "    mov %rax, %rsi  # Index as second argument\n";
+        assembly << "    pop %rdi  # Container pointer as first argument\n";
         
+        if (annotatedKind(node.object.get()) == ExprKind::DICT) {
+            assembly << "    call dict_get  # Look up key\n";
+            return;
+        }
+        std::string suffix = typedListSuffix(node.object.get());
+        if (!suffix.empty()) {
+            assembly << "    call list_get" << suffix << "  # Get element of typed list\n";
+            if (suffix == "_float") {
+                assembly << "    movq %xmm0, %rax  # Float element\n";
+            }
+            return;
+        }
         // Call runtime function for safe indexing with negative support
         assembly << "    call list_get  # Get element with bounds checking\n";
         // Result is in %rax - no additional handling needed
@@ -2698,14 +3327,164 @@ public:
 
 } // namespace orion
 
+// Command-line options for the compiler driver
+struct DriverOptions {
+    std::string sourceFile;
+    std::string cacheDir;
+    uint64_t cacheMaxBytes = orion::CompileCache::DEFAULT_MAX_BYTES;
+    bool printCacheStats = false;
+    bool noRun = false;          // Stop after linking
+    bool profile = false;        // Instrument user functions with the runtime profiler
+    bool arena = false;          // Bump-allocate from arenas, no reference counting
+    std::string profileGenerate; // --profile-generate output file (empty: off)
+    std::string profileUse;      // --profile-use input file (empty: off)
+    bool timePasses = false;
+    bool refCountReport = false;
+    bool statsJson = false;
+    std::string statsJsonFile;  // Empty: write JSON to stderr
+};
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options] <source-file>" << std::endl;
+    std::cerr << "Options:" << std::endl;
+    std::cerr << "  --cache-dir=DIR         Reuse linked executables stored in DIR" << std::endl;
+    std::cerr << "  --cache-max-size=SIZE   Evict least recently used entries above SIZE (default 256M)" << std::endl;
+    std::cerr << "  --cache-stats           Print cache counters for --cache-dir and exit" << std::endl;
+    std::cerr << "  --no-run                Compile and link only; do not execute the program" << std::endl;
+    std::cerr << "  --profile               Count calls and cycles per function; report at program exit" << std::endl;
+    std::cerr << "  --arena                 Allocate from arenas freed only at exit or arena_reset()" << std::endl;
+    std::cerr << "  --profile-generate[=F]  Record branch, loop and call counts into F (default orion.profdata)" << std::endl;
+    std::cerr << "  --profile-use=FILE      Optimize block layout, loops and inlining with recorded counts" << std::endl;
+    std::cerr << "  --time-passes           Report time, CPU and memory used by each compiler phase" << std::endl;
+    std::cerr << "  --refcount-report       Report retain/release calls emitted and elided per function" << std::endl;
+    std::cerr << "  --stats-json[=FILE]     Write the per-phase report as JSON to FILE (default stderr)" << std::endl;
+}
+
+// Accepts both "--name=value" and "--name value"
+static bool matchOption(const std::string& arg, const std::string& name, int& i, int argc, char* argv[], std::string& value) {
+    if (arg == name) {
+        if (i + 1 >= argc) {
+            throw std::runtime_error("Option " + name + " requires a value");
+        }
+        value = argv[++i];
+        return true;
+    }
+    if (arg.compare(0, name.size() + 1, name + "=") == 0) {
+        value = arg.substr(name.size() + 1);
+        return true;
+    }
+    return false;
+}
+
+static bool parseArguments(int argc, char* argv[], DriverOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        std::string value;
+        if (matchOption(arg, "--cache-dir", i, argc, argv, value)) {
+            options.cacheDir = value;
+        } else if (matchOption(arg, "--cache-max-size", i, argc, argv, value)) {
+            options.cacheMaxBytes = orion::CompileCache::parseSize(value);
+            if (options.cacheMaxBytes == 0) {
+                throw std::runtime_error("Invalid cache size '" + value + "'");
+            }
+        } else if (arg == "--cache-stats") {
+            options.printCacheStats = true;
+        } else if (arg == "--no-run") {
+            options.noRun = true;
+        } else if (arg == "--profile") {
+            options.profile = true;
+        } else if (arg == "--arena") {
+            options.arena = true;
+        } else if (arg == "--profile-generate") {
+            options.profileGenerate = orion::ProfileData::DEFAULT_FILE;
+        } else if (arg.compare(0, 19, "--profile-generate=") == 0) {
+            options.profileGenerate = arg.substr(19);
+        } else if (matchOption(arg, "--profile-use", i, argc, argv, value)) {
+            options.profileUse = value;
+        } else if (arg == "--time-passes") {
+            options.timePasses = true;
+        } else if (arg == "--refcount-report") {
+            options.refCountReport = true;
+        } else if (arg == "--stats-json") {
+            options.statsJson = true;
+        } else if (arg.compare(0, 13, "--stats-json=") == 0) {
+            options.statsJson = true;
+            options.statsJsonFile = arg.substr(13);
+        } else if (!arg.empty() && arg[0] == '-') {
+            throw std::runtime_error("Unknown option '" + arg + "'");
+        } else if (options.sourceFile.empty()) {
+            options.sourceFile = arg;
+        } else {
+            return false;
+        }
+    }
+    if (!options.profileGenerate.empty() && !options.profileUse.empty()) {
+        throw std::runtime_error("--profile-generate and --profile-use cannot be combined");
+    }
+    return !options.sourceFile.empty() || options.printCacheStats;
+}
+
+// Absolute form of a path, so generated programs and tools find it from any
+// directory. Paths that don't exist yet are resolved against the working directory.
+static std::string absolutePath(const std::string& path) {
+    char* resolved = realpath(path.c_str(), nullptr);
+    if (!resolved) {
+        if (path.empty() || path[0] == '/') return path;
+        char* cwd = getcwd(nullptr, 0);
+        if (!cwd) return path;
+        std::string result = std::string(cwd) + "/" + path;
+        free(cwd);
+        return result;
+    }
+    std::string result(resolved);
+    free(resolved);
+    return result;
+}
+
+// Print the --time-passes table and/or the --stats-json document
+static void reportPassStats(const DriverOptions& options, const orion::PassTimer& timer, const std::string& source) {
+    if (options.timePasses) {
+        std::cerr << timer.formatTable();
+    }
+    if (options.statsJson) {
+        size_t lines = std::count(source.begin(), source.end(), '\n');
+        if (!source.empty() && source.back() != '\n') lines++;
+        std::string json = timer.formatJson(options.sourceFile, source.size(), lines);
+        if (options.statsJsonFile.empty()) {
+            std::cerr << json;
+        } else {
+            std::ofstream out(options.statsJsonFile);
+            out << json;
+        }
+    }
+}
+
 // Compiler main function
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " <source-file>" << std::endl;
+    DriverOptions options;
+    try {
+        if (!parseArguments(argc, argv, options)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
         return 1;
     }
     
-    std::string filename = argv[1];
+    orion::CompileCache cache(options.cacheDir, options.cacheMaxBytes);
+    if (options.printCacheStats) {
+        if (!cache.isEnabled()) {
+            std::cerr << "Error: --cache-stats requires a usable --cache-dir" << std::endl;
+            return 1;
+        }
+        std::cout << cache.formatStats();
+        return 0;
+    }
+    
+    std::string filename = options.sourceFile;
+    orion::PassTimer timer;
     
     try {
         // Read source file
@@ -2719,6 +3498,46 @@ int main(int argc, char* argv[]) {
                           std::istreambuf_iterator<char>());
         file.close();
         
+        std::string asmFile = "orion_asm.s";
+        std::string exeFile = "orion_exec";
+        std::string gccCommand = "gcc -no-pie -o " + exeFile + " " + asmFile + " runtime.o -lm";
+        
+        orion::ProfileData profileData;
+        if (!options.profileUse.empty()) {
+            profileData.load(options.profileUse);
+        }
+        
+        // A cached executable for identical inputs skips codegen, assembly and linking
+        std::string cacheKey;
+        if (cache.isEnabled()) {
+            // The source path is part of the key: .file and the line table name it
+            std::string flags = gccCommand + (options.profile ? " --profile" : "") + (options.arena ? " --arena" : "");
+            flags += " --source=" + absolutePath(filename);
+            if (!options.profileGenerate.empty()) {
+                flags += " --profile-generate=" + absolutePath(options.profileGenerate);
+            }
+            if (!options.profileUse.empty()) {
+                flags += " --profile-use\n" + profileData.contents();
+            }
+            cacheKey = cache.computeKey(source, flags, "runtime.o");
+            std::string cachedExe;
+            timer.begin("cache-lookup");
+            bool hit = cache.lookup(cacheKey, cachedExe);
+            timer.end();
+            if (hit) {
+                // orion_exec is the program just compiled, cached or not
+                if (!orion::CompileCache::copyExecutable(cachedExe, exeFile)) {
+                    std::cerr << "Error: Failed to copy cached executable to " << exeFile << std::endl;
+                    return 1;
+                }
+                if (!options.noRun) {
+                    timer.runCommand("run", "./" + exeFile);
+                }
+                reportPassStats(options, timer, source);
+                return 0;
+            }
+        }
+        
         // Split source into lines for error reporting
         std::vector<std::string> sourceLines;
         std::stringstream ss(source);
@@ -2728,38 +3547,79 @@ int main(int argc, char* argv[]) {
         }
         
         // Step 1: Lexical analysis
+        timer.begin("lex");
         orion::Lexer lexer(source);
         auto tokens = lexer.tokenize();
+        timer.end(tokens.size(), "tokens");
         
         // Step 2: Parsing
+        timer.begin("parse");
         orion::SimpleOrionParser parser(tokens);
         auto ast = parser.parse();
+        timer.end();
+        
+        // Step 3: Type inference annotates every expression for codegen
+        timer.begin("typecheck");
+        orion::TypeChecker typeChecker;
+        bool typesOk = typeChecker.check(*ast, sourceLines);
+        timer.end();
+        if (!typesOk) {
+            return 1;
+        }
         
-        // Note: Type checking would be done here for better error messages
-        // but we'll focus on runtime error improvements for now
+        // Step 4: Escape analysis picks the allocations that can live in stack frames
+        timer.begin("escape");
+        orion::EscapeAnalysis escapeAnalysis;
+        escapeAnalysis.analyze(*ast);
+        timer.end(escapeAnalysis.frameAllocations(), "frame allocations");
         
-        // Step 3: Code generation
+        // Step 5: Code generation
+        timer.begin("codegen");
         orion::SimpleCodeGenerator codegen;
+        codegen.setProfiling(options.profile);
+        codegen.setArena(options.arena);
+        codegen.setSourcePath(absolutePath(filename));
+        if (!options.profileGenerate.empty()) {
+            codegen.setProfileGenerate(absolutePath(options.profileGenerate));
+        }
+        if (!options.profileUse.empty()) {
+            codegen.setProfileUse(&profileData);
+        }
+        codegen.setTypeChecker(&typeChecker);
+        codegen.setEscapeAnalysis(&escapeAnalysis);
         std::string assembly = codegen.generate(*ast);
+        timer.end();
+        if (options.refCountReport) {
+            std::cerr << codegen.formatRefCountReport();
+        }
         
-        // Step 4: Write assembly to file (KEEP FOR PROOF)
-        std::string asmFile = "orion_asm.s";
+        // Counting is done outside the timed regions so it doesn't skew them
+        if (options.timePasses || options.statsJson) {
+            timer.setCount("parse", orion::countASTNodes(*ast), "AST nodes");
+            timer.setCount("codegen", orion::countInstructions(assembly), "instructions");
+        }
+        
+        // Step 6: Write assembly to file (KEEP FOR PROOF)
         std::ofstream asmOut(asmFile);
         asmOut << assembly;
         asmOut.close();
         
-        // Step 5: Use GCC to assemble and link with runtime (KEEP EXECUTABLE FOR PROOF)
-        std::string exeFile = "orion_exec";
-        std::string gccCommand = "gcc -no-pie -o " + exeFile + " " + asmFile + " runtime.o -lm";
-        
-        int result = system(gccCommand.c_str());
+        // Step 7: Use GCC to assemble and link with runtime (KEEP EXECUTABLE FOR PROOF)
+        int result = timer.runCommand("assemble+link", gccCommand);
         if (result != 0) {
             std::cerr << "Error: Failed to assemble program" << std::endl;
             return 1;
         }
         
-        // Step 6: Execute the compiled program
-        result = system(("./" + exeFile).c_str());
+        if (cache.isEnabled()) {
+            cache.store(cacheKey, exeFile);
+        }
+        
+        // Step 8: Execute the compiled program
+        if (!options.noRun) {
+            result = timer.runCommand("run", "./" + exeFile);
+        }
+        reportPassStats(options, timer, source);
         
         // DON'T clean up - leave files for proof
         
@@ -2769,4 +3629,4 @@ int main(int argc, char* argv[]) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }
-}
\ No newline at end of file
+}
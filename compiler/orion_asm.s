@@ -2,19 +2,46 @@
 format_int: .string "%d\n"
 format_str: .string "%s"
 format_float: .string "%.2f\n"
+.balign 8
+    .quad 9223372036854775807, 14, 14, 0
 dtype_int: .string "datatype: int\n"
+.balign 8
+    .quad 9223372036854775807, 17, 17, 0
 dtype_string: .string "datatype: string\n"
+.balign 8
+    .quad 9223372036854775807, 15, 15, 0
 dtype_bool: .string "datatype: bool\n"
+.balign 8
+    .quad 9223372036854775807, 16, 16, 0
 dtype_float: .string "datatype: float\n"
+.balign 8
+    .quad 9223372036854775807, 15, 15, 0
 dtype_list: .string "datatype: list\n"
+.balign 8
+    .quad 9223372036854775807, 18, 18, 0
 dtype_unknown: .string "datatype: unknown\n"
+.globl str_true
+.balign 8
+    .quad 9223372036854775807, 5, 5, 0
 str_true: .string "True\n"
+.globl str_false
+.balign 8
+    .quad 9223372036854775807, 6, 6, 0
 str_false: .string "False\n"
 str_index_error: .string "Index Error\n"
-str_0: .string "Hello, Orion World!"
-str_1: .string "Fast as C, readable as Python!"
+.balign 8
+    .quad 9223372036854775807, 1, 1, 0
+str_0: .string "a"
+fn_name_0: .string "<toplevel>"
+.global __orion_symbol_table
+.global __orion_symbol_count
+.balign 8
+__orion_symbol_table:
+    .quad main, .Lorion_end_0, fn_name_0
+__orion_symbol_count: .quad 1
 
 .section .text
+.file 1 "/tmp/tc.or"
 .global main
 .extern printf
 .extern orion_malloc
@@ -25,6 +52,7 @@ str_1: .string "Fast as C, readable as Python!"
 .extern strcmp
 .extern list_new
 .extern list_from_data
+.extern list_from_data_kind
 .extern list_len
 .extern list_get
 .extern list_set
@@ -34,11 +62,24 @@ str_1: .string "Fast as C, readable as Python!"
 .extern list_concat
 .extern list_repeat
 .extern list_extend
+.extern list_get_int
+.extern list_set_int
+.extern list_append_int
+.extern list_get_float
+.extern list_set_float
+.extern list_append_float
+.extern list_get_bool
+.extern list_set_bool
+.extern list_append_bool
 .extern list_retain
 .extern list_release
+.extern list_init_frame
+.extern list_release_frame
 .extern dict_new
+.extern dict_new_str
 .extern dict_get
 .extern dict_set
+.extern dict_set_str
 .extern dict_delete
 .extern dict_contains
 .extern dict_pop
@@ -50,48 +91,105 @@ str_1: .string "Fast as C, readable as Python!"
 .extern dict_update
 .extern dict_retain
 .extern dict_release
+.extern iter_init
+.extern iter_next
 .extern orion_input
 .extern orion_input_prompt
-.extern int_to_string
-.extern float_to_string
-.extern bool_to_string
 .extern string_to_string
-.extern string_concat_parts
+.extern string_builder_reserve
+.extern string_builder_append_str
+.extern string_builder_append_int
+.extern string_builder_append_float
+.extern string_builder_finish
+.extern string_concat_into
+.extern int_to_string_into
+.extern float_to_string_into
 .extern string_retain
 .extern string_release
+.extern string_equal
 .extern print_smart
 .extern detect_type
+.extern range_init
 .extern range_retain
 .extern range_release
+.extern orion_arena_reset
 
-
-fn_main:
+.type main, @function
+main:
+    .cfi_startproc
     push %rbp
+    .cfi_def_cfa_offset 16
+    .cfi_offset %rbp, -16
     mov %rsp, %rbp
-    sub $64, %rsp  # Allocate stack space for local variables
-    # Setting up function parameters for main
-    # Call out() with string
+    .cfi_def_cfa_register %rbp
+    sub $112, %rsp
+    movq $0, -8(%rbp)
+    movq $0, -16(%rbp)
+    movq $0, -24(%rbp)
+    movq $0, -72(%rbp)
+    movq $0, -80(%rbp)
+    movq $0, -112(%rbp)
+    .loc 1 1 1
+    # range() function call
+    mov $3, %rax
+    push %rax
+    mov $1, %rcx  # Step
+    pop %rdx  # Stop
+    xor %esi, %esi  # Start
+    lea -64(%rbp), %rdi  # Range in the frame
+    call range_init
+    mov %rax, -8(%rbp)  # Store iterable pointer
+    movq $0, -16(%rbp)  # Initialize index
+    # For-in loop over range object
+    mov %rax, %rdi  # Range pointer
+    call range_len  # Get range length
+    mov %rax, -24(%rbp)  # Store length
+forin_loop_0:
+    mov -16(%rbp), %rax
+    cmp -24(%rbp), %rax
+    jge forin_end_0
+    mov -16(%rbp), %rax
+    mov -8(%rbp), %rcx  # Range pointer
+    imul 24(%rcx), %rax  # index * step
+    add 8(%rcx), %rax  # + start
+    mov %rax, -72(%rbp)  # i = %rax (type: int)
+    .loc 1 2 5
+    # Variable: x
+    # Interpolated string - proper implementation
+    # Interpolated string: single-pass builder
+    lea -104(%rbp), %rdi  # Builder
+    mov $21, %rsi
+    call string_builder_reserve
     mov $str_0, %rsi
-    mov $format_str, %rdi
-    xor %rax, %rax
-    call printf
+    lea -104(%rbp), %rdi
+    call string_builder_append_str
+    mov -72(%rbp), %rax  # load global i
+    mov %rax, %rsi
+    lea -104(%rbp), %rdi
+    call string_builder_append_int
+    lea -104(%rbp), %rdi
+    call string_builder_finish
+    mov %rax, -80(%rbp)  # store global x
+    .loc 1 3 5
+    mov -80(%rbp), %rax  # load global x
     # Call out() with string
-    mov $str_1, %rsi
+    mov %rax, %rsi
     mov $format_str, %rdi
     xor %rax, %rax
     call printf
-    # Cleanup local variables
-    add $64, %rsp  # Restore stack space
-    pop %rbp
-    ret
-main:
-    push %rbp
-    mov %rsp, %rbp
-    sub $64, %rsp
-    # Function 'main' defined in scope ''
-    # User-defined function call: main
-    call fn_main
+    .loc 1 4 5
+    # Variable: x
+    mov $5, %rax
+    mov %rax, -80(%rbp)  # store global x
+forin_next_0:
+    incq -16(%rbp)
+    jmp forin_loop_0
+forin_end_0:
     mov $0, %rax
-    add $64, %rsp
+    mov %rbp, %rsp
     pop %rbp
+    .cfi_def_cfa %rsp, 8
     ret
+    .cfi_endproc
+.Lorion_end_0:
+.size main, .-main
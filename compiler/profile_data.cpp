@@ -0,0 +1,56 @@
+#include "profile_data.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace orion {
+
+const char* ProfileData::DEFAULT_FILE = "orion.profdata";
+
+namespace {
+
+std::string position(int line, int column) {
+    return std::to_string(line) + ":" + std::to_string(column);
+}
+
+} // namespace
+
+void ProfileData::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        throw std::runtime_error("Could not read profile data '" + path + "'");
+    }
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    text = buffer.str();
+
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        size_t space = line.find(' ');
+        if (space == std::string::npos) continue;
+        uint64_t value = std::strtoull(line.substr(0, space).c_str(), nullptr, 10);
+        counts[line.substr(space + 1)] += value;
+    }
+}
+
+uint64_t ProfileData::count(const std::string& key) const {
+    auto it = counts.find(key);
+    return it == counts.end() ? 0 : it->second;
+}
+
+std::string ProfileData::branchKey(int line, int column, const std::string& arm) {
+    return "if " + position(line, column) + " " + arm;
+}
+
+std::string ProfileData::loopKey(int line, int column, const std::string& what) {
+    return "loop " + position(line, column) + " " + what;
+}
+
+std::string ProfileData::callKey(int line, int column, const std::string& callee) {
+    return "call " + position(line, column) + " " + callee;
+}
+
+} // namespace orion
@@ -0,0 +1,39 @@
+#ifndef PROFILE_DATA_H
+#define PROFILE_DATA_H
+
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+namespace orion {
+
+// Execution counts recorded by a --profile-generate build and read back by
+// --profile-use. The file is plain text, one "<count> <key>" pair per line,
+// written by the runtime at exit; repeated runs add to the existing counts.
+// Keys name a source construct by position, so edits elsewhere in the file
+// keep the rest of the profile usable.
+class ProfileData {
+public:
+    static const char* DEFAULT_FILE;
+
+    // Throws std::runtime_error if the file cannot be read
+    void load(const std::string& path);
+
+    bool empty() const { return counts.empty(); }
+    uint64_t count(const std::string& key) const;
+
+    // Raw file contents, part of the compile cache key
+    const std::string& contents() const { return text; }
+
+    static std::string branchKey(int line, int column, const std::string& arm);
+    static std::string loopKey(int line, int column, const std::string& what);
+    static std::string callKey(int line, int column, const std::string& callee);
+
+private:
+    std::unordered_map<std::string, uint64_t> counts;
+    std::string text;
+};
+
+} // namespace orion
+
+#endif // PROFILE_DATA_H
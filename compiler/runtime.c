@@ -1,35 +1,443 @@
+#define _GNU_SOURCE  // clock_gettime, sigaction and REG_RIP under -std=c99
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <errno.h>
-
-// Orion-specific memory allocation wrappers to avoid symbol collision
-void* orion_malloc(size_t size) {
+#include <time.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include <sys/mman.h>
+#include <emmintrin.h>  // SSE2 group probing in OrionDict
+
+// Orion-specific memory allocation wrappers to avoid symbol collision.
+//
+// runtime.o serves them from a size-class pool; runtime_malloc.o is the same
+// runtime built with -DORION_SYSTEM_MALLOC, passing them straight to glibc.
+// Linking a program against one or the other selects the heap allocator.
+// Programs compiled with --arena use neither once they start (see below).
+#ifdef ORION_SYSTEM_MALLOC
+
+static void* heap_malloc(size_t size) {
     return malloc(size);
 }
 
-void orion_free(void* ptr) {
+static void heap_free(void* ptr) {
     free(ptr);
 }
 
-void* orion_realloc(void* ptr, size_t size) {
+static void* heap_realloc(void* ptr, size_t size) {
     return realloc(ptr, size);
 }
 
-// Enhanced list structure for dynamic operations with reference counting
+#else
+
+// Blocks up to POOL_MAX_SIZE bytes are carved from 64 KB slabs, each holding
+// blocks of a single size class. The slabs come from one reserved address
+// range, so a pointer inside it is a pool block whose class is in the header
+// of its slab; anything else came from malloc. Freed blocks go on per-thread
+// free lists and are handed out again before new blocks are carved, so the
+// fixed-size object headers (OrionList and OrionRange: 48-byte class,
+// OrionDict: 96, OrionString: 16) are recycled without a trip to glibc.
+// Pool memory is never returned to the system.
+#define POOL_SLAB_SIZE ((size_t)64 * 1024)
+#define POOL_REGION_SIZE ((size_t)4 << 30)  // Address space only; pages are committed on first use
+#define POOL_MAX_SIZE 2048
+#define POOL_CLASSES 28
+#define POOL_SLAB_HEADER 16  // Keeps blocks 16-byte aligned, like malloc
+
+// 16-byte steps up to 256, then four steps per doubling up to POOL_MAX_SIZE
+static const uint32_t pool_class_size[POOL_CLASSES] = {
+    16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240, 256,
+    320, 384, 448, 512, 640, 768, 896, 1024, 1280, 1536, 1792, 2048
+};
+
+typedef struct {
+    uint32_t size_class;
+} PoolSlab;
+
+typedef struct PoolBlock {
+    struct PoolBlock* next;
+} PoolBlock;
+
+// Per-thread state of one size class: recycled blocks, then the unused tail of the current slab
+typedef struct {
+    PoolBlock* free_list;
+    char* bump;
+    char* end;
+} PoolCache;
+
+static char* pool_region_base = NULL;  // Slab-aligned start of the reserved range
+static char* pool_region_end = NULL;
+static size_t pool_region_next = 0;    // Offset of the next unused slab
+static int pool_region_state = 0;      // 0: not reserved yet, 1: reserved, -1: reservation failed
+static __thread PoolCache pool_cache[POOL_CLASSES];
+
+static int pool_class_of(size_t size) {
+    if (size <= 256) return size == 0 ? 0 : (int)((size + 15) / 16) - 1;
+    if (size <= 512) return 16 + (int)((size - 256 + 63) / 64) - 1;
+    if (size <= 1024) return 20 + (int)((size - 512 + 127) / 128) - 1;
+    return 24 + (int)((size - 1024 + 255) / 256) - 1;
+}
+
+// Reserves the slab range on first use
+static int pool_reserve_region(void) {
+    static int lock = 0;
+    int state = __atomic_load_n(&pool_region_state, __ATOMIC_ACQUIRE);
+    if (state != 0) return state;
+    while (__atomic_exchange_n(&lock, 1, __ATOMIC_ACQUIRE)) {}
+    if (pool_region_state == 0) {
+        char* mapped = (char*)mmap(NULL, POOL_REGION_SIZE + POOL_SLAB_SIZE, PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (mapped == MAP_FAILED) {
+            __atomic_store_n(&pool_region_state, -1, __ATOMIC_RELEASE);
+        } else {
+            uintptr_t aligned = ((uintptr_t)mapped + POOL_SLAB_SIZE - 1) & ~(uintptr_t)(POOL_SLAB_SIZE - 1);
+            pool_region_base = (char*)aligned;
+            pool_region_end = pool_region_base + POOL_REGION_SIZE;
+            __atomic_store_n(&pool_region_state, 1, __ATOMIC_RELEASE);
+        }
+    }
+    __atomic_store_n(&lock, 0, __ATOMIC_RELEASE);
+    return __atomic_load_n(&pool_region_state, __ATOMIC_ACQUIRE);
+}
+
+static int pool_owns(const void* ptr) {
+    return (const char*)ptr >= pool_region_base && (const char*)ptr < pool_region_end;
+}
+
+static PoolSlab* pool_slab_of(const void* ptr) {
+    return (PoolSlab*)((uintptr_t)ptr & ~(uintptr_t)(POOL_SLAB_SIZE - 1));
+}
+
+// Hands the thread a fresh slab for a class; false once the range is used up
+static int pool_refill(PoolCache* cache, int size_class) {
+    if (pool_reserve_region() != 1) return 0;
+    size_t offset = __atomic_fetch_add(&pool_region_next, POOL_SLAB_SIZE, __ATOMIC_RELAXED);
+    if (offset >= POOL_REGION_SIZE) return 0;
+    PoolSlab* slab = (PoolSlab*)(pool_region_base + offset);
+    slab->size_class = (uint32_t)size_class;
+    cache->bump = (char*)slab + POOL_SLAB_HEADER;
+    cache->end = (char*)slab + POOL_SLAB_SIZE;
+    return 1;
+}
+
+static void* heap_malloc(size_t size) {
+    if (size > POOL_MAX_SIZE) return malloc(size);
+    int size_class = pool_class_of(size);
+    PoolCache* cache = &pool_cache[size_class];
+    PoolBlock* block = cache->free_list;
+    if (block) {
+        cache->free_list = block->next;
+        return block;
+    }
+    size_t block_size = pool_class_size[size_class];
+    if ((size_t)(cache->end - cache->bump) < block_size && !pool_refill(cache, size_class)) {
+        return malloc(size);
+    }
+    void* result = cache->bump;
+    cache->bump += block_size;
+    return result;
+}
+
+static void heap_free(void* ptr) {
+    if (!ptr) return;
+    if (!pool_owns(ptr)) {
+        free(ptr);
+        return;
+    }
+    PoolCache* cache = &pool_cache[pool_slab_of(ptr)->size_class];
+    PoolBlock* block = (PoolBlock*)ptr;
+    block->next = cache->free_list;
+    cache->free_list = block;
+}
+
+static void* heap_realloc(void* ptr, size_t size) {
+    if (!ptr) return heap_malloc(size);
+    if (!pool_owns(ptr)) return realloc(ptr, size);
+    size_t block_size = pool_class_size[pool_slab_of(ptr)->size_class];
+    if (size <= block_size) return ptr;
+    void* grown = heap_malloc(size);
+    if (!grown) return NULL;
+    memcpy(grown, ptr, block_size);
+    heap_free(ptr);
+    return grown;
+}
+
+#endif // ORION_SYSTEM_MALLOC
+
+// Arena mode (orion --arena). The program calls __orion_arena_start() first
+// thing in main; from then on orion_malloc bump-allocates from 64 MB mmap'd
+// chunks and orion_free does nothing, so memory is only reclaimed at exit or
+// when the program calls arena_reset(). A reset rewinds to the first chunk and
+// reuses the chunks already mapped. With ORION_ARENA_STATS set, the high-water
+// mark is reported on stderr at exit.
+#define ARENA_CHUNK_SIZE ((size_t)64 << 20)
+#define ARENA_HEADER 16  // Requested size, for orion_realloc; keeps blocks 16-byte aligned
+
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;
+    size_t size;  // Bytes mapped, this header included
+} ArenaChunk;
+
+static int arena_active = 0;
+static ArenaChunk* arena_first = NULL;
+static ArenaChunk* arena_current = NULL;
+static char* arena_bump = NULL;
+static char* arena_end = NULL;
+static size_t arena_used_before = 0;  // Bytes used in the chunks before the current one
+static size_t arena_high_water = 0;
+static size_t arena_mapped = 0;
+static int64_t arena_resets = 0;
+
+static void arena_update_high_water(void) {
+    size_t used = arena_used_before + (size_t)(arena_bump - (char*)arena_current);
+    if (used > arena_high_water) arena_high_water = used;
+}
+
+// Moves to the next chunk with room for a block, mapping one if needed
+static void arena_next_chunk(size_t block) {
+    ArenaChunk* next = arena_current ? arena_current->next : NULL;
+    if (arena_current) {
+        arena_update_high_water();
+        arena_used_before += (size_t)(arena_bump - (char*)arena_current);
+    }
+    if (!next || next->size - sizeof(ArenaChunk) < block) {
+        size_t size = block + sizeof(ArenaChunk) > ARENA_CHUNK_SIZE ? block + sizeof(ArenaChunk) : ARENA_CHUNK_SIZE;
+        ArenaChunk* chunk = (ArenaChunk*)mmap(NULL, size, PROT_READ | PROT_WRITE,
+                                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (chunk == MAP_FAILED) {
+            fprintf(stderr, "Error: Failed to map arena memory\n");
+            exit(1);
+        }
+        chunk->size = size;
+        chunk->next = next;
+        if (arena_current) {
+            arena_current->next = chunk;
+        } else {
+            arena_first = chunk;
+        }
+        arena_mapped += size;
+        next = chunk;
+    }
+    arena_current = next;
+    arena_bump = (char*)next + sizeof(ArenaChunk);
+    arena_end = (char*)next + next->size;
+}
+
+static void* arena_malloc(size_t size) {
+    size_t block = (size + ARENA_HEADER + 15) & ~(size_t)15;
+    if ((size_t)(arena_end - arena_bump) < block) arena_next_chunk(block);
+    char* header = arena_bump;
+    arena_bump += block;
+    *(size_t*)header = size;
+    return header + ARENA_HEADER;
+}
+
+static void* arena_realloc(void* ptr, size_t size) {
+    if (!ptr) return arena_malloc(size);
+    char* header = (char*)ptr - ARENA_HEADER;
+    size_t old_size = *(size_t*)header;
+    // The most recent block grows in place
+    if (header + ((old_size + ARENA_HEADER + 15) & ~(size_t)15) == arena_bump) {
+        size_t block = (size + ARENA_HEADER + 15) & ~(size_t)15;
+        if ((size_t)(arena_end - header) >= block) {
+            arena_bump = header + block;
+            *(size_t*)header = size;
+            return ptr;
+        }
+    }
+    if (size <= old_size) return ptr;
+    void* grown = arena_malloc(size);
+    memcpy(grown, ptr, old_size);
+    return grown;
+}
+
+static void arena_report(void) {
+    arena_update_high_water();
+    fflush(stdout);
+    fprintf(stderr, "\n===------------------------------------------------------------------===\n");
+    fprintf(stderr, "                      Orion arena allocation\n");
+    fprintf(stderr, "===------------------------------------------------------------------===\n");
+    fprintf(stderr, "  %-20s %14.1f KB\n", "High-water mark", arena_high_water / 1024.0);
+    fprintf(stderr, "  %-20s %14.1f KB\n", "Mapped", arena_mapped / 1024.0);
+    fprintf(stderr, "  %-20s %14lld\n", "Resets", (long long)arena_resets);
+}
+
+void __orion_arena_start(void) {
+    arena_active = 1;
+    const char* stats = getenv("ORION_ARENA_STATS");
+    if (stats && *stats) atexit(arena_report);
+}
+
+// arena_reset() in Orion. Every object allocated before the call is gone;
+// without --arena it does nothing
+void orion_arena_reset(void) {
+    if (!arena_active || !arena_first) return;
+    arena_update_high_water();
+    arena_current = arena_first;
+    arena_bump = (char*)arena_first + sizeof(ArenaChunk);
+    arena_end = (char*)arena_first + arena_first->size;
+    arena_used_before = 0;
+    arena_resets++;
+}
+
+void* orion_malloc(size_t size) {
+    if (arena_active) return arena_malloc(size);
+    return heap_malloc(size);
+}
+
+void orion_free(void* ptr) {
+    if (arena_active) return;
+    heap_free(ptr);
+}
+
+void* orion_realloc(void* ptr, size_t size) {
+    if (arena_active) return arena_realloc(ptr, size);
+    return heap_realloc(ptr, size);
+}
+
+// Refcount of objects the compiler placed in a stack frame because escape
+// analysis proved they never outlive it. They are never freed, and retain and
+// release leave them alone
+#define ORION_FRAME_REFCOUNT INT64_MAX
+
+// Element storage of a list. Generic lists hold any 8-byte value (ints, float
+// bit patterns, pointers). The compiler creates the specialized kinds when it
+// knows the element type: doubles, int32 for literals and ranges that fit, and
+// bools packed one bit per element. Every entry point accepts every kind; a
+// store that does not fit (a large int into an int32 list, a string into a
+// bool list) first widens the list to generic storage.
+enum {
+    ORION_ELEM_INT64 = 0,
+    ORION_ELEM_FLOAT = 1,
+    ORION_ELEM_BOOL = 2,
+    ORION_ELEM_INT32 = 3
+};
+
+// Enhanced list structure for dynamic operations with reference counting.
+// Small lists are a single allocation: data points just past the header,
+// where the elements are stored inline, until the list outgrows them and
+// moves its elements to a separate array.
 typedef struct {
     int64_t refcount;    // Reference counter for memory management
     int64_t size;        // Current number of elements
-    int64_t capacity;    // Total allocated space
-    int64_t* data;       // Pointer to element array (8 bytes per element)
+    int64_t capacity;    // Total allocated space, in elements
+    void* data;          // Element array, laid out by kind
+    int64_t kind;        // ORION_ELEM_*
 } OrionList;
 
-// Create a new empty list with initial capacity
-OrionList* list_new(int64_t initial_capacity) {
+// Largest element storage a list is created with inline
+#define ORION_LIST_INLINE_BYTES 512
+
+// Bool values are the str_true/str_false strings emitted by the compiler, or
+// 0/1 from comparisons. Weak so that runtime.o also links without them
+extern const char str_true[] __attribute__((weak));
+extern const char str_false[] __attribute__((weak));
+
+// Bytes of element storage for capacity elements of a kind
+static size_t list_storage_bytes(int64_t kind, int64_t capacity) {
+    switch (kind) {
+        case ORION_ELEM_BOOL: return (size_t)((capacity + 63) / 64) * sizeof(uint64_t);
+        case ORION_ELEM_INT32: return (size_t)capacity * sizeof(int32_t);
+        default: return (size_t)capacity * sizeof(int64_t);
+    }
+}
+
+// Element i as an 8-byte value: float bit patterns, 0/1 for bools
+static inline int64_t list_load(const OrionList* list, int64_t i) {
+    switch (list->kind) {
+        case ORION_ELEM_BOOL: return (int64_t)((((uint64_t*)list->data)[i >> 6] >> (i & 63)) & 1);
+        case ORION_ELEM_INT32: return ((int32_t*)list->data)[i];
+        default: return ((int64_t*)list->data)[i];
+    }
+}
+
+// Stores a value that fits the list's kind (see list_prepare_store)
+static inline void list_store(OrionList* list, int64_t i, int64_t value) {
+    switch (list->kind) {
+        case ORION_ELEM_BOOL: {
+            uint64_t* words = (uint64_t*)list->data;
+            uint64_t bit = (uint64_t)1 << (i & 63);
+            words[i >> 6] = value ? (words[i >> 6] | bit) : (words[i >> 6] & ~bit);
+            break;
+        }
+        case ORION_ELEM_INT32: ((int32_t*)list->data)[i] = (int32_t)value; break;
+        default: ((int64_t*)list->data)[i] = value; break;
+    }
+}
+
+// Whether the elements live in their own allocation rather than inline
+// after the header (small heap lists and frame lists until they grow)
+static inline int list_owns_data(const OrionList* list) {
+    return list->data != (void*)(list + 1);
+}
+
+// Whether the elements are ints (int32 lists, and generic lists, which hold
+// ints unless the compiler could not tell the element type)
+static inline int list_holds_ints(const OrionList* list) {
+    return list->kind == ORION_ELEM_INT32 || list->kind == ORION_ELEM_INT64;
+}
+
+// Bit pattern of an int converted to a double, for storing into a float list
+static inline int64_t list_int_as_float_bits(int64_t value) {
+    double converted = (double)value;
+    int64_t bits;
+    memcpy(&bits, &converted, sizeof(bits));
+    return bits;
+}
+
+// Switches a specialized list to 8-byte storage of a kind, keeping its
+// elements: generic storage, or float storage with the ints converted
+static void list_widen_to(OrionList* list, int64_t kind) {
+    if (list->kind == kind || list->kind == ORION_ELEM_FLOAT) return;
+    int convert = kind == ORION_ELEM_FLOAT;
+    int64_t* data = (int64_t*)orion_malloc(list_storage_bytes(kind, list->capacity));
+    if (!data) {
+        fprintf(stderr, "Error: Failed to allocate memory for list data\n");
+        exit(1);
+    }
+    for (int64_t i = 0; i < list->size; i++) {
+        int64_t value = list_load(list, i);
+        data[i] = convert ? list_int_as_float_bits(value) : value;
+    }
+    if (list_owns_data(list)) orion_free(list->data);
+    list->data = data;
+    list->kind = kind;
+}
+
+// Switches a specialized list to generic storage, keeping its elements
+static void list_widen(OrionList* list) {
+    list_widen_to(list, ORION_ELEM_INT64);
+}
+
+// Converts a value for storage in the list, widening the list if it does not
+// fit. value_is_int is set by the typed int entry points: a float list then
+// stores the int converted rather than its raw bits
+static int64_t list_prepare_store(OrionList* list, int64_t value, int value_is_int) {
+    if (list->kind == ORION_ELEM_FLOAT) {
+        return value_is_int ? list_int_as_float_bits(value) : value;
+    } else if (list->kind == ORION_ELEM_BOOL) {
+        if (str_true && value == (int64_t)str_true) return 1;
+        if (str_false && value == (int64_t)str_false) return 0;
+        if (value == 0 || value == 1) return value;
+    } else if (list->kind == ORION_ELEM_INT32) {
+        if (value >= INT32_MIN && value <= INT32_MAX) return value;
+    } else {
+        return value;
+    }
+    list_widen(list);
+    return value;
+}
+
+// Create a new empty list of an element kind
+OrionList* list_new_kind(int64_t initial_capacity, int64_t kind) {
     if (initial_capacity < 4) initial_capacity = 4; // Minimum capacity
     
-    OrionList* list = (OrionList*)orion_malloc(sizeof(OrionList));
+    size_t storage = list_storage_bytes(kind, initial_capacity);
+    int inline_storage = storage <= ORION_LIST_INLINE_BYTES;
+    OrionList* list = (OrionList*)orion_malloc(sizeof(OrionList) + (inline_storage ? storage : 0));
     if (!list) {
         fprintf(stderr, "Error: Failed to allocate memory for list\n");
         exit(1);
@@ -38,7 +446,8 @@ OrionList* list_new(int64_t initial_capacity) {
     list->refcount = 1;
     list->size = 0;
     list->capacity = initial_capacity;
-    list->data = (int64_t*)orion_malloc(sizeof(int64_t) * initial_capacity);
+    list->kind = kind;
+    list->data = inline_storage ? (void*)(list + 1) : orion_malloc(storage);
     if (!list->data) {
         fprintf(stderr, "Error: Failed to allocate memory for list data\n");
         exit(1);
@@ -47,22 +456,75 @@ OrionList* list_new(int64_t initial_capacity) {
     return list;
 }
 
-// Create a list from existing data (used by list literals)
-OrionList* list_from_data(int64_t* elements, int64_t count) {
-    OrionList* list = list_new(count > 4 ? count : 4);
-    list->size = count;
+// Create a new empty list with initial capacity
+OrionList* list_new(int64_t initial_capacity) {
+    return list_new_kind(initial_capacity, ORION_ELEM_INT64);
+}
+
+// Create a list of an element kind from 8-byte values (used by list literals)
+OrionList* list_from_data_kind(int64_t* elements, int64_t count, int64_t kind) {
+    OrionList* list = list_new_kind(count > 4 ? count : 4, kind);
     
     // Copy elements
-    for (int64_t i = 0; i < count; i++) {
-        list->data[i] = elements[i];
+    if (kind == ORION_ELEM_INT64 || kind == ORION_ELEM_FLOAT) {
+        memcpy(list->data, elements, sizeof(int64_t) * count);
+    } else {
+        for (int64_t i = 0; i < count; i++) {
+            int64_t value = list_prepare_store(list, elements[i], 0);
+            list_store(list, i, value);
+        }
     }
+    list->size = count;
     
     return list;
 }
 
+// Create a list from existing data (used by list literals)
+OrionList* list_from_data(int64_t* elements, int64_t count) {
+    return list_from_data_kind(elements, count, ORION_ELEM_INT64);
+}
+
+// Initializes a list in a stack frame. The caller reserved capacity 8-byte
+// elements right after the header and wrote count values there; specialized
+// kinds are narrowed in place, which is safe front to back because element i
+// never lands above byte 8 * i.
+OrionList* list_init_frame(OrionList* list, int64_t capacity, int64_t count, int64_t kind) {
+    int64_t* values = (int64_t*)(list + 1);
+    list->refcount = ORION_FRAME_REFCOUNT;
+    list->size = count;
+    list->capacity = capacity;
+    list->data = values;
+    list->kind = kind;
+    if (kind == ORION_ELEM_INT32) {
+        for (int64_t i = 0; i < count; i++) {
+            ((int32_t*)values)[i] = (int32_t)values[i];
+        }
+    } else if (kind == ORION_ELEM_BOOL) {
+        // Each word is written only after the 64 values it packs were read
+        for (int64_t word = 0; word * 64 < count; word++) {
+            uint64_t bits = 0;
+            for (int64_t i = word * 64; i < count && i < word * 64 + 64; i++) {
+                int64_t value = values[i];
+                if (str_false && value == (int64_t)str_false) value = 0;
+                if (value) bits |= (uint64_t)1 << (i & 63);
+            }
+            ((uint64_t*)values)[word] = bits;
+        }
+    }
+    return list;
+}
+
+// Frees the element array a frame-allocated list moved to when it grew
+void list_release_frame(OrionList* list) {
+    if (list && list_owns_data(list)) {
+        orion_free(list->data);
+        list->data = list + 1;
+    }
+}
+
 // Retain a list (increment reference count)
 OrionList* list_retain(OrionList* list) {
-    if (list) {
+    if (list && list->refcount != ORION_FRAME_REFCOUNT) {
         list->refcount++;
     }
     return list;
@@ -70,11 +532,11 @@ OrionList* list_retain(OrionList* list) {
 
 // Release a list (decrement reference count and free if zero)
 void list_release(OrionList* list) {
-    if (!list) return;
+    if (!list || list->refcount == ORION_FRAME_REFCOUNT) return;
     
     list->refcount--;
     if (list->refcount <= 0) {
-        orion_free(list->data);
+        if (list_owns_data(list)) orion_free(list->data);
         orion_free(list);
     }
 }
@@ -109,24 +571,36 @@ int64_t normalize_index(OrionList* list, int64_t index) {
 
 // Get element at index (supports negative indexing)
 int64_t list_get(OrionList* list, int64_t index) {
+    if (list && list->kind == ORION_ELEM_INT64 && (uint64_t)index < (uint64_t)list->size) {
+        return ((int64_t*)list->data)[index];
+    }
     if (!list) {
         fprintf(stderr, "Error: Cannot access null list\n");
         exit(1);
     }
     
     index = normalize_index(list, index);
-    return list->data[index];
+    return list_load(list, index);
 }
 
-// Set element at index (supports negative indexing)
-void list_set(OrionList* list, int64_t index, int64_t value) {
+static void list_set_value(OrionList* list, int64_t index, int64_t value, int value_is_int) {
     if (!list) {
         fprintf(stderr, "Error: Cannot modify null list\n");
         exit(1);
     }
     
     index = normalize_index(list, index);
-    list->data[index] = value;
+    value = list_prepare_store(list, value, value_is_int);
+    list_store(list, index, value);
+}
+
+// Set element at index (supports negative indexing)
+void list_set(OrionList* list, int64_t index, int64_t value) {
+    if (list && list->kind == ORION_ELEM_INT64 && (uint64_t)index < (uint64_t)list->size) {
+        ((int64_t*)list->data)[index] = value;
+        return;
+    }
+    list_set_value(list, index, value, 0);
 }
 
 // Resize list capacity (internal function)
@@ -134,12 +608,19 @@ void list_resize(OrionList* list, int64_t new_capacity) {
     if (!list) return;
     
     // Protect against integer overflow
-    if (new_capacity > INT64_MAX / sizeof(int64_t)) {
+    if (new_capacity > INT64_MAX / (int64_t)sizeof(int64_t)) {
         fprintf(stderr, "Error: List capacity too large\n");
         exit(1);
     }
     
-    int64_t* new_data = (int64_t*)orion_realloc(list->data, sizeof(int64_t) * new_capacity);
+    void* new_data;
+    if (list_owns_data(list)) {
+        new_data = orion_realloc(list->data, list_storage_bytes(list->kind, new_capacity));
+    } else {
+        // The list outgrew its inline elements
+        new_data = orion_malloc(list_storage_bytes(list->kind, new_capacity));
+        if (new_data) memcpy(new_data, list->data, list_storage_bytes(list->kind, list->size));
+    }
     if (!new_data) {
         fprintf(stderr, "Error: Failed to resize list\n");
         exit(1);
@@ -149,8 +630,7 @@ void list_resize(OrionList* list, int64_t new_capacity) {
     list->capacity = new_capacity;
 }
 
-// Append element to end of list
-void list_append(OrionList* list, int64_t value) {
+static void list_append_value(OrionList* list, int64_t value, int value_is_int) {
     if (!list) {
         fprintf(stderr, "Error: Cannot append to null list\n");
         exit(1);
@@ -162,10 +642,20 @@ void list_append(OrionList* list, int64_t value) {
         list_resize(list, new_capacity);
     }
     
-    list->data[list->size] = value;
+    value = list_prepare_store(list, value, value_is_int);
+    list_store(list, list->size, value);
     list->size++;
 }
 
+// Append element to end of list
+void list_append(OrionList* list, int64_t value) {
+    if (list && list->kind == ORION_ELEM_INT64 && list->size < list->capacity) {
+        ((int64_t*)list->data)[list->size++] = value;
+        return;
+    }
+    list_append_value(list, value, 0);
+}
+
 // Remove and return last element
 int64_t list_pop(OrionList* list) {
     if (!list) {
@@ -179,10 +669,10 @@ int64_t list_pop(OrionList* list) {
     }
     
     list->size--;
-    int64_t value = list->data[list->size];
+    int64_t value = list_load(list, list->size);
     
     // Shrink capacity if list becomes much smaller (optional optimization)
-    if (list->size < list->capacity / 4 && list->capacity > 8) {
+    if (list->size < list->capacity / 4 && list->capacity > 8 && list_owns_data(list)) {
         list_resize(list, list->capacity / 2);
     }
     
@@ -212,13 +702,48 @@ void list_insert(OrionList* list, int64_t index, int64_t value) {
     }
     
     // Shift elements to make room
-    memmove(&list->data[index + 1], &list->data[index], 
-            sizeof(int64_t) * (list->size - index));
+    value = list_prepare_store(list, value, 0);
+    if (list->kind == ORION_ELEM_BOOL) {
+        for (int64_t i = list->size; i > index; i--) {
+            list_store(list, i, list_load(list, i - 1));
+        }
+    } else {
+        size_t width = list_storage_bytes(list->kind, 1);
+        char* data = (char*)list->data;
+        memmove(data + (index + 1) * width, data + index * width, width * (list->size - index));
+    }
     
-    list->data[index] = value;
+    list_store(list, index, value);
     list->size++;
 }
 
+// Copies count elements of src (from index 0) into dst at index start; dst
+// must have room and a kind that holds them. Ints copied into a float list
+// are converted
+static void list_copy_elements(OrionList* dst, int64_t start, const OrionList* src, int64_t count) {
+    if (dst->kind == src->kind && dst->kind != ORION_ELEM_BOOL) {
+        size_t width = list_storage_bytes(dst->kind, 1);
+        memcpy((char*)dst->data + start * width, src->data, width * count);
+        return;
+    }
+    int convert = dst->kind == ORION_ELEM_FLOAT && list_holds_ints(src);
+    for (int64_t i = 0; i < count; i++) {
+        int64_t value = list_load(src, i);
+        list_store(dst, start + i, convert ? list_int_as_float_bits(value) : value);
+    }
+}
+
+// Kind of the list holding the elements of two lists: their own kind when
+// they agree, float when ints meet floats, generic otherwise
+static int64_t list_combined_kind(const OrionList* list1, const OrionList* list2) {
+    if (list1->kind == list2->kind) return list1->kind;
+    if ((list1->kind == ORION_ELEM_FLOAT && list_holds_ints(list2)) ||
+        (list2->kind == ORION_ELEM_FLOAT && list_holds_ints(list1))) {
+        return ORION_ELEM_FLOAT;
+    }
+    return ORION_ELEM_INT64;
+}
+
 // Concatenate two lists (returns new list)
 OrionList* list_concat(OrionList* list1, OrionList* list2) {
     if (!list1 || !list2) {
@@ -226,13 +751,16 @@ OrionList* list_concat(OrionList* list1, OrionList* list2) {
         exit(1);
     }
     
+    // Lists of different kinds concatenate into a generic list, or a float
+    // list when one holds floats and the other ints
+    int64_t kind = list_combined_kind(list1, list2);
     int64_t total_size = list1->size + list2->size;
-    OrionList* result = list_new(total_size);
+    OrionList* result = list_new_kind(total_size, kind);
     result->size = total_size;
     
     // Copy elements from both lists
-    memcpy(result->data, list1->data, sizeof(int64_t) * list1->size);
-    memcpy(&result->data[list1->size], list2->data, sizeof(int64_t) * list2->size);
+    list_copy_elements(result, 0, list1, list1->size);
+    list_copy_elements(result, list1->size, list2, list2->size);
     
     return result;
 }
@@ -250,7 +778,7 @@ OrionList* list_repeat(OrionList* list, int64_t count) {
     }
     
     if (count == 0 || list->size == 0) {
-        return list_new(4);
+        return list_new_kind(4, list->kind);
     }
     
     // Protect against overflow
@@ -260,12 +788,12 @@ OrionList* list_repeat(OrionList* list, int64_t count) {
     }
     
     int64_t total_size = list->size * count;
-    OrionList* result = list_new(total_size);
+    OrionList* result = list_new_kind(total_size, list->kind);
     result->size = total_size;
     
     // Copy the list data count times
     for (int64_t i = 0; i < count; i++) {
-        memcpy(&result->data[i * list->size], list->data, sizeof(int64_t) * list->size);
+        list_copy_elements(result, i * list->size, list, list->size);
     }
     
     return result;
@@ -277,6 +805,10 @@ void list_extend(OrionList* list1, OrionList* list2) {
         fprintf(stderr, "Error: Cannot extend null lists\n");
         exit(1);
     }
+    int64_t kind = list_combined_kind(list1, list2);
+    if (kind != list1->kind) {
+        list_widen_to(list1, kind);
+    }
     
     // Resize if needed
     int64_t new_size = list1->size + list2->size;
@@ -289,10 +821,89 @@ void list_extend(OrionList* list1, OrionList* list2) {
     }
     
     // Copy elements from list2
-    memcpy(&list1->data[list1->size], list2->data, sizeof(int64_t) * list2->size);
+    list_copy_elements(list1, list1->size, list2, list2->size);
     list1->size = new_size;
 }
 
+// Typed entry points, used by the compiler when it knows the element type.
+// They take and return elements in their natural registers (doubles in xmm0,
+// bools as 0/1), handle in-range accesses to their own kind inline and fall
+// back to the generic paths for everything else.
+
+int64_t list_get_int(OrionList* list, int64_t index) {
+    if (list && list->kind == ORION_ELEM_INT32 && (uint64_t)index < (uint64_t)list->size) {
+        return ((int32_t*)list->data)[index];
+    }
+    return list_get(list, index);
+}
+
+void list_set_int(OrionList* list, int64_t index, int64_t value) {
+    if (list && list->kind == ORION_ELEM_INT32 && (uint64_t)index < (uint64_t)list->size &&
+        value >= INT32_MIN && value <= INT32_MAX) {
+        ((int32_t*)list->data)[index] = (int32_t)value;
+        return;
+    }
+    list_set_value(list, index, value, 1);
+}
+
+void list_append_int(OrionList* list, int64_t value) {
+    if (list && list->kind == ORION_ELEM_INT32 && list->size < list->capacity &&
+        value >= INT32_MIN && value <= INT32_MAX) {
+        ((int32_t*)list->data)[list->size++] = (int32_t)value;
+        return;
+    }
+    list_append_value(list, value, 1);
+}
+
+double list_get_float(OrionList* list, int64_t index) {
+    if (list && list->kind == ORION_ELEM_FLOAT && (uint64_t)index < (uint64_t)list->size) {
+        return ((double*)list->data)[index];
+    }
+    int64_t bits = list_get(list, index);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void list_set_float(OrionList* list, int64_t index, double value) {
+    if (list && list->kind == ORION_ELEM_FLOAT && (uint64_t)index < (uint64_t)list->size) {
+        ((double*)list->data)[index] = value;
+        return;
+    }
+    int64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    list_set(list, index, bits);
+}
+
+void list_append_float(OrionList* list, double value) {
+    if (list && list->kind == ORION_ELEM_FLOAT && list->size < list->capacity) {
+        ((double*)list->data)[list->size++] = value;
+        return;
+    }
+    int64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    list_append(list, bits);
+}
+
+int64_t list_get_bool(OrionList* list, int64_t index) {
+    if (list && list->kind == ORION_ELEM_BOOL && (uint64_t)index < (uint64_t)list->size) {
+        return list_load(list, index);
+    }
+    return list_get(list, index);
+}
+
+void list_set_bool(OrionList* list, int64_t index, int64_t truth) {
+    list_set(list, index, truth != 0);
+}
+
+void list_append_bool(OrionList* list, int64_t truth) {
+    if (list && list->kind == ORION_ELEM_BOOL && list->size < list->capacity) {
+        list_store(list, list->size++, truth != 0);
+        return;
+    }
+    list_append(list, truth != 0);
+}
+
 // Print list for debugging (optional)
 void list_print(OrionList* list) {
     if (!list) {
@@ -303,46 +914,149 @@ void list_print(OrionList* list) {
     printf("[");
     for (int64_t i = 0; i < list->size; i++) {
         if (i > 0) printf(", ");
-        printf("%ld", list->data[i]);
+        int64_t value = list_load(list, i);
+        if (list->kind == ORION_ELEM_FLOAT) {
+            double number;
+            memcpy(&number, &value, sizeof(number));
+            printf("%g", number);
+        } else if (list->kind == ORION_ELEM_BOOL) {
+            printf("%s", value ? "True" : "False");
+        } else {
+            printf("%ld", value);
+        }
     }
     printf("]\n");
 }
 
-// Input function - read a line from stdin
-char* orion_input() {
-    const int BUFFER_SIZE = 1024;
-    char* buffer = (char*)orion_malloc(BUFFER_SIZE);
-    if (!buffer) {
-        fprintf(stderr, "Error: Failed to allocate memory for input\n");
+// ============================================================================
+// Strings
+// ============================================================================
+
+// A string is a char* to its NUL-terminated characters, with an
+// OrionStringHeader just before them. Generated code and the C library use the
+// pointer as a plain C string, while the length and hash are one load away:
+// len() is O(1) and concatenation copies its parts without scanning them.
+// Literals are emitted with a header whose refcount is ORION_FRAME_REFCOUNT,
+// as are interpolated strings built in a stack frame, so retain and release
+// leave them alone.
+typedef struct {
+    int64_t refcount;    // Reference counter
+    int64_t length;      // Bytes before the terminating NUL
+    int64_t capacity;    // Bytes available for characters, not counting the NUL
+    uint64_t hash;       // Content hash, computed on first use as a dict key; 0 until then
+} OrionStringHeader;
+
+#define STRING_HEADER(str) ((OrionStringHeader*)(str) - 1)
+
+// New empty heap string with room for capacity characters
+static char* string_alloc(int64_t capacity) {
+    OrionStringHeader* header = (OrionStringHeader*)orion_malloc(sizeof(OrionStringHeader) + (size_t)capacity + 1);
+    if (!header) {
+        fprintf(stderr, "Error: Failed to allocate memory for string\n");
         exit(1);
     }
+    header->refcount = 1;
+    header->length = 0;
+    header->capacity = capacity;
+    header->hash = 0;
+    char* str = (char*)(header + 1);
+    str[0] = '\0';
+    return str;
+}
+
+// Empty string in a caller-provided buffer of a header plus capacity + 1 bytes
+static char* string_init_frame(char* buffer, int64_t capacity) {
+    OrionStringHeader* header = (OrionStringHeader*)buffer;
+    header->refcount = ORION_FRAME_REFCOUNT;
+    header->length = 0;
+    header->capacity = capacity;
+    header->hash = 0;
+    char* str = (char*)(header + 1);
+    str[0] = '\0';
+    return str;
+}
+
+static inline char* string_set_length(char* str, int64_t length) {
+    STRING_HEADER(str)->length = length;
+    str[length] = '\0';
+    return str;
+}
+
+static char* string_from(const char* data, int64_t length) {
+    char* str = string_alloc(length);
+    if (length) memcpy(str, data, (size_t)length);
+    return string_set_length(str, length);
+}
+
+// Decimal digits of value at out, with no NUL; returns how many were written
+static int format_int(char* out, int64_t value) {
+    char digits[20];
+    uint64_t magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    int count = 0;
+    do {
+        digits[count++] = (char)('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude);
+    int length = 0;
+    if (value < 0) out[length++] = '-';
+    while (count) out[length++] = digits[--count];
+    return length;
+}
+
+// Create a string from a C string
+char* string_new(const char* str) {
+    if (!str) return string_from("", 0);
+    return string_from(str, (int64_t)strlen(str));
+}
+
+int64_t string_len(const char* str) {
+    return str ? STRING_HEADER(str)->length : 0;
+}
+
+// Retain a string (increment reference count)
+char* string_retain(char* str) {
+    if (str && STRING_HEADER(str)->refcount != ORION_FRAME_REFCOUNT) {
+        STRING_HEADER(str)->refcount++;
+    }
+    return str;
+}
+
+// Release a string (decrement reference count and free if zero)
+void string_release(char* str) {
+    if (!str) return;
+    OrionStringHeader* header = STRING_HEADER(str);
+    if (header->refcount == ORION_FRAME_REFCOUNT) return;
+    
+    header->refcount--;
+    if (header->refcount <= 0) {
+        orion_free(header);
+    }
+}
+
+// String == and !=: strings of different lengths differ without a scan
+int64_t string_equal(const char* a, const char* b) {
+    if (a == b) return 1;
+    if (!a || !b) return 0;
+    int64_t length = STRING_HEADER(a)->length;
+    return length == STRING_HEADER(b)->length && memcmp(a, b, (size_t)length) == 0;
+}
+
+// Input function - read a line from stdin
+char* orion_input() {
+    char buffer[1024];
     
     // Read line from stdin
-    if (!fgets(buffer, BUFFER_SIZE, stdin)) {
+    if (!fgets(buffer, sizeof(buffer), stdin)) {
         // Handle EOF or error
-        orion_free(buffer);
-        buffer = (char*)orion_malloc(1);
-        buffer[0] = '\0';
-        return buffer;
+        return string_from("", 0);
     }
     
     // Remove trailing newline if present
     size_t len = strlen(buffer);
     if (len > 0 && buffer[len - 1] == '\n') {
-        buffer[len - 1] = '\0';
-    }
-    
-    // Resize buffer to actual string length to save memory
-    size_t actual_len = strlen(buffer);
-    char* result = (char*)orion_malloc(actual_len + 1);
-    if (!result) {
-        fprintf(stderr, "Error: Failed to allocate memory for input result\n");
-        exit(1);
+        len--;
     }
-    strcpy(result, buffer);
-    orion_free(buffer);
-    
-    return result;
+    return string_from(buffer, (int64_t)len);
 }
 
 // Input function with prompt - display prompt then read input
@@ -390,95 +1104,159 @@ char* strcat_simple(char* dest, const char* src) {
 
 // Convert integer to string (returns dynamically allocated string)
 char* int_to_string(int64_t value) {
-    char* buffer = (char*)orion_malloc(32);  // Enough for 64-bit int
-    if (!buffer) {
-        fprintf(stderr, "Error: Failed to allocate memory for int_to_string\n");
-        exit(1);
-    }
-    sprintf(buffer, "%ld", value);
-    return buffer;
+    char* str = string_alloc(20);  // Enough for 64-bit int
+    return string_set_length(str, format_int(str, value));
+}
+
+// Convert integer to string in a caller-provided buffer: a string header
+// followed by 32 bytes
+char* int_to_string_into(char* buffer, int64_t value) {
+    char* str = string_init_frame(buffer, 31);
+    return string_set_length(str, format_int(str, value));
+}
+
+// Convert float to string in a caller-provided buffer: a string header
+// followed by 64 bytes
+char* float_to_string_into(char* buffer, double value) {
+    char* str = string_init_frame(buffer, 63);
+    int length = snprintf(str, 64, "%.2f", value);
+    return string_set_length(str, length < 63 ? length : 63);
 }
 
 // Convert float to string (returns dynamically allocated string)
 char* float_to_string(double value) {
-    char* buffer = (char*)orion_malloc(64);  // Enough for double precision
-    if (!buffer) {
-        fprintf(stderr, "Error: Failed to allocate memory for float_to_string\n");
-        exit(1);
-    }
-    sprintf(buffer, "%.2f", value);
-    return buffer;
+    char* str = string_alloc(63);  // Enough for double precision
+    int length = snprintf(str, 64, "%.2f", value);
+    return string_set_length(str, length < 63 ? length : 63);
 }
 
 // Convert boolean to string (returns dynamically allocated string)
 char* bool_to_string(int64_t value) {
-    char* buffer = (char*)orion_malloc(8);  // "True" or "False"
-    if (!buffer) {
-        fprintf(stderr, "Error: Failed to allocate memory for bool_to_string\n");
-        exit(1);
-    }
-    strcpy(buffer, value ? "True" : "False");
-    return buffer;
+    return value ? string_from("True", 4) : string_from("False", 5);
 }
 
-// Copy string (for consistency with other conversion functions)
-char* string_to_string(const char* value) {
-    if (!value) {
-        char* buffer = (char*)orion_malloc(1);
-        if (buffer) buffer[0] = '\0';
-        return buffer;
+// String part of an interpolation. Strings are never changed in place, so
+// the part shares a heap value instead of copying it. A string in a stack
+// frame is copied, since the interpolation may outlive the frame; literals
+// carry the same refcount and are copied too.
+char* string_to_string(char* value) {
+    if (!value) return string_from("", 0);
+    if (STRING_HEADER(value)->refcount == ORION_FRAME_REFCOUNT) {
+        return string_from(value, STRING_HEADER(value)->length);
     }
-    
-    size_t len = strlen(value);
-    char* buffer = (char*)orion_malloc(len + 1);
-    if (!buffer) {
-        fprintf(stderr, "Error: Failed to allocate memory for string_to_string\n");
-        exit(1);
-    }
-    strcpy(buffer, value);
-    return buffer;
+    return string_retain(value);
 }
 
 // String concatenation for interpolated strings
 // Takes an array of string pointers and concatenates them
 char* string_concat_parts(char** parts, int count) {
     if (!parts || count <= 0) {
-        char* empty = (char*)orion_malloc(1);
-        if (empty) empty[0] = '\0';
-        return empty;
+        return string_from("", 0);
     }
     
     // Calculate total length needed
-    size_t total_len = 0;
+    int64_t total_len = 0;
     for (int i = 0; i < count; i++) {
-        if (parts[i]) {
-            total_len += strlen(parts[i]);
-        }
-    }
-    
-    // Allocate result buffer
-    char* result = (char*)orion_malloc(total_len + 1);
-    if (!result) {
-        fprintf(stderr, "Error: Failed to allocate memory for string_concat_parts\n");
-        exit(1);
+        total_len += string_len(parts[i]);
     }
     
     // Concatenate all parts
-    result[0] = '\0';
+    char* result = string_alloc(total_len);
+    char* end = result;
     for (int i = 0; i < count; i++) {
-        if (parts[i]) {
-            strcat(result, parts[i]);
-        }
+        int64_t length = string_len(parts[i]);
+        if (length) memcpy(end, parts[i], (size_t)length);
+        end += length;
+    }
+    return string_set_length(result, total_len);
+}
+
+// Concatenation into a buffer in the caller's stack frame (interpolated
+// strings that do not escape): a string header followed by capacity bytes.
+// Falls back to the heap when it is too small.
+char* string_concat_into(char* buffer, int64_t capacity, char** parts, int64_t count) {
+    int64_t total_len = 0;
+    for (int64_t i = 0; i < count; i++) {
+        total_len += string_len(parts[i]);
     }
     
-    return result;
+    char* result = total_len + 1 > capacity ? string_alloc(total_len) : string_init_frame(buffer, capacity - 1);
+    char* end = result;
+    for (int64_t i = 0; i < count; i++) {
+        int64_t length = string_len(parts[i]);
+        if (length) memcpy(end, parts[i], (size_t)length);
+        end += length;
+    }
+    return string_set_length(result, total_len);
+}
+
+// Builder for a heap interpolated string, kept in the caller's stack frame.
+// The compiler reserves room for the literal text plus an estimate for each
+// formatted part, so formatting a line is one allocation with every part
+// written in place; a part longer than its estimate grows the buffer.
+typedef struct {
+    char* data;          // Characters built so far; NULL until the first append
+    int64_t length;      // Characters built so far
+    int64_t capacity;    // Reserved size until the first append, then the buffer's room
+} OrionStringBuilder;
+
+void string_builder_reserve(OrionStringBuilder* builder, int64_t capacity) {
+    builder->data = NULL;
+    builder->length = 0;
+    builder->capacity = capacity;
+}
+
+// Room for extra more characters. The first allocation adds the reservation
+// on top of a part that exceeds it, since the parts after it are still to come.
+static char* string_builder_room(OrionStringBuilder* builder, int64_t extra) {
+    int64_t needed = builder->length + extra;
+    if (!builder->data) {
+        int64_t capacity = needed <= builder->capacity ? builder->capacity : needed + builder->capacity;
+        builder->data = string_alloc(capacity);
+        builder->capacity = capacity;
+    } else if (needed > builder->capacity) {
+        int64_t capacity = builder->capacity * 2 > needed ? builder->capacity * 2 : needed;
+        OrionStringHeader* header = (OrionStringHeader*)orion_realloc(STRING_HEADER(builder->data),
+                                                                      sizeof(OrionStringHeader) + (size_t)capacity + 1);
+        if (!header) {
+            fprintf(stderr, "Error: Failed to allocate memory for string\n");
+            exit(1);
+        }
+        header->capacity = capacity;
+        builder->data = (char*)(header + 1);
+        builder->capacity = capacity;
+    }
+    return builder->data + builder->length;
+}
+
+void string_builder_append_str(OrionStringBuilder* builder, const char* str) {
+    int64_t length = string_len(str);
+    char* end = string_builder_room(builder, length);
+    if (length) memcpy(end, str, (size_t)length);
+    builder->length += length;
+}
+
+void string_builder_append_int(OrionStringBuilder* builder, int64_t value) {
+    char* end = string_builder_room(builder, 20);  // Longest int64 in decimal, with sign
+    builder->length += format_int(end, value);
+}
+
+void string_builder_append_float(OrionStringBuilder* builder, double value) {
+    int64_t room = 32;
+    char* end = string_builder_room(builder, room);
+    int length = snprintf(end, (size_t)room + 1, "%.2f", value);
+    if (length > room) {
+        end = string_builder_room(builder, length);
+        snprintf(end, (size_t)length + 1, "%.2f", value);
+    }
+    builder->length += length;
 }
 
-// String object structure with reference counting
-typedef struct {
-    int64_t refcount;    // Reference counter
-    char* data;          // Actual string data
-} OrionString;
+// The built string; the builder is spent
+char* string_builder_finish(OrionStringBuilder* builder) {
+    string_builder_room(builder, 0);
+    return string_set_length(builder->data, builder->length);
+}
 
 // Range object structure for Python-style range() function
 typedef struct {
@@ -489,20 +1267,14 @@ typedef struct {
     int64_t size;        // Number of elements in range
 } OrionRange;
 
-// Create a range object with start, stop, and step
-OrionRange* range_new(int64_t start, int64_t stop, int64_t step) {
+// Initialize a range in a stack frame (see ORION_FRAME_REFCOUNT)
+OrionRange* range_init(OrionRange* range, int64_t start, int64_t stop, int64_t step) {
     if (step == 0) {
         fprintf(stderr, "Error: Range step cannot be zero\n");
         exit(1);
     }
     
-    OrionRange* range = (OrionRange*)orion_malloc(sizeof(OrionRange));
-    if (!range) {
-        fprintf(stderr, "Error: Failed to allocate memory for range\n");
-        exit(1);
-    }
-    
-    range->refcount = 1;
+    range->refcount = ORION_FRAME_REFCOUNT;
     range->start = start;
     range->stop = stop;
     range->step = step;
@@ -524,6 +1296,19 @@ OrionRange* range_new(int64_t start, int64_t stop, int64_t step) {
     return range;
 }
 
+// Create a range object with start, stop, and step
+OrionRange* range_new(int64_t start, int64_t stop, int64_t step) {
+    OrionRange* range = (OrionRange*)orion_malloc(sizeof(OrionRange));
+    if (!range) {
+        fprintf(stderr, "Error: Failed to allocate memory for range\n");
+        exit(1);
+    }
+    
+    range_init(range, start, stop, step);
+    range->refcount = 1;
+    return range;
+}
+
 // Create range with just stop (start=0, step=1)
 OrionRange* range_new_stop(int64_t stop) {
     return range_new(0, stop, 1);
@@ -558,6 +1343,20 @@ int64_t range_get(OrionRange* range, int64_t index) {
     return range->start + (index * range->step);
 }
 
+// Print a range the way it is written: range(start, stop) or range(start, stop, step)
+void range_print(OrionRange* range) {
+    if (!range) {
+        printf("null\n");
+        return;
+    }
+
+    if (range->step == 1) {
+        printf("range(%ld, %ld)\n", range->start, range->stop);
+    } else {
+        printf("range(%ld, %ld, %ld)\n", range->start, range->stop, range->step);
+    }
+}
+
 // Convert range to list (for debugging/compatibility)
 OrionList* range_to_list(OrionRange* range) {
     if (!range) {
@@ -565,11 +1364,14 @@ OrionList* range_to_list(OrionRange* range) {
         exit(1);
     }
     
-    OrionList* list = list_new(range->size);
+    // Ranges whose values all fit in 32 bits get int32 storage
+    int64_t last = range->size > 0 ? range_get(range, range->size - 1) : 0;
+    int fits32 = range->start >= INT32_MIN && range->start <= INT32_MAX && last >= INT32_MIN && last <= INT32_MAX;
+    OrionList* list = list_new_kind(range->size, fits32 ? ORION_ELEM_INT32 : ORION_ELEM_INT64);
     list->size = range->size;
     
     for (int64_t i = 0; i < range->size; i++) {
-        list->data[i] = range_get(range, i);
+        list_store(list, i, range_get(range, i));
     }
     
     return list;
@@ -584,7 +1386,7 @@ void range_free(OrionRange* range) {
 
 // Retain a range (increment reference count)
 OrionRange* range_retain(OrionRange* range) {
-    if (range) {
+    if (range && range->refcount != ORION_FRAME_REFCOUNT) {
         range->refcount++;
     }
     return range;
@@ -592,7 +1394,7 @@ OrionRange* range_retain(OrionRange* range) {
 
 // Release a range (decrement reference count and free if zero)
 void range_release(OrionRange* range) {
-    if (!range) return;
+    if (!range || range->refcount == ORION_FRAME_REFCOUNT) return;
     
     range->refcount--;
     if (range->refcount <= 0) {
@@ -600,91 +1402,31 @@ void range_release(OrionRange* range) {
     }
 }
 
-// Create a string object with reference counting
-OrionString* string_new(const char* str) {
-    OrionString* s = (OrionString*)orion_malloc(sizeof(OrionString));
-    if (!s) {
-        fprintf(stderr, "Error: Failed to allocate memory for string\n");
-        exit(1);
-    }
-    
-    s->refcount = 1;
-    if (str) {
-        size_t len = strlen(str);
-        s->data = (char*)orion_malloc(len + 1);
-        if (!s->data) {
-            fprintf(stderr, "Error: Failed to allocate memory for string data\n");
-            exit(1);
-        }
-        strcpy(s->data, str);
-    } else {
-        s->data = (char*)orion_malloc(1);
-        s->data[0] = '\0';
-    }
-    
-    return s;
-}
-
-// Retain a string (increment reference count)
-OrionString* string_retain(OrionString* str) {
-    if (str) {
-        str->refcount++;
-    }
-    return str;
-}
-
-// Release a string (decrement reference count and free if zero)
-void string_release(OrionString* str) {
-    if (!str) return;
-    
-    str->refcount--;
-    if (str->refcount <= 0) {
-        orion_free(str->data);
-        orion_free(str);
-    }
-}
-
-// Get C string from OrionString
-char* string_get_cstr(OrionString* str) {
-    if (!str) return NULL;
-    return str->data;
-}
-
 // =====================================================
 // Built-in Type Conversion Functions
 // =====================================================
 
+// Reached by generated code that meets a value whose type the compiler could
+// not resolve; message names the line and the operation
+void orion_type_error(const char* message) {
+    fprintf(stderr, "Error: %s\n", message);
+    exit(1);
+}
+
 // String conversion functions
 char* __orion_int_to_string(int64_t value) {
-    char* result = (char*)orion_malloc(32);  // Enough for any 64-bit integer
-    if (!result) {
-        fprintf(stderr, "Error: Failed to allocate memory for string conversion\n");
-        exit(1);
-    }
-    snprintf(result, 32, "%ld", value);
-    return result;
+    char* result = string_alloc(20);  // Enough for any 64-bit integer
+    return string_set_length(result, format_int(result, value));
 }
 
 char* __orion_float_to_string(double value) {
-    char* result = (char*)orion_malloc(64);  // Enough for most float representations
-    if (!result) {
-        fprintf(stderr, "Error: Failed to allocate memory for string conversion\n");
-        exit(1);
-    }
-    snprintf(result, 64, "%.15g", value);  // Use 'g' format for clean output
-    return result;
+    char* result = string_alloc(63);  // Enough for most float representations
+    int length = snprintf(result, 64, "%.15g", value);  // Use 'g' format for clean output
+    return string_set_length(result, length < 63 ? length : 63);
 }
 
 char* __orion_bool_to_string(int value) {
-    const char* bool_str = value ? "true" : "false";
-    size_t len = strlen(bool_str) + 1;
-    char* result = (char*)orion_malloc(len);
-    if (!result) {
-        fprintf(stderr, "Error: Failed to allocate memory for string conversion\n");
-        exit(1);
-    }
-    strcpy(result, bool_str);
-    return result;
+    return value ? string_from("true", 4) : string_from("false", 5);
 }
 
 // Integer conversion functions
@@ -755,58 +1497,257 @@ double __orion_string_to_float(const char* str) {
 // Dictionary Implementation with Hash Table
 // ============================================================================
 
-// Hash table entry for dictionary
+// Insertion-ordered table. Entries are appended to a dense array, so
+// iteration follows insertion order and costs time proportional to the
+// number of entries. Lookups go through a separate open-addressing index in
+// the style of a Swiss table: each index slot holds the position of an entry
+// (1, 2 or 4 bytes wide, depending on the table size) and has a one-byte
+// control entry: EMPTY, DELETED, or the low seven bits of the key's hash
+// (h2) when the slot is full. A lookup starts at the slot picked by the rest
+// of the hash (h1) and compares 16 control bytes at once with SSE2, reading
+// an entry only when its h2 matches. The control array has DICT_GROUP_WIDTH
+// extra bytes mirroring the first ones, so a group load near the end of the
+// index wraps around without a bounds check.
+#define DICT_GROUP_WIDTH 16
+#define DICT_MIN_CAPACITY 16      // Power of two, at least one group
+#define DICT_CTRL_EMPTY ((int8_t)0x80)
+#define DICT_CTRL_DELETED ((int8_t)0xFE)
+#define DICT_HASH_DELETED 0       // Hash of a removed entry; real hashes are never 0
+
+// Integer keys are hashed and compared by value. String keys are hashed and
+// compared by content; the string itself caches its hash, so a key is hashed
+// once however many dicts it goes into. Every entry also caches its key's
+// hash, so a lookup compares strings only on a full 64-bit hash match and
+// rebuilding the index never reads the keys again.
+#define DICT_KEYS_INT 0
+#define DICT_KEYS_STRING 1
+
+// Key-value entry
 typedef struct DictEntry {
+    uint64_t hash;            // Cached hash of the key, DICT_HASH_DELETED once removed
     int64_t key;              // Key (stored as int64_t, can represent string pointers too)
     int64_t value;            // Value (stored as int64_t)
-    int is_occupied;          // 1 if entry is used, 0 if empty
-    int is_deleted;           // 1 if entry was deleted (for open addressing)
 } DictEntry;
 
 // Dictionary structure with reference counting
 typedef struct {
     int64_t refcount;         // Reference counter for memory management
     int64_t size;             // Number of key-value pairs
-    int64_t capacity;         // Total allocated slots
-    DictEntry* entries;       // Hash table entries
+    int64_t used;             // Entries appended since the last rebuild, removed ones included
+    int64_t usable;           // Length of the entries array
+    int64_t growth_left;      // Inserts into EMPTY index slots left before a rebuild
+    int64_t capacity;         // Index slots, a power of two
+    int64_t index_width;      // Bytes per index slot: 1, 2 or 4
+    int64_t key_kind;         // DICT_KEYS_INT or DICT_KEYS_STRING
+    int64_t version;          // Bumped whenever a key is added or removed
+    DictEntry* entries;       // Dense, in insertion order; shares its allocation with index and ctrl
+    void* index;              // Entry position for each index slot
+    int8_t* ctrl;             // capacity + DICT_GROUP_WIDTH control bytes
 } OrionDict;
 
-// Simple hash function for int64_t keys
-static int64_t hash_key(int64_t key, int64_t capacity) {
-    // Use multiplicative hashing
-    uint64_t hash = (uint64_t)key;
-    hash = hash * 2654435761ULL;
-    return hash % capacity;
+// Mixes every bit of the key into the high and low halves of the hash
+static inline uint64_t hash_key(int64_t key) {
+    uint64_t hash = (uint64_t)key * 0x9E3779B97F4A7C15ULL;
+    return hash ^ (hash >> 32);
 }
 
-// Create a new empty dictionary
-OrionDict* dict_new(int64_t initial_capacity) {
-    if (initial_capacity < 8) initial_capacity = 8;
+static inline uint64_t wy_mix(uint64_t a, uint64_t b) {
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+static inline uint64_t wy_read8(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline uint64_t wy_read4(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+// wyhash: 16 bytes per multiply, with short strings read in overlapping words
+static uint64_t hash_string(const char* str, size_t length) {
+    static const uint64_t secret[4] = {
+        0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL
+    };
+    const uint8_t* p = (const uint8_t*)str;
+    uint64_t seed = secret[0] ^ wy_mix(secret[0], secret[1]);
+    uint64_t a, b;
+    
+    if (length <= 16) {
+        if (length >= 4) {
+            size_t middle = (length >> 3) << 2;
+            a = (wy_read4(p) << 32) | wy_read4(p + middle);
+            b = (wy_read4(p + length - 4) << 32) | wy_read4(p + length - 4 - middle);
+        } else if (length > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) | p[length - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = length;
+        if (i > 48) {
+            uint64_t seed1 = seed, seed2 = seed;
+            do {
+                seed = wy_mix(wy_read8(p) ^ secret[1], wy_read8(p + 8) ^ seed);
+                seed1 = wy_mix(wy_read8(p + 16) ^ secret[2], wy_read8(p + 24) ^ seed1);
+                seed2 = wy_mix(wy_read8(p + 32) ^ secret[3], wy_read8(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16) {
+            seed = wy_mix(wy_read8(p) ^ secret[1], wy_read8(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = wy_read8(p + i - 16);
+        b = wy_read8(p + i - 8);
+    }
     
+    __uint128_t product = (__uint128_t)(a ^ secret[1]) * (b ^ seed);
+    return wy_mix((uint64_t)product ^ secret[0] ^ length, (uint64_t)(product >> 64) ^ secret[1]);
+}
+
+// Content hash of a string, cached in its header
+static inline uint64_t string_hash(const char* str) {
+    OrionStringHeader* header = STRING_HEADER(str);
+    if (!header->hash) {
+        uint64_t hash = hash_string(str, (size_t)header->length);
+        header->hash = hash ? hash : 1;
+    }
+    return header->hash;
+}
+
+// Hash of a key under the dict's key kind, never DICT_HASH_DELETED
+static inline uint64_t dict_hash(const OrionDict* dict, int64_t key) {
+    uint64_t hash;
+    if (dict->key_kind == DICT_KEYS_STRING) {
+        hash = key ? string_hash((const char*)key) : hash_string("", 0);
+    } else {
+        hash = hash_key(key);
+    }
+    return hash != DICT_HASH_DELETED ? hash : 1;
+}
+
+static inline int dict_key_equal(const OrionDict* dict, const DictEntry* entry, int64_t key, uint64_t hash) {
+    if (dict->key_kind != DICT_KEYS_STRING) {
+        return entry->key == key;
+    }
+    if (entry->hash != hash) return 0;
+    return string_equal((const char*)entry->key, (const char*)key);
+}
+
+static inline int8_t hash_h2(uint64_t hash) {
+    return (int8_t)(hash & 0x7F);
+}
+
+// Entries available per index size. This also bounds the index slots that
+// are full or DELETED: growth_left starts here, drops when an insert takes an
+// EMPTY slot and comes back only when a removal returns a slot to EMPTY, so
+// tombstones use up the budget and some EMPTY slot always ends each probe.
+static inline int64_t dict_max_load(int64_t capacity) {
+    return capacity - capacity / 8;
+}
+
+static inline int64_t dict_index_get(const OrionDict* dict, int64_t slot) {
+    switch (dict->index_width) {
+        case 1: return ((const uint8_t*)dict->index)[slot];
+        case 2: return ((const uint16_t*)dict->index)[slot];
+        default: return ((const uint32_t*)dict->index)[slot];
+    }
+}
+
+static inline void dict_index_set(OrionDict* dict, int64_t slot, int64_t position) {
+    switch (dict->index_width) {
+        case 1: ((uint8_t*)dict->index)[slot] = (uint8_t)position; break;
+        case 2: ((uint16_t*)dict->index)[slot] = (uint16_t)position; break;
+        default: ((uint32_t*)dict->index)[slot] = (uint32_t)position; break;
+    }
+}
+
+static inline DictEntry* dict_slot_entry(const OrionDict* dict, int64_t slot) {
+    return &dict->entries[dict_index_get(dict, slot)];
+}
+
+static inline uint32_t dict_group_match(const int8_t* ctrl, int8_t byte) {
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(byte)));
+}
+
+// EMPTY and DELETED are the control bytes with the sign bit set
+static inline uint32_t dict_group_match_free(const int8_t* ctrl) {
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (uint32_t)_mm_movemask_epi8(group);
+}
+
+static inline void dict_set_ctrl(OrionDict* dict, int64_t index, int8_t byte) {
+    dict->ctrl[index] = byte;
+    if (index < DICT_GROUP_WIDTH) {
+        dict->ctrl[dict->capacity + index] = byte;
+    }
+}
+
+// Allocates an empty entries array, index and control bytes for a
+// power-of-two capacity
+static void dict_alloc_table(OrionDict* dict, int64_t capacity) {
+    int64_t usable = dict_max_load(capacity);
+    int64_t width = usable <= UINT8_MAX ? 1 : usable <= UINT16_MAX ? 2 : 4;
+    size_t entry_bytes = sizeof(DictEntry) * (size_t)usable;
+    size_t index_bytes = (size_t)(width * capacity);
+    char* block = (char*)orion_malloc(entry_bytes + index_bytes + (size_t)capacity + DICT_GROUP_WIDTH);
+    if (!block) {
+        fprintf(stderr, "Error: Failed to allocate memory for dictionary entries\n");
+        exit(1);
+    }
+    dict->entries = (DictEntry*)block;
+    dict->index = block + entry_bytes;
+    dict->ctrl = (int8_t*)(block + entry_bytes + index_bytes);
+    dict->capacity = capacity;
+    dict->usable = usable;
+    dict->growth_left = usable;
+    dict->index_width = width;
+    dict->used = 0;
+    memset(dict->ctrl, (uint8_t)DICT_CTRL_EMPTY, (size_t)capacity + DICT_GROUP_WIDTH);
+}
+
+static OrionDict* dict_new_kind(int64_t initial_capacity, int64_t key_kind) {
     OrionDict* dict = (OrionDict*)orion_malloc(sizeof(OrionDict));
     if (!dict) {
         fprintf(stderr, "Error: Failed to allocate memory for dictionary\n");
         exit(1);
     }
     
-    dict->refcount = 1;
-    dict->size = 0;
-    dict->capacity = initial_capacity;
-    dict->entries = (DictEntry*)orion_malloc(sizeof(DictEntry) * initial_capacity);
-    if (!dict->entries) {
-        fprintf(stderr, "Error: Failed to allocate memory for dictionary entries\n");
-        exit(1);
+    // Room for initial_capacity keys without a rebuild
+    int64_t capacity = DICT_MIN_CAPACITY;
+    while (dict_max_load(capacity) < initial_capacity) {
+        capacity *= 2;
     }
     
-    // Initialize all entries as empty
-    for (int64_t i = 0; i < initial_capacity; i++) {
-        dict->entries[i].is_occupied = 0;
-        dict->entries[i].is_deleted = 0;
-    }
+    dict->refcount = 1;
+    dict->size = 0;
+    dict->key_kind = key_kind;
+    dict->version = 0;
+    dict_alloc_table(dict, capacity);
     
     return dict;
 }
 
+// Create a new empty dictionary
+OrionDict* dict_new(int64_t initial_capacity) {
+    return dict_new_kind(initial_capacity, DICT_KEYS_INT);
+}
+
+// Create a new empty dictionary with string keys compared by content
+OrionDict* dict_new_str(int64_t initial_capacity) {
+    return dict_new_kind(initial_capacity, DICT_KEYS_STRING);
+}
+
 // Retain a dictionary (increment reference count)
 OrionDict* dict_retain(OrionDict* dict) {
     if (dict) {
@@ -835,99 +1776,180 @@ int64_t dict_len(OrionDict* dict) {
     return dict->size;
 }
 
-// Find entry for a key (returns index, or -1 if not found)
-static int64_t dict_find_entry(OrionDict* dict, int64_t key) {
-    int64_t index = hash_key(key, dict->capacity);
-    int64_t start = index;
-    
-    do {
-        if (!dict->entries[index].is_occupied && !dict->entries[index].is_deleted) {
-            return -1;  // Not found
+// Find the index slot of a key (returns -1 if not found). Groups are
+// visited in triangular steps, which reaches every group of a power-of-two
+// index; a group with an EMPTY byte ends the search.
+static int64_t dict_find_slot(OrionDict* dict, int64_t key) {
+    uint64_t hash = dict_hash(dict, key);
+    int8_t h2 = hash_h2(hash);
+    uint64_t mask = (uint64_t)dict->capacity - 1;
+    uint64_t pos = (hash >> 7) & mask;
+    uint64_t stride = 0;
+    
+    for (;;) {
+        const int8_t* group = dict->ctrl + pos;
+        uint32_t match = dict_group_match(group, h2);
+        while (match) {
+            int64_t slot = (int64_t)((pos + (uint64_t)__builtin_ctz(match)) & mask);
+            if (dict_key_equal(dict, dict_slot_entry(dict, slot), key, hash)) {
+                return slot;  // Found
+            }
+            match &= match - 1;
         }
-        if (dict->entries[index].is_occupied && dict->entries[index].key == key) {
-            return index;  // Found
+        if (dict_group_match(group, DICT_CTRL_EMPTY)) {
+            return -1;  // Not found
         }
-        index = (index + 1) % dict->capacity;  // Linear probing
-    } while (index != start);
+        stride += DICT_GROUP_WIDTH;
+        pos = (pos + stride) & mask;
+    }
+}
+
+// First EMPTY or DELETED index slot on the key's probe sequence
+static int64_t dict_find_free(OrionDict* dict, uint64_t hash) {
+    uint64_t mask = (uint64_t)dict->capacity - 1;
+    uint64_t pos = (hash >> 7) & mask;
+    uint64_t stride = 0;
     
-    return -1;  // Not found after full table scan
+    for (;;) {
+        uint32_t free_slots = dict_group_match_free(dict->ctrl + pos);
+        if (free_slots) {
+            return (int64_t)((pos + (uint64_t)__builtin_ctz(free_slots)) & mask);
+        }
+        stride += DICT_GROUP_WIDTH;
+        pos = (pos + stride) & mask;
+    }
 }
 
-// Resize dictionary capacity (internal function)
+// Rebuild at new_capacity, compacting the live entries in order and
+// reindexing them from their cached hashes (internal function)
 static void dict_resize(OrionDict* dict, int64_t new_capacity) {
     if (!dict) return;
     
     DictEntry* old_entries = dict->entries;
-    int64_t old_capacity = dict->capacity;
-    
-    dict->entries = (DictEntry*)orion_malloc(sizeof(DictEntry) * new_capacity);
-    if (!dict->entries) {
-        fprintf(stderr, "Error: Failed to resize dictionary\n");
-        exit(1);
-    }
+    int64_t old_used = dict->used;
     
-    dict->capacity = new_capacity;
-    dict->size = 0;
+    dict_alloc_table(dict, new_capacity);
     
-    // Initialize new entries
-    for (int64_t i = 0; i < new_capacity; i++) {
-        dict->entries[i].is_occupied = 0;
-        dict->entries[i].is_deleted = 0;
-    }
-    
-    // Rehash all existing entries
-    for (int64_t i = 0; i < old_capacity; i++) {
-        if (old_entries[i].is_occupied) {
-            // Re-insert this entry
-            int64_t key = old_entries[i].key;
-            int64_t value = old_entries[i].value;
-            
-            int64_t index = hash_key(key, new_capacity);
-            while (dict->entries[index].is_occupied) {
-                index = (index + 1) % new_capacity;
-            }
-            
-            dict->entries[index].key = key;
-            dict->entries[index].value = value;
-            dict->entries[index].is_occupied = 1;
-            dict->entries[index].is_deleted = 0;
-            dict->size++;
+    for (int64_t i = 0; i < old_used; i++) {
+        if (old_entries[i].hash != DICT_HASH_DELETED) {
+            int64_t slot = dict_find_free(dict, old_entries[i].hash);
+            dict_set_ctrl(dict, slot, hash_h2(old_entries[i].hash));
+            dict_index_set(dict, slot, dict->used);
+            dict->entries[dict->used++] = old_entries[i];
         }
     }
+    dict->growth_left -= dict->used;
     
     orion_free(old_entries);
 }
 
-// Set key-value pair in dictionary
+// Remove the entry in an index slot. The slot can go back to EMPTY, and to
+// the growth budget, when no group window covering it was ever full, since
+// then no probe went past it; otherwise it becomes a tombstone. The newest
+// entry is given back to the entries array; older ones stay as holes until
+// the next rebuild.
+static void dict_erase_slot(OrionDict* dict, int64_t slot) {
+    int64_t position = dict_index_get(dict, slot);
+    dict->entries[position].hash = DICT_HASH_DELETED;
+    dict->version++;
+    if (position == dict->used - 1) {
+        dict->used--;
+    }
+    
+    int64_t before = (slot - DICT_GROUP_WIDTH) & (dict->capacity - 1);
+    uint32_t empty_after = dict_group_match(dict->ctrl + slot, DICT_CTRL_EMPTY);
+    uint32_t empty_before = dict_group_match(dict->ctrl + before, DICT_CTRL_EMPTY);
+    if (empty_after && empty_before &&
+        __builtin_ctz(empty_after) + (__builtin_clz(empty_before) - 16) < DICT_GROUP_WIDTH) {
+        dict_set_ctrl(dict, slot, DICT_CTRL_EMPTY);
+        dict->growth_left++;
+    } else {
+        dict_set_ctrl(dict, slot, DICT_CTRL_DELETED);
+    }
+    dict->size--;
+}
+
+// Set key-value pair in dictionary. A new key goes after every existing
+// one; updating a key keeps its place.
 void dict_set(OrionDict* dict, int64_t key, int64_t value) {
     if (!dict) {
         fprintf(stderr, "Error: Cannot set value in null dictionary\n");
         exit(1);
     }
     
-    // Resize if load factor > 0.7
-    if ((double)dict->size / dict->capacity > 0.7) {
-        dict_resize(dict, dict->capacity * 2);
+    // One probe both looks for the key and remembers the first free slot
+    uint64_t hash = dict_hash(dict, key);
+    int8_t h2 = hash_h2(hash);
+    uint64_t mask = (uint64_t)dict->capacity - 1;
+    uint64_t pos = (hash >> 7) & mask;
+    uint64_t stride = 0;
+    int64_t slot = -1;
+    
+    for (;;) {
+        const int8_t* group = dict->ctrl + pos;
+        uint32_t match = dict_group_match(group, h2);
+        while (match) {
+            DictEntry* entry = dict_slot_entry(dict, (int64_t)((pos + (uint64_t)__builtin_ctz(match)) & mask));
+            if (dict_key_equal(dict, entry, key, hash)) {
+                // Update existing key
+                entry->value = value;
+                return;
+            }
+            match &= match - 1;
+        }
+        uint32_t free_slots = dict_group_match_free(group);
+        if (slot == -1 && free_slots) {
+            slot = (int64_t)((pos + (uint64_t)__builtin_ctz(free_slots)) & mask);
+        }
+        if (dict_group_match(group, DICT_CTRL_EMPTY)) {
+            break;
+        }
+        stride += DICT_GROUP_WIDTH;
+        pos = (pos + stride) & mask;
     }
     
-    int64_t index = hash_key(key, dict->capacity);
-    
-    // Linear probing to find empty or matching slot
-    while (dict->entries[index].is_occupied) {
-        if (dict->entries[index].key == key) {
-            // Update existing key
-            dict->entries[index].value = value;
-            return;
+    // Out of entries, or out of EMPTY slots once tombstones are counted; a
+    // DELETED slot can be reused without growing
+    if (dict->used == dict->usable || (dict->growth_left == 0 && dict->ctrl[slot] == DICT_CTRL_EMPTY)) {
+        // Mostly removed entries: compact at the same size, otherwise double
+        if (dict->size <= dict->usable / 2) {
+            dict_resize(dict, dict->capacity);
+        } else {
+            dict_resize(dict, dict->capacity * 2);
         }
-        index = (index + 1) % dict->capacity;
+        slot = dict_find_free(dict, hash);
     }
     
-    // Insert new key-value pair
-    dict->entries[index].key = key;
-    dict->entries[index].value = value;
-    dict->entries[index].is_occupied = 1;
-    dict->entries[index].is_deleted = 0;
+    if (dict->ctrl[slot] == DICT_CTRL_EMPTY) {
+        dict->growth_left--;
+    }
+    dict_set_ctrl(dict, slot, h2);
+    dict_index_set(dict, slot, dict->used);
+    DictEntry* entry = &dict->entries[dict->used++];
+    entry->hash = hash;
+    entry->key = key;
+    entry->value = value;
     dict->size++;
+    dict->version++;
+}
+
+// Switch an empty dict to another key kind, dropping the hashes of its
+// removed entries (internal function)
+static void dict_change_key_kind(OrionDict* dict, int64_t key_kind) {
+    if (dict->key_kind == key_kind) return;
+    dict->key_kind = key_kind;
+    memset(dict->ctrl, (uint8_t)DICT_CTRL_EMPTY, (size_t)dict->capacity + DICT_GROUP_WIDTH);
+    dict->used = 0;
+    dict->growth_left = dict->usable;
+}
+
+// Set with a string key. A dict created empty, before its key type was
+// known, switches to string keys on its first insert.
+void dict_set_str(OrionDict* dict, int64_t key, int64_t value) {
+    if (dict && dict->size == 0) {
+        dict_change_key_kind(dict, DICT_KEYS_STRING);
+    }
+    dict_set(dict, key, value);
 }
 
 // Get value for a key
@@ -937,33 +1959,33 @@ int64_t dict_get(OrionDict* dict, int64_t key) {
         exit(1);
     }
     
-    int64_t index = dict_find_entry(dict, key);
-    if (index == -1) {
+    int64_t slot = dict_find_slot(dict, key);
+    if (slot == -1) {
         fprintf(stderr, "Error: Key not found in dictionary\n");
         exit(1);
     }
     
-    return dict->entries[index].value;
+    return dict_slot_entry(dict, slot)->value;
 }
 
 // Get value with default if key not found
 int64_t dict_get_default(OrionDict* dict, int64_t key, int64_t default_value) {
     if (!dict) return default_value;
     
-    int64_t index = dict_find_entry(dict, key);
-    if (index == -1) {
+    int64_t slot = dict_find_slot(dict, key);
+    if (slot == -1) {
         return default_value;
     }
     
-    return dict->entries[index].value;
+    return dict_slot_entry(dict, slot)->value;
 }
 
 // Check if key exists in dictionary
 int64_t dict_contains(OrionDict* dict, int64_t key) {
     if (!dict) return 0;
     
-    int64_t index = dict_find_entry(dict, key);
-    return (index != -1) ? 1 : 0;
+    int64_t slot = dict_find_slot(dict, key);
+    return (slot != -1) ? 1 : 0;
 }
 
 // Delete a key from dictionary
@@ -973,15 +1995,13 @@ void dict_delete(OrionDict* dict, int64_t key) {
         exit(1);
     }
     
-    int64_t index = dict_find_entry(dict, key);
-    if (index == -1) {
+    int64_t slot = dict_find_slot(dict, key);
+    if (slot == -1) {
         fprintf(stderr, "Error: Cannot delete key that doesn't exist\n");
         exit(1);
     }
     
-    dict->entries[index].is_occupied = 0;
-    dict->entries[index].is_deleted = 1;
-    dict->size--;
+    dict_erase_slot(dict, slot);
 }
 
 // Pop a key from dictionary (returns value)
@@ -991,16 +2011,14 @@ int64_t dict_pop(OrionDict* dict, int64_t key) {
         exit(1);
     }
     
-    int64_t index = dict_find_entry(dict, key);
-    if (index == -1) {
+    int64_t slot = dict_find_slot(dict, key);
+    if (slot == -1) {
         fprintf(stderr, "Error: Cannot pop key that doesn't exist\n");
         exit(1);
     }
     
-    int64_t value = dict->entries[index].value;
-    dict->entries[index].is_occupied = 0;
-    dict->entries[index].is_deleted = 1;
-    dict->size--;
+    int64_t value = dict_slot_entry(dict, slot)->value;
+    dict_erase_slot(dict, slot);
     
     return value;
 }
@@ -1009,20 +2027,18 @@ int64_t dict_pop(OrionDict* dict, int64_t key) {
 int64_t dict_pop_default(OrionDict* dict, int64_t key, int64_t default_value) {
     if (!dict) return default_value;
     
-    int64_t index = dict_find_entry(dict, key);
-    if (index == -1) {
+    int64_t slot = dict_find_slot(dict, key);
+    if (slot == -1) {
         return default_value;
     }
     
-    int64_t value = dict->entries[index].value;
-    dict->entries[index].is_occupied = 0;
-    dict->entries[index].is_deleted = 1;
-    dict->size--;
+    int64_t value = dict_slot_entry(dict, slot)->value;
+    dict_erase_slot(dict, slot);
     
     return value;
 }
 
-// Get all keys as a list
+// Get all keys as a list, in insertion order
 OrionList* dict_keys(OrionDict* dict) {
     if (!dict) {
         fprintf(stderr, "Error: Cannot get keys from null dictionary\n");
@@ -1031,8 +2047,8 @@ OrionList* dict_keys(OrionDict* dict) {
     
     OrionList* keys = list_new(dict->size);
     
-    for (int64_t i = 0; i < dict->capacity; i++) {
-        if (dict->entries[i].is_occupied) {
+    for (int64_t i = 0; i < dict->used; i++) {
+        if (dict->entries[i].hash != DICT_HASH_DELETED) {
             list_append(keys, dict->entries[i].key);
         }
     }
@@ -1040,7 +2056,7 @@ OrionList* dict_keys(OrionDict* dict) {
     return keys;
 }
 
-// Get all values as a list
+// Get all values as a list, in insertion order
 OrionList* dict_values(OrionDict* dict) {
     if (!dict) {
         fprintf(stderr, "Error: Cannot get values from null dictionary\n");
@@ -1049,8 +2065,8 @@ OrionList* dict_values(OrionDict* dict) {
     
     OrionList* values = list_new(dict->size);
     
-    for (int64_t i = 0; i < dict->capacity; i++) {
-        if (dict->entries[i].is_occupied) {
+    for (int64_t i = 0; i < dict->used; i++) {
+        if (dict->entries[i].hash != DICT_HASH_DELETED) {
             list_append(values, dict->entries[i].value);
         }
     }
@@ -1067,8 +2083,8 @@ OrionList* dict_items(OrionDict* dict) {
     
     OrionList* items = list_new(dict->size * 2);
     
-    for (int64_t i = 0; i < dict->capacity; i++) {
-        if (dict->entries[i].is_occupied) {
+    for (int64_t i = 0; i < dict->used; i++) {
+        if (dict->entries[i].hash != DICT_HASH_DELETED) {
             list_append(items, dict->entries[i].key);
             list_append(items, dict->entries[i].value);
         }
@@ -1084,12 +2100,11 @@ void dict_clear(OrionDict* dict) {
         exit(1);
     }
     
-    for (int64_t i = 0; i < dict->capacity; i++) {
-        dict->entries[i].is_occupied = 0;
-        dict->entries[i].is_deleted = 0;
-    }
-    
+    memset(dict->ctrl, (uint8_t)DICT_CTRL_EMPTY, (size_t)dict->capacity + DICT_GROUP_WIDTH);
+    dict->used = 0;
+    dict->growth_left = dict->usable;
     dict->size = 0;
+    dict->version++;
 }
 
 // Update dictionary with key-value pairs from another dictionary
@@ -1099,40 +2114,570 @@ void dict_update(OrionDict* dict, OrionDict* other) {
         exit(1);
     }
     
-    for (int64_t i = 0; i < other->capacity; i++) {
-        if (other->entries[i].is_occupied) {
+    // An empty dict takes on the key kind of the one merged into it
+    if (dict->size == 0) {
+        dict_change_key_kind(dict, other->key_kind);
+    }
+    for (int64_t i = 0; i < other->used; i++) {
+        if (other->entries[i].hash != DICT_HASH_DELETED) {
             dict_set(dict, other->entries[i].key, other->entries[i].value);
         }
     }
 }
-// Smart print function that detects string pointers vs integers
-void print_smart(int64_t value) {
-    // Check if value looks like a valid pointer (any non-zero value above typical small integers)
-    // If it looks like a pointer, try to dereference it as a string
-    if (value > 0x100000) {  // Lowered threshold for detecting pointers
-        // Try to print as string
-        char* str = (char*)value;
-        // Check if it's a valid string by testing if first char is printable or null
-        if (str && *str && strlen(str) < 100000) {
-            printf("%s\n", str);
+
+// ============================================================================
+// Iterators
+// ============================================================================
+
+// What an OrionIter walks
+enum {
+    ORION_ITER_LIST = 0,
+    ORION_ITER_RANGE = 1,
+    ORION_ITER_STRING = 2,        // One-character strings
+    ORION_ITER_DICT_KEYS = 3,
+    ORION_ITER_DICT_VALUES = 4,
+    ORION_ITER_DICT_ITEMS = 5     // Key in value, dict value in second
+};
+
+// Cursor of a for-in loop. It lives in the loop's stack frame and walks the
+// source's own storage, so iterating allocates nothing. The compiler opens
+// range and list loops into index loops when it knows the iterable's type
+// and uses this protocol for the rest.
+typedef struct {
+    int64_t kind;             // ORION_ITER_*
+    void* source;             // List, range, string or dict being walked
+    int64_t position;         // Next element or entry to look at
+    int64_t limit;            // Range length, string length, or dict version at the start
+    int64_t value;            // Current element, filled in by iter_next
+    int64_t second;           // Current dict value for ORION_ITER_DICT_ITEMS
+} OrionIter;
+
+// One-character strings handed out by string iteration; never freed
+static struct {
+    OrionStringHeader header;
+    char chars[8];
+} iter_chars[256];
+
+void iter_init(OrionIter* it, int64_t kind, void* source) {
+    if (!source) {
+        fprintf(stderr, "Error: Cannot iterate over null value\n");
+        exit(1);
+    }
+    it->kind = kind;
+    it->source = source;
+    it->position = 0;
+    switch (kind) {
+        case ORION_ITER_RANGE:
+            it->limit = range_len((OrionRange*)source);
+            break;
+        case ORION_ITER_STRING:
+            it->limit = string_len((const char*)source);
+            break;
+        case ORION_ITER_DICT_KEYS:
+        case ORION_ITER_DICT_VALUES:
+        case ORION_ITER_DICT_ITEMS:
+            it->limit = ((OrionDict*)source)->version;
+            break;
+        default:
+            it->limit = 0;  // Lists are re-checked every step, so appends are seen
+            break;
+    }
+}
+
+// Advance to the next element; returns 0 after the last one. A dict may have
+// values changed during the loop, but adding or removing a key is an error.
+int64_t iter_next(OrionIter* it) {
+    switch (it->kind) {
+        case ORION_ITER_LIST: {
+            OrionList* list = (OrionList*)it->source;
+            if (it->position >= list->size) return 0;
+            it->value = list_load(list, it->position++);
+            return 1;
+        }
+        case ORION_ITER_RANGE:
+            if (it->position >= it->limit) return 0;
+            it->value = range_get((OrionRange*)it->source, it->position++);
+            return 1;
+        case ORION_ITER_STRING: {
+            if (it->position >= it->limit) return 0;
+            unsigned char c = ((const unsigned char*)it->source)[it->position++];
+            if (!iter_chars[c].header.refcount) {
+                iter_chars[c].header.refcount = ORION_FRAME_REFCOUNT;
+                iter_chars[c].header.length = 1;
+                iter_chars[c].header.capacity = 1;
+                iter_chars[c].chars[0] = (char)c;
+            }
+            it->value = (int64_t)iter_chars[c].chars;
+            return 1;
+        }
+        default: {
+            OrionDict* dict = (OrionDict*)it->source;
+            if (dict->version != it->limit) {
+                fprintf(stderr, "Error: Dictionary changed size during iteration\n");
+                exit(1);
+            }
+            while (it->position < dict->used) {
+                const DictEntry* entry = &dict->entries[it->position++];
+                if (entry->hash != DICT_HASH_DELETED) {
+                    it->value = it->kind == ORION_ITER_DICT_VALUES ? entry->value : entry->key;
+                    it->second = entry->value;
+                    return 1;
+                }
+            }
+            return 0;
+        }
+    }
+}
+
+// ============================================================================
+// Function Profiler (orion --profile)
+// ============================================================================
+//
+// Programs compiled with --profile call __orion_prof_start() once from main
+// and __orion_prof_enter()/__orion_prof_exit() around every user function.
+// Timestamps come from the TSC, so each hook costs a few nanoseconds. The
+// report is written at exit: a table on stderr and JSON to orion_profile.json
+// (or the file named by ORION_PROFILE_OUT).
+
+#define ORION_PROF_MAX_DEPTH 8192
+
+typedef struct {
+    uint64_t calls;
+    uint64_t inclusive;       // Cycles with the function on the stack (outermost activation only)
+    uint64_t exclusive;       // Cycles in the function body, callees excluded
+    int64_t active;           // Activations currently on the stack, for recursion
+} ProfCounter;
+
+typedef struct {
+    int64_t id;
+    uint64_t start;
+    uint64_t children;        // Cycles spent in callees of this activation
+} ProfFrame;
+
+static const char** prof_names = NULL;
+static int64_t prof_count = 0;
+static ProfCounter* prof_counters = NULL;
+static ProfFrame prof_stack[ORION_PROF_MAX_DEPTH];
+static int64_t prof_depth = 0;
+static uint64_t prof_start_tsc = 0;
+static struct timespec prof_start_time;
+
+static inline uint64_t prof_now(void) {
+    return __builtin_ia32_rdtsc();
+}
+
+void __orion_prof_enter(int64_t id) {
+    int64_t depth = prof_depth++;
+    if (depth >= ORION_PROF_MAX_DEPTH) return;  // Too deep: keep the stack balanced, skip timing
+    ProfFrame* frame = &prof_stack[depth];
+    frame->id = id;
+    frame->children = 0;
+    prof_counters[id].calls++;
+    prof_counters[id].active++;
+    frame->start = prof_now();
+}
+
+void __orion_prof_exit(int64_t id) {
+    uint64_t now = prof_now();
+    int64_t depth = --prof_depth;
+    if (depth >= ORION_PROF_MAX_DEPTH || depth < 0) return;
+    ProfFrame* frame = &prof_stack[depth];
+    (void)id;
+    uint64_t elapsed = now - frame->start;
+    ProfCounter* counter = &prof_counters[frame->id];
+    counter->exclusive += elapsed - frame->children;
+    // Recursive calls are already covered by the outermost activation
+    if (--counter->active == 0) {
+        counter->inclusive += elapsed;
+    }
+    if (depth > 0) {
+        prof_stack[depth - 1].children += elapsed;
+    }
+}
+
+static int prof_compare(const void* a, const void* b) {
+    const ProfCounter* x = &prof_counters[*(const int64_t*)a];
+    const ProfCounter* y = &prof_counters[*(const int64_t*)b];
+    if (x->exclusive != y->exclusive) return x->exclusive < y->exclusive ? 1 : -1;
+    return 0;
+}
+
+static void prof_write_json_string(FILE* out, const char* text) {
+    fputc('"', out);
+    for (; *text; text++) {
+        if (*text == '"' || *text == '\\') fputc('\\', out);
+        fputc(*text, out);
+    }
+    fputc('"', out);
+}
+
+static void prof_report(void) {
+    // Close activations left open by exit() or the end of main
+    while (prof_depth > 0) {
+        __orion_prof_exit(prof_depth <= ORION_PROF_MAX_DEPTH ? prof_stack[prof_depth - 1].id : 0);
+    }
+
+    uint64_t total_cycles = prof_now() - prof_start_tsc;
+    struct timespec end_time;
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+    double total_ns = (end_time.tv_sec - prof_start_time.tv_sec) * 1e9 +
+                      (end_time.tv_nsec - prof_start_time.tv_nsec);
+    double ns_per_cycle = total_cycles > 0 ? total_ns / (double)total_cycles : 0.0;
+
+    int64_t* order = (int64_t*)malloc(sizeof(int64_t) * prof_count);
+    if (!order) return;
+    for (int64_t i = 0; i < prof_count; i++) order[i] = i;
+    qsort(order, prof_count, sizeof(int64_t), prof_compare);
+
+    fflush(stdout);
+    fprintf(stderr, "\n===------------------------------------------------------------------===\n");
+    fprintf(stderr, "                      Orion function profile\n");
+    fprintf(stderr, "===------------------------------------------------------------------===\n");
+    fprintf(stderr, "  %-20s %12s %14s %14s %7s\n", "Function", "Calls", "Self (ms)", "Total (ms)", "Self %");
+    for (int64_t i = 0; i < prof_count; i++) {
+        ProfCounter* counter = &prof_counters[order[i]];
+        if (counter->calls == 0) continue;
+        fprintf(stderr, "  %-20s %12llu %14.3f %14.3f %6.1f%%\n", prof_names[order[i]],
+                (unsigned long long)counter->calls,
+                counter->exclusive * ns_per_cycle / 1e6,
+                counter->inclusive * ns_per_cycle / 1e6,
+                total_cycles > 0 ? 100.0 * counter->exclusive / total_cycles : 0.0);
+    }
+
+    const char* path = getenv("ORION_PROFILE_OUT");
+    if (!path || !*path) path = "orion_profile.json";
+    FILE* out = fopen(path, "w");
+    if (out) {
+        fprintf(out, "{\n  \"total_cycles\": %llu,\n  \"total_ms\": %.3f,\n  \"ns_per_cycle\": %.6f,\n",
+                (unsigned long long)total_cycles, total_ns / 1e6, ns_per_cycle);
+        fprintf(out, "  \"functions\": [\n");
+        int first = 1;
+        for (int64_t i = 0; i < prof_count; i++) {
+            ProfCounter* counter = &prof_counters[order[i]];
+            if (counter->calls == 0) continue;
+            fprintf(out, "%s    {\"name\": ", first ? "" : ",\n");
+            prof_write_json_string(out, prof_names[order[i]]);
+            fprintf(out, ", \"calls\": %llu, \"self_cycles\": %llu, \"total_cycles\": %llu, "
+                         "\"self_ms\": %.3f, \"total_ms\": %.3f}",
+                    (unsigned long long)counter->calls,
+                    (unsigned long long)counter->exclusive,
+                    (unsigned long long)counter->inclusive,
+                    counter->exclusive * ns_per_cycle / 1e6,
+                    counter->inclusive * ns_per_cycle / 1e6);
+            first = 0;
+        }
+        fprintf(out, "\n  ]\n}\n");
+        fclose(out);
+        fprintf(stderr, "  Profile written to %s\n", path);
+    } else {
+        fprintf(stderr, "  Could not write profile to %s\n", path);
+    }
+    free(order);
+}
+
+// names[0] is the top-level program; it stays on the stack until exit
+void __orion_prof_start(const char** names, int64_t count) {
+    prof_names = names;
+    prof_count = count;
+    prof_counters = (ProfCounter*)calloc(count, sizeof(ProfCounter));
+    if (!prof_counters) {
+        fprintf(stderr, "Error: Failed to allocate profiler counters\n");
+        exit(1);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &prof_start_time);
+    prof_start_tsc = prof_now();
+    atexit(prof_report);
+    __orion_prof_enter(0);
+}
+
+// ============================================================================
+// Sampling Profiler (ORION_SAMPLE=out.folded)
+// ============================================================================
+//
+// When ORION_SAMPLE names an output file, an ITIMER_PROF timer interrupts the
+// program ORION_SAMPLE_HZ times per CPU second (default 997, effectively
+// capped by the kernel tick rate). The handler
+// walks the %rbp chain, which every generated function maintains, and maps
+// each return address to an Orion function through __orion_symbol_table.
+// Identical stacks are merged in a preallocated table, so the handler never
+// allocates. At exit the stacks are written in the folded format
+// ("outer;inner count") read by flamegraph.pl and speedscope.
+
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+    const char* name;
+} OrionSymbol;
+
+// Emitted by the compiler; weak so that runtime.o also links into programs without them
+extern const OrionSymbol __orion_symbol_table[] __attribute__((weak));
+extern const int64_t __orion_symbol_count __attribute__((weak));
+
+#define SAMPLE_MAX_DEPTH 128
+#define SAMPLE_TABLE_SIZE 16384   // Distinct stacks; power of two
+#define SAMPLE_NATIVE (-1)        // Frame outside generated code (runtime or libc)
+#define SAMPLE_TRUNCATED (-2)     // Stack deeper than SAMPLE_MAX_DEPTH
+
+typedef struct {
+    uint64_t count;
+    uint32_t hash;
+    int32_t depth;
+    int32_t frames[SAMPLE_MAX_DEPTH];   // Symbol indices, leaf first
+} SampleStack;
+
+static OrionSymbol* sample_symbols = NULL;
+static int64_t sample_symbol_count = 0;
+static SampleStack* sample_table = NULL;
+static uint64_t sample_dropped = 0;
+static uint64_t sample_total = 0;
+static uintptr_t sample_stack_top = 0;
+static const char* sample_output = NULL;
+
+static int sample_compare_symbols(const void* a, const void* b) {
+    const OrionSymbol* x = (const OrionSymbol*)a;
+    const OrionSymbol* y = (const OrionSymbol*)b;
+    return x->start < y->start ? -1 : (x->start > y->start ? 1 : 0);
+}
+
+static int32_t sample_lookup(uint64_t address) {
+    int64_t low = 0, high = sample_symbol_count - 1;
+    while (low <= high) {
+        int64_t mid = (low + high) / 2;
+        if (address < sample_symbols[mid].start) {
+            high = mid - 1;
+        } else if (address >= sample_symbols[mid].end) {
+            low = mid + 1;
+        } else {
+            return (int32_t)mid;
+        }
+    }
+    return SAMPLE_NATIVE;
+}
+
+static void sample_record(const int32_t* frames, int32_t depth) {
+    uint32_t hash = 2166136261u;
+    for (int32_t i = 0; i < depth; i++) {
+        hash = (hash ^ (uint32_t)frames[i]) * 16777619u;
+    }
+    sample_total++;
+    for (uint32_t probe = 0; probe < SAMPLE_TABLE_SIZE; probe++) {
+        SampleStack* slot = &sample_table[(hash + probe) & (SAMPLE_TABLE_SIZE - 1)];
+        if (slot->count == 0) {
+            slot->hash = hash;
+            slot->depth = depth;
+            memcpy(slot->frames, frames, sizeof(int32_t) * depth);
+            slot->count = 1;
+            return;
+        }
+        if (slot->hash == hash && slot->depth == depth &&
+            memcmp(slot->frames, frames, sizeof(int32_t) * depth) == 0) {
+            slot->count++;
             return;
         }
     }
-    // Default: print as integer
-    printf("%ld\n", value);
+    sample_dropped++;
+}
+
+static void sample_handler(int signo, siginfo_t* info, void* context) {
+    (void)signo;
+    (void)info;
+    ucontext_t* uc = (ucontext_t*)context;
+    uintptr_t pc = (uintptr_t)uc->uc_mcontext.gregs[REG_RIP];
+    uintptr_t sp = (uintptr_t)uc->uc_mcontext.gregs[REG_RSP];
+    uintptr_t fp = (uintptr_t)uc->uc_mcontext.gregs[REG_RBP];
+
+    int32_t frames[SAMPLE_MAX_DEPTH];
+    int32_t depth = 0;
+    int32_t leaf = sample_lookup(pc);
+    frames[depth++] = leaf;
+
+    // In the prologue (before "mov %rsp, %rbp") and at the final "ret" the
+    // frame pointer still belongs to the caller, whose return address is on top
+    if (leaf != SAMPLE_NATIVE) {
+        uintptr_t slot = 0;
+        if (pc == sample_symbols[leaf].start || *(const uint8_t*)pc == 0xc3) {
+            slot = sp;
+        } else if (pc == sample_symbols[leaf].start + 1) {
+            slot = sp + 8;
+        }
+        if (slot) {
+            int32_t caller = sample_lookup(*(uint64_t*)slot);
+            if (caller != SAMPLE_NATIVE) frames[depth++] = caller;
+        }
+    }
+
+    // Optimized runtime/libc code may not keep %rbp as a frame pointer, so
+    // recover the calling Orion function from the first return address into
+    // generated code found on the stack
+    if (leaf == SAMPLE_NATIVE) {
+        uintptr_t limit = sp + 4096 < sample_stack_top ? sp + 4096 : sample_stack_top;
+        for (uintptr_t p = sp; p + 8 <= limit; p += 8) {
+            int32_t caller = sample_lookup(*(uint64_t*)p);
+            if (caller != SAMPLE_NATIVE) {
+                frames[depth++] = caller;
+                break;
+            }
+        }
+    }
+
+    // Walk saved frame pointers while they stay inside the stack and point upwards
+    while (fp >= sp && fp + 16 <= sample_stack_top && (fp & 7) == 0) {
+        uint64_t returnAddress = ((uint64_t*)fp)[1];
+        int32_t caller = sample_lookup(returnAddress);
+        if (caller == SAMPLE_NATIVE) break;  // Returned into libc: main's caller
+        if (depth == SAMPLE_MAX_DEPTH - 1) {
+            // Keep the leaf side of very deep stacks and mark the cut
+            frames[depth++] = SAMPLE_TRUNCATED;
+            break;
+        }
+        frames[depth++] = caller;
+        uintptr_t next = ((uint64_t*)fp)[0];
+        if (next <= fp) break;
+        fp = next;
+    }
+    sample_record(frames, depth);
+}
+
+static void sample_report(void) {
+    struct itimerval off;
+    memset(&off, 0, sizeof(off));
+    setitimer(ITIMER_PROF, &off, NULL);
+
+    FILE* out = fopen(sample_output, "w");
+    if (!out) {
+        fprintf(stderr, "Error: Could not write samples to %s\n", sample_output);
+        return;
+    }
+    for (int64_t i = 0; i < SAMPLE_TABLE_SIZE; i++) {
+        SampleStack* slot = &sample_table[i];
+        if (slot->count == 0) continue;
+        // Folded stacks list the root first
+        for (int32_t f = slot->depth - 1; f >= 0; f--) {
+            int32_t index = slot->frames[f];
+            if (index == SAMPLE_NATIVE) {
+                fputs("[runtime]", out);
+            } else if (index == SAMPLE_TRUNCATED) {
+                fputs("[truncated]", out);
+            } else {
+                fputs(sample_symbols[index].name, out);
+            }
+            if (f > 0) fputc(';', out);
+        }
+        fprintf(out, " %llu\n", (unsigned long long)slot->count);
+    }
+    fclose(out);
+    fprintf(stderr, "orion: %llu samples written to %s", (unsigned long long)sample_total, sample_output);
+    if (sample_dropped > 0) {
+        fprintf(stderr, " (%llu dropped, too many distinct stacks)", (unsigned long long)sample_dropped);
+    }
+    fprintf(stderr, "\n");
+}
+
+// Highest address of the main thread stack, bounding the frame walk
+static uintptr_t sample_find_stack_top(void) {
+    FILE* maps = fopen("/proc/self/maps", "r");
+    if (!maps) return 0;
+    char line[512];
+    uintptr_t top = 0;
+    while (fgets(line, sizeof(line), maps)) {
+        if (strstr(line, "[stack]")) {
+            unsigned long start, end;
+            if (sscanf(line, "%lx-%lx", &start, &end) == 2) top = end;
+            break;
+        }
+    }
+    fclose(maps);
+    return top;
+}
+
+__attribute__((constructor))
+static void sample_init(void) {
+    // The compiler links runtime.o as well; only generated programs carry a symbol table
+    if (&__orion_symbol_count == NULL || &__orion_symbol_table == NULL) return;
+    sample_output = getenv("ORION_SAMPLE");
+    if (!sample_output || !*sample_output) return;
+
+    long hz = 997;
+    const char* hzText = getenv("ORION_SAMPLE_HZ");
+    if (hzText && atol(hzText) > 0) hz = atol(hzText);
+
+    sample_stack_top = sample_find_stack_top();
+    sample_symbol_count = __orion_symbol_count;
+    sample_symbols = (OrionSymbol*)malloc(sizeof(OrionSymbol) * sample_symbol_count);
+    sample_table = (SampleStack*)calloc(SAMPLE_TABLE_SIZE, sizeof(SampleStack));
+    if (!sample_stack_top || !sample_symbols || !sample_table) {
+        fprintf(stderr, "orion: sampling profiler disabled (initialization failed)\n");
+        return;
+    }
+    memcpy(sample_symbols, __orion_symbol_table, sizeof(OrionSymbol) * sample_symbol_count);
+    qsort(sample_symbols, sample_symbol_count, sizeof(OrionSymbol), sample_compare_symbols);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = sample_handler;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, NULL);
+    atexit(sample_report);
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = hz >= 1000000 ? 1 : 1000000 / hz;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, NULL);
 }
 
-// Detect type of a value (string vs integer) and return dtype string pointer
-char* detect_type(int64_t value) {
-    // Check if value looks like a string pointer
-    if (value > 0x100000) {
-        char* str = (char*)value;
-        // Try to validate if it's a string
-        if (str && *str && strlen(str) < 100000) {
-            // Looks like a valid string
-            return "datatype: string\n";
+// ============================================================================
+// Profile-Guided Optimization Counters (orion --profile-generate)
+// ============================================================================
+//
+// Instrumented programs bump one 64-bit counter per branch arm, loop and call
+// site. At exit the counts are added to the profile file, so several
+// representative runs accumulate into one profile for --profile-use.
+
+static uint64_t* pgo_counters = NULL;
+static const char** pgo_names = NULL;
+static int64_t pgo_count = 0;
+static const char* pgo_path = NULL;
+
+static void pgo_write(void) {
+    // Merge with counts from earlier runs; keys no longer in the program are dropped
+    FILE* in = fopen(pgo_path, "r");
+    if (in) {
+        char line[1024];
+        while (fgets(line, sizeof(line), in)) {
+            if (line[0] == '#') continue;
+            char* key = strchr(line, ' ');
+            if (!key) continue;
+            *key++ = '\0';
+            key[strcspn(key, "\n")] = '\0';
+            unsigned long long previous = strtoull(line, NULL, 10);
+            for (int64_t i = 0; i < pgo_count; i++) {
+                if (strcmp(pgo_names[i], key) == 0) {
+                    pgo_counters[i] += previous;
+                    break;
+                }
+            }
         }
+        fclose(in);
+    }
+
+    FILE* out = fopen(pgo_path, "w");
+    if (!out) {
+        fprintf(stderr, "Error: Could not write profile data to %s\n", pgo_path);
+        return;
+    }
+    fprintf(out, "# Orion profile data (orion --profile-generate); counts add up across runs\n");
+    for (int64_t i = 0; i < pgo_count; i++) {
+        fprintf(out, "%llu %s\n", (unsigned long long)pgo_counters[i], pgo_names[i]);
     }
-    // Default to integer
-    return "datatype: int\n";
+    fclose(out);
+}
+
+void __orion_pgo_register(uint64_t* counters, const char** names, int64_t count, const char* path) {
+    pgo_counters = counters;
+    pgo_names = names;
+    pgo_count = count;
+    pgo_path = path;
+    atexit(pgo_write);
 }
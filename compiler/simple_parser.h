@@ -73,6 +73,19 @@ private:
     }
     
     std::unique_ptr<Statement> parseStatement() {
+        // Statements are stamped with the position of their first token;
+        // code generation uses it for .loc line tables
+        int line = peek().line;
+        int column = peek().column;
+        auto stmt = parseStatementNode();
+        if (stmt && stmt->line == 0) {
+            stmt->line = line;
+            stmt->column = column;
+        }
+        return stmt;
+    }
+    
+    std::unique_ptr<Statement> parseStatementNode() {
         // Return statement - check first to ensure it's caught
         if (check(TokenType::RETURN) || (check(TokenType::IDENTIFIER) && peek().value == "return")) {
             advance(); // consume 'return'
@@ -257,7 +270,7 @@ private:
     }
     
     std::unique_ptr<IfStatement> parseIfStatement() {
-        advance(); // consume 'if'
+        Token keyword = advance(); // consume 'if' (or 'elif' for a nested branch)
         
         // Parse condition
         auto condition = parseExpression();
@@ -288,6 +301,8 @@ private:
         advance(); // consume '}'
         
         auto ifStmt = std::make_unique<IfStatement>(std::move(condition), std::move(thenBlock));
+        ifStmt->line = keyword.line;
+        ifStmt->column = keyword.column;
         
         // Handle elif/else
         if (check(TokenType::ELIF)) {
@@ -649,6 +664,8 @@ private:
                 if (auto id = dynamic_cast<Identifier*>(expr.get())) {
                     advance(); // consume '('
                     auto call = std::make_unique<FunctionCall>(id->name);
+                    call->line = id->line;
+                    call->column = id->column;
                     expr.release(); // Release ownership since we're replacing it
                     
                     // Parse arguments
@@ -805,8 +822,8 @@ private:
         }
         
         if (check(TokenType::IDENTIFIER)) {
-            std::string varName = advance().value;
-            return std::make_unique<Identifier>(varName);
+            Token token = advance();
+            return std::make_unique<Identifier>(token.value, token.line, token.column);
         }
         
         // Check if we've encountered a statement starter - if so, stop parsing expression
@@ -929,6 +946,15 @@ private:
         
         std::string variable = advance().value; // consume variable name
         
+        // for key, value in items(d)
+        std::string valueVariable;
+        if (match(TokenType::COMMA)) {
+            if (!check(TokenType::IDENTIFIER)) {
+                throw std::runtime_error("Expected second variable name after ',' in for-in loop");
+            }
+            valueVariable = advance().value;
+        }
+        
         if (!check(TokenType::IN)) {
             throw std::runtime_error("Expected 'in' after variable in for-in loop. C-style for loops are not supported.");
         }
@@ -961,7 +987,7 @@ private:
         }
         advance(); // consume '}'
         
-        return std::make_unique<ForInStatement>(variable, std::move(iterable), std::move(body));
+        return std::make_unique<ForInStatement>(variable, std::move(iterable), std::move(body), valueVariable);
     }
     
     // Helper methods for parameter parsing
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""Regression tests for the Orion compiler and runtime.
+
+Every tests/NAME.or is compiled with `orion --no-run` and run; its stdout must
+match tests/NAME.expected byte for byte. Comment lines at the top of a test
+can adjust how it is built and checked:
+
+    # orion-flags: --arena       extra compiler options
+    # max-rss-kb: 8000           fail if the program's peak RSS exceeds this
+
+Every tests/NAME.c is linked against runtime.o and must exit with status 0;
+these cover runtime behavior that Orion programs cannot reach directly.
+"""
+
+import argparse
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+TESTS_DIR = os.path.dirname(os.path.abspath(__file__))
+COMPILER_DIR = os.path.dirname(TESTS_DIR)
+sys.path.insert(0, os.path.join(COMPILER_DIR, "benchmarks"))
+
+from run_programs import build_launcher  # noqa: E402
+
+TIMEOUT_SECONDS = 60
+
+
+def read_directives(source):
+    directives = {}
+    with open(source) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith("#"):
+                break
+            key, sep, value = line[1:].partition(":")
+            if sep:
+                directives[key.strip()] = value.strip()
+    return directives
+
+
+def run_with_usage(launcher, executable, workdir):
+    """Run a program and return (stdout bytes, exit status, peak RSS KB)."""
+    report = os.path.join(workdir, "usage")
+    result = subprocess.run([launcher, report, executable], cwd=workdir,
+                            stdout=subprocess.PIPE, stderr=subprocess.DEVNULL,
+                            timeout=TIMEOUT_SECONDS)
+    if result.returncode != 0:
+        raise RuntimeError(f"could not run {executable}")
+    with open(report) as f:
+        _, max_rss, status = f.read().split()
+    return result.stdout, int(status), int(max_rss)
+
+
+def run_orion_test(name, compiler, launcher, workdir):
+    source = os.path.join(TESTS_DIR, name + ".or")
+    directives = read_directives(source)
+    flags = directives.get("orion-flags", "").split()
+    build = subprocess.run([compiler] + flags + [source, "--no-run"], cwd=workdir,
+                           stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+    if build.returncode != 0:
+        return f"compile failed:\n{build.stderr}"
+    output, status, max_rss = run_with_usage(launcher, os.path.join(workdir, "orion_exec"), workdir)
+    if status != 0:
+        return f"exited with status {status}"
+    with open(os.path.join(TESTS_DIR, name + ".expected"), "rb") as f:
+        expected = f.read()
+    if output != expected:
+        return ("output differs\n--- expected\n" + expected.decode(errors="replace") +
+                "--- actual\n" + output.decode(errors="replace"))
+    limit = directives.get("max-rss-kb")
+    if limit and max_rss > int(limit):
+        return f"peak RSS {max_rss} KB exceeds {limit} KB"
+    return None
+
+
+def run_c_test(name, cc, runtime, workdir):
+    source = os.path.join(TESTS_DIR, name + ".c")
+    executable = os.path.join(workdir, name + ".c.exe")
+    build = subprocess.run([cc, "-std=c99", "-Wall", "-O2", "-o", executable, source, runtime, "-lm"],
+                           stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+    if build.returncode != 0:
+        return f"compile failed:\n{build.stderr}"
+    result = subprocess.run([executable], cwd=workdir, stdout=subprocess.DEVNULL,
+                            stderr=subprocess.PIPE, text=True, timeout=TIMEOUT_SECONDS)
+    if result.returncode != 0:
+        return f"exited with status {result.returncode}\n{result.stderr}"
+    return None
+
+
+def discover(ext):
+    return sorted(os.path.splitext(entry)[0] for entry in os.listdir(TESTS_DIR) if entry.endswith(ext))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Orion compiler and runtime regression tests")
+    parser.add_argument("--compiler", default=os.path.join(COMPILER_DIR, "orion"),
+                        help="compiler binary (default: %(default)s)")
+    parser.add_argument("--runtime", default=os.path.join(COMPILER_DIR, "runtime.o"),
+                        help="runtime object the compiler links against")
+    parser.add_argument("--cc", default="gcc", help="C compiler for the launcher")
+    parser.add_argument("tests", nargs="*", help="test names to run (default: all)")
+    args = parser.parse_args()
+
+    tests = [(name, "or") for name in discover(".or")] + [(name, "c") for name in discover(".c")]
+    if args.tests:
+        tests = [test for test in tests if test[0] in args.tests]
+    compiler = os.path.abspath(args.compiler)
+    workdir = tempfile.mkdtemp(prefix="orion-tests-")
+    failed = []
+    try:
+        os.symlink(os.path.abspath(args.runtime), os.path.join(workdir, "runtime.o"))
+        launcher = build_launcher(args.cc, workdir)
+        for name, kind in tests:
+            try:
+                if kind == "c":
+                    error = run_c_test(name, args.cc, os.path.abspath(args.runtime), workdir)
+                else:
+                    error = run_orion_test(name, compiler, launcher, workdir)
+            except subprocess.TimeoutExpired:
+                error = f"timed out after {TIMEOUT_SECONDS}s"
+            print(f"{'FAIL' if error else 'ok':<5} {name}")
+            if error:
+                print(error)
+                failed.append(name)
+    finally:
+        shutil.rmtree(workdir, ignore_errors=True)
+
+    print(f"{len(tests) - len(failed)}/{len(tests)} tests passed")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,81 @@
+// Regression tests that call the Orion runtime (runtime.c) directly, for
+// behavior no Orion program can reach. run_tests.py links this file against
+// runtime.o; every failed check is reported and makes the exit status 1.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+// Runtime entry points (runtime.c has no header; the compiler emits calls directly)
+typedef struct OrionDict OrionDict;
+
+OrionDict* dict_new(int64_t initial_capacity);
+void dict_release(OrionDict* dict);
+void dict_set(OrionDict* dict, int64_t key, int64_t value);
+int64_t dict_get(OrionDict* dict, int64_t key);
+int64_t dict_contains(OrionDict* dict, int64_t key);
+void dict_delete(OrionDict* dict, int64_t key);
+int64_t dict_len(OrionDict* dict);
+
+static int failures;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        failures++; \
+    } \
+} while (0)
+
+// Repeatedly inserting and deleting a fresh key next to a fixed set of live
+// keys leaves a tombstone behind each time. The tombstones have to count
+// toward the rebuild threshold, or they fill every EMPTY index slot and the
+// next probe never terminates.
+static void test_dict_insert_delete_churn(void) {
+    OrionDict* dict = dict_new(0);
+    for (int64_t key = 0; key < 3000; key++) {
+        dict_set(dict, key, key * 2);
+    }
+    for (int64_t step = 0; step < 400000; step++) {
+        int64_t key = 1000000 + step;
+        dict_set(dict, key, step);
+        CHECK(dict_get(dict, key) == step);
+        dict_delete(dict, key);
+        if (dict_contains(dict, key)) {
+            CHECK(!"deleted key still present");
+            break;
+        }
+    }
+    CHECK(dict_len(dict) == 3000);
+    for (int64_t key = 0; key < 3000; key++) {
+        CHECK(dict_get(dict, key) == key * 2);
+    }
+    dict_release(dict);
+}
+
+// Deleting older entries, not just the newest, then reinserting them
+static void test_dict_delete_reinsert(void) {
+    OrionDict* dict = dict_new(0);
+    for (int64_t round = 0; round < 200; round++) {
+        for (int64_t key = 0; key < 500; key++) {
+            dict_set(dict, key * 7919, round);
+        }
+        for (int64_t key = 0; key < 500; key += 2) {
+            dict_delete(dict, key * 7919);
+        }
+    }
+    CHECK(dict_len(dict) == 250);
+    for (int64_t key = 1; key < 500; key += 2) {
+        CHECK(dict_get(dict, key * 7919) == 199);
+    }
+    dict_release(dict);
+}
+
+int main(void) {
+    test_dict_insert_delete_churn();
+    test_dict_delete_reinsert();
+    if (failures) {
+        fprintf(stderr, "%d runtime check(s) failed\n", failures);
+        return 1;
+    }
+    return 0;
+}
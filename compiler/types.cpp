@@ -120,35 +120,59 @@ public:
     }
 };
 
+
 // Type variable system for inference
 class TypeVariable {
 public:
     std::string id;
     Type resolvedType;
     bool isResolved;
+    bool isPolymorphic;  // Called with conflicting argument types; the parameter stays UNKNOWN
     std::string functionName;
     std::string parameterName;
     
-    TypeVariable() : resolvedType(TypeKind::UNKNOWN), isResolved(false) {}
+    TypeVariable() : resolvedType(TypeKind::UNKNOWN), isResolved(false), isPolymorphic(false) {}
     
     TypeVariable(const std::string& funcName, const std::string& paramName) 
         : id(funcName + "::" + paramName), resolvedType(TypeKind::UNKNOWN), 
-          isResolved(false), functionName(funcName), parameterName(paramName) {}
+          isResolved(false), isPolymorphic(false), functionName(funcName), parameterName(paramName) {}
 };
 
-// Type constraint for inference
+// Type constraint for inference. Constraints from call sites carry the type of
+// the argument actually passed and outrank the ones gathered from how the
+// parameter is used in the body
 struct TypeConstraint {
     std::string typeVarId;
     Type constraintType;
     std::string reason;
     int line;
+    bool fromCallSite;
     
-    TypeConstraint(const std::string& varId, const Type& type, const std::string& description, int lineNum = 0)
-        : typeVarId(varId), constraintType(type), reason(description), line(lineNum) {}
+    TypeConstraint(const std::string& varId, const Type& type, const std::string& description, int lineNum = 0,
+                   bool callSite = false)
+        : typeVarId(varId), constraintType(type), reason(description), line(lineNum), fromCallSite(callSite) {}
 };
 
+// Resolves the type of every expression and records it in Expression::inferredType
+// for the code generator. Parameters without annotations are inferred from the
+// arguments at their call sites; an argument may itself be an inferred parameter,
+// so the program is walked again until no parameter type changes. Functions called
+// with conflicting argument types are monomorphized: every distinct tuple of
+// argument types gets its own copy with a mangled label such as max$ii. Return
+// types are inferred in the same walks, so call results are typed as well.
 class TypeChecker : public ASTVisitor {
+public:
+    // A copy of a polymorphic function compiled for one tuple of argument types
+    struct Specialization {
+        std::string label;
+        std::vector<Type> parameterTypes;
+    };
+    
 private:
+    // Beyond this many copies of one function, further call sites use the generic body
+    static constexpr size_t MAX_SPECIALIZATIONS = 8;
+    
+
     ScopeManager scopeManager;
     std::unordered_map<std::string, FunctionDeclaration*> functions;
     std::unordered_map<std::string, StructDeclaration*> structs;
@@ -157,44 +181,67 @@ private:
     // Type inference system
     std::unordered_map<std::string, TypeVariable> typeVariables;
     std::vector<TypeConstraint> constraints;
+    std::unordered_set<std::string> calledFunctions;  // Functions with at least one call site
     std::string currentFunctionName;
-    int inferenceMaxIterations = 5;
     
-    Type currentReturnType;
+    // Monomorphization: copies per function, copies whose bodies are not annotated
+    // yet, the parameter types of each generic body and the copy each function
+    // declaration is currently annotated for
+    std::unordered_map<std::string, std::vector<Specialization>> specializations;
+    std::vector<std::pair<std::string, size_t>> pendingSpecializations;
+    std::unordered_map<std::string, std::vector<Type>> genericParameterTypes;
+    std::unordered_map<std::string, std::string> activeSpecializations;
+    
+    // Return types by function label (the name, or the label of a specialization).
+    // A call to a function whose return type is not settled yet is "pending", as
+    // is an inferred parameter during the first walk, before any call site has
+    // resolved it: returns whose type is unknown only because of one are left
+    // out, which lets recursive functions settle on the type of their base case
+    struct ReturnSummary {
+        std::vector<Type> types;
+        bool pending = false;
+    };
+    std::unordered_map<std::string, Type> returnTypes;
+    std::unordered_map<std::string, ReturnSummary> returnSummaries;  // This walk's returns
+    std::string currentReturnKey;
+    bool sawPendingCall = false;
+    bool firstWalk = false;
+    
+    // Iterable of the for-in loop being checked: the only place items() may appear
+    const Expression* forInIterable = nullptr;
+    
     std::vector<std::string> errors;
     std::vector<std::string> sourceLines;
     
 public:
     bool check(Program& program, const std::vector<std::string>& srcLines = {}) {
-        errors.clear();
         sourceLines = srcLines;
+        functions.clear();
+        structs.clear();
+        enums.clear();
         typeVariables.clear();
-        constraints.clear();
+        returnTypes.clear();
         
         // First pass: collect function, struct, and enum declarations
-        for (auto& stmt : program.statements) {
-            if (auto func = dynamic_cast<FunctionDeclaration*>(stmt.get())) {
-                functions[func->name] = func;
-                // Create type variables for implicit parameters
-                createTypeVariablesForFunction(*func);
-            } else if (auto structDecl = dynamic_cast<StructDeclaration*>(stmt.get())) {
-                structs[structDecl->name] = structDecl;
-            } else if (auto enumDecl = dynamic_cast<EnumDeclaration*>(stmt.get())) {
-                enums[enumDecl->name] = enumDecl;
-            }
-        }
+        collectDeclarations(program.statements);
         
-        // Second pass: type check and gather constraints
-        program.accept(*this);
-        
-        // Third pass: perform type inference
-        if (!performTypeInference()) {
-            return false;
-        }
-        
-        // Fourth pass: validate all types are resolved
-        if (!validateResolvedTypes()) {
-            return false;
+        // Annotate and resolve parameter and return types until nothing changes. A
+        // type variable changes at most twice (unresolved -> resolved -> polymorphic)
+        // and so does a return type (pending -> settled -> unknown), which bounds
+        // the number of walks; copies of polymorphic functions add their own returns
+        size_t maxWalks = 2 * typeVariables.size() + 2 * functions.size() * (MAX_SPECIALIZATIONS + 1) + 2;
+        bool changed = true;
+        for (size_t walk = 0; changed && walk < maxWalks; walk++) {
+            firstWalk = walk == 0;
+            annotate(program);
+            bool parametersChanged = resolveTypeVariables();
+            bool returnsChanged = resolveReturnTypes();
+            changed = parametersChanged || returnsChanged;
+        }
+        firstWalk = false;
+        if (changed) {
+            // Keep the annotations consistent with the final parameter and return types
+            annotate(program);
         }
         
         if (!errors.empty()) {
@@ -212,6 +259,40 @@ public:
         return errors;
     }
     
+    // Copies of a polymorphic function, one per distinct tuple of argument types
+    // at its call sites; empty for functions that have a single body
+    // Inferred return types by function label; functions missing here, or mapped
+    // to UNKNOWN, return values of different or unknown types
+    const std::unordered_map<std::string, Type>& getReturnTypes() const {
+        return returnTypes;
+    }
+    
+    const std::vector<Specialization>& specializationsOf(const std::string& functionName) const {
+        static const std::vector<Specialization> none;
+        auto it = specializations.find(functionName);
+        return it != specializations.end() ? it->second : none;
+    }
+    
+    // Retypes the parameters of func for the copy with this label ("" for the
+    // generic body) and re-annotates its body to match. Returns the label that
+    // was active before, so callers can restore it
+    std::string specialize(FunctionDeclaration& func, const std::string& label) {
+        std::string previous = activeSpecializations[func.name];
+        auto generic = genericParameterTypes.find(func.name);
+        if (generic == genericParameterTypes.end()) return previous;
+        
+        const std::vector<Type>* parameterTypes = &generic->second;
+        for (const auto& copy : specializationsOf(func.name)) {
+            if (copy.label == label) parameterTypes = &copy.parameterTypes;
+        }
+        for (size_t i = 0; i < func.parameters.size(); i++) {
+            func.parameters[i].type = (*parameterTypes)[i];
+        }
+        activeSpecializations[func.name] = label;
+        func.accept(*this);
+        return previous;
+    }
+    
 private:
     void addError(const std::string& message, int line = 0) {
         std::string fullMessage = message;
@@ -219,13 +300,30 @@ private:
             fullMessage = "Line " + std::to_string(line) + ": " + message;
             if (line <= (int)sourceLines.size() && line > 0) {
                 fullMessage += "\n    " + sourceLines[line - 1];
-                // Add a caret to point to the error column if needed
-                fullMessage += "\n    ^";
             }
         }
         errors.push_back(fullMessage);
     }
     
+    void collectDeclarations(std::vector<std::unique_ptr<Statement>>& statements) {
+        for (auto& stmt : statements) {
+            if (auto func = dynamic_cast<FunctionDeclaration*>(stmt.get())) {
+                functions[func->name] = func;
+                // Create type variables for implicit parameters
+                createTypeVariablesForFunction(*func);
+                if (!func->isSingleExpression) {
+                    collectDeclarations(func->body);
+                }
+            } else if (auto block = dynamic_cast<BlockStatement*>(stmt.get())) {
+                collectDeclarations(block->statements);
+            } else if (auto structDecl = dynamic_cast<StructDeclaration*>(stmt.get())) {
+                structs[structDecl->name] = structDecl;
+            } else if (auto enumDecl = dynamic_cast<EnumDeclaration*>(stmt.get())) {
+                enums[enumDecl->name] = enumDecl;
+            }
+        }
+    }
+    
     void createTypeVariablesForFunction(FunctionDeclaration& func) {
         for (auto& param : func.parameters) {
             if (!param.isExplicitType || param.type.kind == TypeKind::UNKNOWN) {
@@ -235,89 +333,148 @@ private:
         }
     }
     
-    void addConstraint(const std::string& typeVarId, const Type& constraintType, const std::string& reason, int line = 0) {
-        constraints.emplace_back(typeVarId, constraintType, reason, line);
+    void addConstraint(const std::string& typeVarId, const Type& constraintType, const std::string& reason, int line = 0,
+                       bool fromCallSite = false) {
+        constraints.emplace_back(typeVarId, constraintType, reason, line, fromCallSite);
     }
     
-    bool performTypeInference() {
-        bool changed = true;
-        int iteration = 0;
+    // One walk over the whole program: annotates every expression and gathers constraints
+    void annotate(Program& program) {
+        errors.clear();
+        constraints.clear();
+        calledFunctions.clear();
+        specializations.clear();
+        pendingSpecializations.clear();
+        genericParameterTypes.clear();
+        activeSpecializations.clear();
+        returnSummaries.clear();
+        scopeManager = ScopeManager();
+        currentFunctionName.clear();
+        currentReturnKey.clear();
+        program.accept(*this);
         
-        while (changed && iteration < inferenceMaxIterations) {
-            changed = false;
-            iteration++;
-            
-            // Unify constraints with type variables
-            for (const auto& constraint : constraints) {
-                auto typeVarIt = typeVariables.find(constraint.typeVarId);
-                if (typeVarIt != typeVariables.end()) {
-                    TypeVariable& typeVar = typeVarIt->second;
-                    
-                    if (!typeVar.isResolved) {
-                        if (constraint.constraintType.kind != TypeKind::UNKNOWN) {
-                            typeVar.resolvedType = constraint.constraintType;
-                            typeVar.isResolved = true;
-                            changed = true;
-                            
-                            // Update the actual parameter type in the function
-                            updateParameterType(typeVar.functionName, typeVar.parameterName, constraint.constraintType);
-                        }
-                    } else {
-                        // Check for type conflicts
-                        if (!isCompatible(typeVar.resolvedType, constraint.constraintType)) {
-                            addError("Type conflict for parameter '" + typeVar.parameterName + "' in function '" + 
-                                   typeVar.functionName + "': inferred " + typeVar.resolvedType.toString() + 
-                                   " but also used as " + constraint.constraintType.toString() + " (" + 
-                                   constraint.reason + ")", constraint.line);
-                            return false;
-                        }
-                    }
-                }
-            }
-            
-            // Propagate types between function calls
-            if (propagateTypesAcrossCalls()) {
+        // Specialized bodies can call further polymorphic functions with known
+        // argument types, registering more copies as they are annotated
+        for (size_t next = 0; next < pendingSpecializations.size(); next++) {
+            auto pending = pendingSpecializations[next];
+            std::string label = specializations[pending.first][pending.second].label;
+            specialize(*functions[pending.first], label);
+        }
+        for (const auto& entry : specializations) {
+            specialize(*functions[entry.first], "");
+        }
+    }
+    
+    // Records the type of a returned value for the function being annotated
+    void recordReturn(Expression* value) {
+        if (currentReturnKey.empty()) {
+            if (value) value->accept(*this);
+            return;
+        }
+        ReturnSummary& summary = returnSummaries[currentReturnKey];
+        bool savedPending = sawPendingCall;
+        sawPendingCall = false;
+        Type type = value ? typeOf(*value) : Type(TypeKind::VOID);
+        if (type.kind == TypeKind::UNKNOWN && sawPendingCall) {
+            summary.pending = true;
+        } else {
+            summary.types.push_back(type);
+        }
+        sawPendingCall = savedPending || sawPendingCall;
+    }
+    
+    // Settles every function's return type from this walk's returns; true if any changed.
+    // A function without returns yields VOID; one whose returns all wait on
+    // pending calls stays unsettled
+    bool resolveReturnTypes() {
+        bool changed = false;
+        for (const auto& entry : returnSummaries) {
+            const ReturnSummary& summary = entry.second;
+            if (summary.types.empty() && summary.pending) continue;
+            Type resolved = summary.types.empty() ? Type(TypeKind::VOID) : commonType(summary.types);
+            auto it = returnTypes.find(entry.first);
+            if (it == returnTypes.end()) {
+                returnTypes.emplace(entry.first, resolved);
+                changed = true;
+            } else if (!sameType(it->second, resolved)) {
+                it->second = resolved;
                 changed = true;
             }
         }
-        
-        if (iteration >= inferenceMaxIterations) {
-            addError("Type inference failed to converge within " + std::to_string(inferenceMaxIterations) + " iterations");
-            return false;
+        return changed;
+    }
+    
+    Type typeOf(Expression& expr) {
+        expr.accept(*this);
+        return expr.inferredType;
+    }
+    
+    static bool isNumeric(const Type& type) {
+        return type.kind == TypeKind::INT32 || type.kind == TypeKind::INT64 ||
+               type.kind == TypeKind::FLOAT32 || type.kind == TypeKind::FLOAT64;
+    }
+    
+    static bool isFloat(const Type& type) {
+        return type.kind == TypeKind::FLOAT32 || type.kind == TypeKind::FLOAT64;
+    }
+    
+    static bool sameType(const Type& a, const Type& b) {
+        return a.toString() == b.toString();
+    }
+    
+    // Type shared by all values, or UNKNOWN when any differs or is unknown. Unlike
+    // unifyTypes there is no int -> float promotion: the code generator stores
+    // each value as it was computed, so a list of ints and floats has no element type
+    static Type commonType(const std::vector<Type>& types) {
+        if (types.empty()) return Type(TypeKind::UNKNOWN);
+        for (const auto& type : types) {
+            if (type.kind == TypeKind::UNKNOWN || !sameType(type, types[0])) {
+                return Type(TypeKind::UNKNOWN);
+            }
         }
-        
-        return true;
+        return types[0];
+    }
+    
+    static Type listOf(const Type& elementType) {
+        return Type(TypeKind::LIST, std::make_unique<Type>(elementType));
     }
     
-    bool propagateTypesAcrossCalls() {
+    // Settles every type variable from this walk's constraints; true if any changed
+    bool resolveTypeVariables() {
         bool changed = false;
-        
-        // For each function call, unify argument types with parameter types
-        for (const auto& funcPair : functions) {
-            FunctionDeclaration* func = funcPair.second;
+        for (auto& typeVarPair : typeVariables) {
+            TypeVariable& typeVar = typeVarPair.second;
+            if (typeVar.isPolymorphic) continue;
             
-            // Find calls to this function and unify types
-            // This is a simplified version - in practice would need to traverse call sites
-            for (size_t i = 0; i < func->parameters.size(); i++) {
-                const Parameter& param = func->parameters[i];
-                std::string typeVarId = func->name + "::" + param.name;
-                
-                auto typeVarIt = typeVariables.find(typeVarId);
-                if (typeVarIt != typeVariables.end() && !typeVarIt->second.isResolved) {
-                    // Look for constraints that might resolve this parameter
-                    for (const auto& constraint : constraints) {
-                        if (constraint.typeVarId == typeVarId && constraint.constraintType.kind != TypeKind::UNKNOWN) {
-                            typeVarIt->second.resolvedType = constraint.constraintType;
-                            typeVarIt->second.isResolved = true;
-                            updateParameterType(func->name, param.name, constraint.constraintType);
-                            changed = true;
-                            break;
-                        }
-                    }
+            // Arguments decide; usage in the body only matters for functions never called
+            bool called = calledFunctions.count(typeVar.functionName) > 0;
+            Type inferred(TypeKind::UNKNOWN);
+            bool conflict = false;
+            for (const auto& constraint : constraints) {
+                if (constraint.typeVarId != typeVar.id || constraint.fromCallSite != called) continue;
+                if (inferred.kind == TypeKind::UNKNOWN) {
+                    inferred = constraint.constraintType;
+                } else if (!sameType(inferred, constraint.constraintType)) {
+                    conflict = true;
                 }
             }
+            if (typeVar.isResolved && inferred.kind != TypeKind::UNKNOWN && !sameType(typeVar.resolvedType, inferred)) {
+                conflict = true;
+            }
+            
+            if (conflict) {
+                typeVar.isPolymorphic = true;
+                typeVar.isResolved = false;
+                typeVar.resolvedType = Type(TypeKind::UNKNOWN);
+                updateParameterType(typeVar.functionName, typeVar.parameterName, typeVar.resolvedType);
+                changed = true;
+            } else if (!typeVar.isResolved && inferred.kind != TypeKind::UNKNOWN) {
+                typeVar.resolvedType = inferred;
+                typeVar.isResolved = true;
+                updateParameterType(typeVar.functionName, typeVar.parameterName, inferred);
+                changed = true;
+            }
         }
-        
         return changed;
     }
     
@@ -334,28 +491,72 @@ private:
         }
     }
     
-    bool validateResolvedTypes() {
-        for (const auto& typeVarPair : typeVariables) {
-            const TypeVariable& typeVar = typeVarPair.second;
-            if (!typeVar.isResolved) {
-                addError("Could not infer type for parameter '" + typeVar.parameterName + 
-                        "' in function '" + typeVar.functionName + "'. " +
-                        "Parameter is not used in function body or insufficient context for inference. " +
-                        "Please add an explicit type annotation.");
-                return false;
+    // Short code for a type in mangled labels: i, f, b, s, r, l<element>, d<key><value>
+    static std::string mangle(const Type* type) {
+        if (!type) return "u";
+        switch (type->kind) {
+            case TypeKind::INT32:
+            case TypeKind::INT64: return "i";
+            case TypeKind::FLOAT32:
+            case TypeKind::FLOAT64: return "f";
+            case TypeKind::BOOL: return "b";
+            case TypeKind::STRING: return "s";
+            case TypeKind::RANGE: return "r";
+            case TypeKind::LIST: return "l" + mangle(type->elementType.get());
+            case TypeKind::DICT: return "d" + mangle(type->keyType.get()) + mangle(type->elementType.get());
+            default: return "u";
+        }
+    }
+    
+    // Label of the copy of func compiled for these argument types, registered on
+    // first use. Empty when func is not polymorphic or when an argument in a
+    // polymorphic position has no known type: those calls use the generic body
+    std::string specializationFor(FunctionDeclaration& func, const std::vector<Type>& argTypes) {
+        std::vector<Type> parameterTypes;
+        bool polymorphic = false;
+        for (size_t i = 0; i < func.parameters.size(); i++) {
+            auto typeVar = typeVariables.find(func.name + "::" + func.parameters[i].name);
+            if (typeVar != typeVariables.end() && typeVar->second.isPolymorphic) {
+                if (argTypes[i].kind == TypeKind::UNKNOWN) return "";
+                polymorphic = true;
+                parameterTypes.push_back(argTypes[i]);
+            } else {
+                parameterTypes.push_back(func.parameters[i].type);
             }
         }
-        return true;
+        if (!polymorphic) return "";
+        
+        std::string label = func.name + "$";
+        for (const auto& type : parameterTypes) {
+            label += mangle(&type);
+        }
+        auto& copies = specializations[func.name];
+        for (const auto& copy : copies) {
+            if (copy.label == label) return label;
+        }
+        if (copies.size() >= MAX_SPECIALIZATIONS) return "";
+        
+        if (!genericParameterTypes.count(func.name)) {
+            std::vector<Type> genericTypes;
+            for (const auto& param : func.parameters) {
+                genericTypes.push_back(param.type);
+            }
+            genericParameterTypes.emplace(func.name, genericTypes);
+        }
+        copies.push_back(Specialization{label, parameterTypes});
+        pendingSpecializations.emplace_back(func.name, copies.size() - 1);
+        return label;
     }
     
-    void gatherArithmeticConstraints(Expression& expr, const Type& exprType) {
+    void gatherArithmeticConstraints(Expression& expr, const Type& otherType) {
         if (auto id = dynamic_cast<Identifier*>(&expr)) {
             // Check if this is a parameter that needs type inference
             std::string typeVarId = currentFunctionName + "::" + id->name;
             if (typeVariables.find(typeVarId) != typeVariables.end()) {
-                // This parameter is used in arithmetic, so it should be numeric
-                // We'll prefer int32 as default numeric type
-                addConstraint(typeVarId, Type(TypeKind::INT32), "used in arithmetic operation", expr.line);
+                // This parameter is used in arithmetic, so it should be numeric;
+                // int unless the other operand says otherwise
+                Type numeric = isFloat(otherType) ? Type(TypeKind::FLOAT32) : Type(TypeKind::INT32);
+                addConstraint(typeVarId, numeric, "used in arithmetic operation", expr.line);
             }
         }
     }
@@ -381,79 +582,43 @@ private:
         }
     }
     
-    Type inferType(Expression& expr) {
-        // Simple type inference
-        if (auto intLit = dynamic_cast<IntLiteral*>(&expr)) {
-            return Type(TypeKind::INT32);
-        }
-        if (auto floatLit = dynamic_cast<FloatLiteral*>(&expr)) {
-            return Type(TypeKind::FLOAT32);
-        }
-        if (auto stringLit = dynamic_cast<StringLiteral*>(&expr)) {
-            return Type(TypeKind::STRING);
-        }
-        if (auto boolLit = dynamic_cast<BoolLiteral*>(&expr)) {
-            return Type(TypeKind::BOOL);
-        }
-        if (auto id = dynamic_cast<Identifier*>(&expr)) {
-            Type* varType = scopeManager.findVariable(id->name);
-            if (varType) {
-                return *varType;
-            }
-            addError("Undefined variable: " + id->name);
-            return Type(TypeKind::UNKNOWN);
-        }
-        if (auto binExpr = dynamic_cast<BinaryExpression*>(&expr)) {
-            return inferBinaryType(*binExpr);
-        }
-        if (auto call = dynamic_cast<FunctionCall*>(&expr)) {
-            // Check for built-in type conversion functions
-            if (call->name == "str") {
-                return Type(TypeKind::STRING);
-            }
-            if (call->name == "int") {
-                return Type(TypeKind::INT32);
-            }
-            if (call->name == "flt") {
-                return Type(TypeKind::FLOAT32);
-            }
-            
-            auto it = functions.find(call->name);
-            if (it != functions.end()) {
-                return it->second->returnType;
-            }
-            addError("Undefined function: " + call->name);
-            return Type(TypeKind::UNKNOWN);
-        }
-        if (auto listLit = dynamic_cast<ListLiteral*>(&expr)) {
-            return inferListType(*listLit);
-        }
-        if (auto indexExpr = dynamic_cast<IndexExpression*>(&expr)) {
-            return inferIndexType(*indexExpr);
-        }
-        
-        return Type(TypeKind::UNKNOWN);
-    }
-    
-    Type inferBinaryType(BinaryExpression& expr) {
-        Type leftType = inferType(*expr.left);
-        Type rightType = inferType(*expr.right);
-        
+    Type inferBinaryType(BinaryExpression& expr, const Type& leftType, const Type& rightType) {
         // Arithmetic operations
         if (expr.op == BinaryOp::ADD || expr.op == BinaryOp::SUB ||
-            expr.op == BinaryOp::MUL || expr.op == BinaryOp::DIV || expr.op == BinaryOp::MOD) {
+            expr.op == BinaryOp::MUL || expr.op == BinaryOp::DIV || expr.op == BinaryOp::MOD ||
+            expr.op == BinaryOp::POWER || expr.op == BinaryOp::FLOOR_DIV) {
+            
+            if (leftType.kind == TypeKind::LIST || rightType.kind == TypeKind::LIST) {
+                if (expr.op == BinaryOp::ADD && leftType.kind == TypeKind::LIST && rightType.kind == TypeKind::LIST) {
+                    // Concatenation keeps the element type when both sides agree; ints
+                    // joined with floats are converted by the runtime
+                    Type leftElement = elementTypeOf(leftType);
+                    Type rightElement = elementTypeOf(rightType);
+                    if ((isFloat(leftElement) && isNumeric(rightElement)) ||
+                        (isFloat(rightElement) && isNumeric(leftElement))) {
+                        return listOf(Type(TypeKind::FLOAT32));
+                    }
+                    return listOf(commonType({leftElement, rightElement}));
+                }
+                if (expr.op == BinaryOp::MUL) {
+                    // Repetition: list * int or int * list
+                    return leftType.kind == TypeKind::LIST ? leftType : rightType;
+                }
+                return Type(TypeKind::UNKNOWN);
+            }
             
             if (leftType.kind == TypeKind::STRING || rightType.kind == TypeKind::STRING) {
                 if (expr.op == BinaryOp::ADD) {
                     return Type(TypeKind::STRING); // String concatenation
                 } else {
-                    addError("Invalid operation on string");
+                    addError("Invalid operation on string", expr.line);
                     return Type(TypeKind::UNKNOWN);
                 }
             }
             
-            if (leftType.kind == TypeKind::FLOAT32 || rightType.kind == TypeKind::FLOAT32 ||
-                leftType.kind == TypeKind::FLOAT64 || rightType.kind == TypeKind::FLOAT64) {
+            // Matches the code generator: any float operand makes a float operation,
+            // otherwise it is integer arithmetic
+            if (isFloat(leftType) || isFloat(rightType)) {
                 return Type(TypeKind::FLOAT32);
             }
             
@@ -462,28 +627,24 @@ private:
                 return Type(TypeKind::INT32);
             }
             
-            addError("Invalid types for arithmetic operation");
             return Type(TypeKind::UNKNOWN);
         }
         
-        // Comparison operations
+        // Comparison and logical operations
         if (expr.op == BinaryOp::EQ || expr.op == BinaryOp::NE ||
             expr.op == BinaryOp::LT || expr.op == BinaryOp::LE ||
-            expr.op == BinaryOp::GT || expr.op == BinaryOp::GE) {
-            return Type(TypeKind::BOOL);
-        }
-        
-        // Logical operations
-        if (expr.op == BinaryOp::AND || expr.op == BinaryOp::OR) {
-            if (leftType.kind != TypeKind::BOOL || rightType.kind != TypeKind::BOOL) {
-                addError("Logical operations require boolean operands");
-            }
+            expr.op == BinaryOp::GT || expr.op == BinaryOp::GE ||
+            expr.op == BinaryOp::AND || expr.op == BinaryOp::OR) {
             return Type(TypeKind::BOOL);
         }
         
         return Type(TypeKind::UNKNOWN);
     }
     
+    static Type elementTypeOf(const Type& containerType) {
+        return containerType.elementType ? *containerType.elementType : Type(TypeKind::UNKNOWN);
+    }
+    
     bool isCompatible(const Type& expected, const Type& actual) {
         if (expected.kind == TypeKind::UNKNOWN || actual.kind == TypeKind::UNKNOWN) {
             return true; // Allow unknown types (for error recovery)
@@ -513,127 +674,109 @@ private:
         return false;
     }
     
-    // Type unification for lists - handles order-independent type promotion
-    Type unifyTypes(const Type& type1, const Type& type2) {
-        if (type1.kind == TypeKind::UNKNOWN) {
-            return type2;
+    // Built-in functions handled by the code generator itself. Returns false for
+    // names that are not built-ins
+    bool visitBuiltinCall(FunctionCall& node) {
+        const std::string& name = node.name;
+        if (name != "str" && name != "int" && name != "flt" && name != "len" && name != "input" &&
+            name != "dtype" && name != "out" && name != "append" && name != "pop" && name != "range" &&
+            name != "arena_reset" && name != "keys" && name != "values" && name != "items") {
+            return false;
         }
-        if (type2.kind == TypeKind::UNKNOWN) {
-            return type1;
+        
+        std::vector<Type> argTypes;
+        for (auto& arg : node.arguments) {
+            argTypes.push_back(typeOf(*arg));
         }
         
-        // If types are identical, return either one
-        if (type1.kind == type2.kind) {
-            if (type1.kind == TypeKind::LIST) {
-                // Recursively unify element types
-                if (!type1.elementType || !type2.elementType) {
-                    Type result(TypeKind::LIST);
-                    result.elementType = std::make_unique<Type>(TypeKind::UNKNOWN);
-                    return result;
+        if (name == "str" || name == "int" || name == "flt") {
+            // Built-in conversions expect exactly one scalar argument
+            if (argTypes.size() != 1) {
+                addError("Built-in function " + name + "() expects 1 argument, got " +
+                        std::to_string(argTypes.size()), node.line);
+            } else if (argTypes[0].kind == TypeKind::LIST || argTypes[0].kind == TypeKind::DICT ||
+                       argTypes[0].kind == TypeKind::RANGE) {
+                addError(name + "() cannot convert " + argTypes[0].toString(), node.line);
+            }
+            node.inferredType = name == "str" ? Type(TypeKind::STRING)
+                              : name == "int" ? Type(TypeKind::INT32) : Type(TypeKind::FLOAT32);
+        } else if (name == "len") {
+            node.inferredType = Type(TypeKind::INT32);
+        } else if (name == "keys" || name == "values" || name == "items") {
+            // Dict views: iterated in place by for-in, copied into a list anywhere else
+            if (argTypes.size() != 1 || argTypes[0].kind != TypeKind::DICT) {
+                addError(name + "() expects 1 dict argument", node.line);
+            } else if (name == "items" && &node != forInIterable) {
+                addError("items() can only be iterated by a for-in loop", node.line);
+            }
+            Type dictType = argTypes.size() == 1 ? argTypes[0] : Type(TypeKind::UNKNOWN);
+            node.inferredType = name == "keys" ? listOf(dictType.keyType ? *dictType.keyType : Type(TypeKind::UNKNOWN))
+                              : name == "values" ? listOf(elementTypeOf(dictType)) : Type(TypeKind::UNKNOWN);
+        } else if (name == "input" || name == "dtype") {
+            node.inferredType = Type(TypeKind::STRING);
+        } else if (name == "pop" && argTypes.size() == 1 && argTypes[0].kind == TypeKind::LIST) {
+            node.inferredType = elementTypeOf(argTypes[0]);
+        } else if (name == "append") {
+            // Appends to a list variable settle the element type of an empty list,
+            // or make it unknown once they disagree
+            auto id = argTypes.size() == 2 ? dynamic_cast<Identifier*>(node.arguments[0].get()) : nullptr;
+            Type* listType = id ? scopeManager.findVariable(id->name) : nullptr;
+            if (listType && listType->kind == TypeKind::LIST) {
+                if (!listType->elementType) {
+                    *listType = listOf(argTypes[1]);
+                } else if (!sameType(*listType->elementType, argTypes[1]) &&
+                           !(isFloat(*listType->elementType) && isNumeric(argTypes[1]))) {
+                    *listType = listOf(Type(TypeKind::UNKNOWN));
                 }
-                Type unifiedElement = unifyTypes(*type1.elementType, *type2.elementType);
-                Type result(TypeKind::LIST);
-                result.elementType = std::make_unique<Type>(unifiedElement);
-                return result;
             }
-            return type1;
-        }
-        
-        // Handle numeric type promotion (order-independent)
-        if ((type1.kind == TypeKind::INT32 || type1.kind == TypeKind::INT64) &&
-            (type2.kind == TypeKind::FLOAT32 || type2.kind == TypeKind::FLOAT64)) {
-            return type2; // promote int to float
-        }
-        if ((type2.kind == TypeKind::INT32 || type2.kind == TypeKind::INT64) &&
-            (type1.kind == TypeKind::FLOAT32 || type1.kind == TypeKind::FLOAT64)) {
-            return type1; // promote int to float
-        }
-        
-        if (type1.kind == TypeKind::INT32 && type2.kind == TypeKind::INT64) {
-            return type2; // promote int32 to int64
-        }
-        if (type2.kind == TypeKind::INT32 && type1.kind == TypeKind::INT64) {
-            return type1; // promote int32 to int64
+            node.inferredType = Type(TypeKind::VOID);
+        } else if (name == "out" || name == "arena_reset") {
+            node.inferredType = Type(TypeKind::VOID);
+        } else if (name == "range") {
+            node.inferredType = Type(TypeKind::RANGE);
+        } else {
+            node.inferredType = Type(TypeKind::UNKNOWN);
         }
-        
-        // Types cannot be unified
-        return Type(TypeKind::UNKNOWN);
+        return true;
     }
     
-    Type inferListType(ListLiteral& listLit) {
-        if (listLit.elements.empty()) {
-            // Empty list - return generic list type
-            Type listType(TypeKind::LIST);
-            listType.elementType = std::make_unique<Type>(TypeKind::UNKNOWN);
-            return listType;
-        }
-        
-        // Start with the first element's type
-        Type unifiedType = inferType(*listLit.elements[0]);
-        
-        // Unify types of all elements (order-independent)
-        for (size_t i = 1; i < listLit.elements.size(); i++) {
-            Type elemType = inferType(*listLit.elements[i]);
-            Type newUnified = unifyTypes(unifiedType, elemType);
-            
-            if (newUnified.kind == TypeKind::UNKNOWN) {
-                addError("List elements must have compatible types: cannot unify " + 
-                        unifiedType.toString() + " and " + elemType.toString());
-                return Type(TypeKind::UNKNOWN);
+public:
+    void visit(IntLiteral& node) override {
+        node.inferredType = Type(TypeKind::INT32);
+    }
+    void visit(FloatLiteral& node) override {
+        node.inferredType = Type(TypeKind::FLOAT32);
+    }
+    void visit(StringLiteral& node) override {
+        node.inferredType = Type(TypeKind::STRING);
+    }
+    void visit(InterpolatedString& node) override {
+        for (auto& part : node.parts) {
+            if (part.isExpression && part.expression) {
+                part.expression->accept(*this);
             }
-            
-            unifiedType = newUnified;
         }
-        
-        // Create list type with unified element type
-        Type listType(TypeKind::LIST);
-        listType.elementType = std::make_unique<Type>(unifiedType);
-        return listType;
+        node.inferredType = Type(TypeKind::STRING);
     }
-    
-    Type inferIndexType(IndexExpression& indexExpr) {
-        Type objectType = inferType(*indexExpr.object);
-        Type indexType = inferType(*indexExpr.index);
-        
-        // Check that index is integer
-        if (indexType.kind != TypeKind::INT32 && indexType.kind != TypeKind::INT64) {
-            addError("List index must be an integer, got " + indexType.toString());
-            return Type(TypeKind::UNKNOWN);
-        }
-        
-        // Check that object is a list
-        if (objectType.kind != TypeKind::LIST) {
-            addError("Cannot index non-list type " + objectType.toString());
-            return Type(TypeKind::UNKNOWN);
-        }
-        
-        // Return element type
-        if (objectType.elementType) {
-            return *objectType.elementType;
-        } else {
-            return Type(TypeKind::UNKNOWN);
-        }
+    void visit(BoolLiteral& node) override {
+        node.inferredType = Type(TypeKind::BOOL);
     }
-    
-public:
-    void visit(IntLiteral& node) override {}
-    void visit(FloatLiteral& node) override {}
-    void visit(StringLiteral& node) override {}
-    void visit(BoolLiteral& node) override {}
     void visit(Identifier& node) override {
+        // Undefined names are reported by the code generator, which knows which
+        // slots exist at this point of the program
         Type* varType = scopeManager.findVariable(node.name);
-        if (!varType) {
-            addError("Undefined variable: " + node.name, node.line);
+        node.inferredType = varType ? *varType : Type(TypeKind::UNKNOWN);
+        if (firstWalk && node.inferredType.kind == TypeKind::UNKNOWN) {
+            auto typeVar = typeVariables.find(currentFunctionName + "::" + node.name);
+            if (typeVar != typeVariables.end() && !typeVar->second.isResolved) {
+                sawPendingCall = true;
+            }
         }
     }
     
     void visit(BinaryExpression& node) override {
-        node.left->accept(*this);
-        node.right->accept(*this);
-        
-        // Gather constraints for type inference
-        Type leftType = inferType(*node.left);
-        Type rightType = inferType(*node.right);
+        Type leftType = typeOf(*node.left);
+        Type rightType = typeOf(*node.right);
         
         // For arithmetic operations, both operands should be numeric
         if (node.op == BinaryOp::ADD || node.op == BinaryOp::SUB || 
@@ -641,8 +784,8 @@ public:
             node.op == BinaryOp::MOD || node.op == BinaryOp::POWER || 
             node.op == BinaryOp::FLOOR_DIV) {
             
-            gatherArithmeticConstraints(*node.left, leftType);
-            gatherArithmeticConstraints(*node.right, rightType);
+            gatherArithmeticConstraints(*node.left, rightType);
+            gatherArithmeticConstraints(*node.right, leftType);
         }
         // For comparison operations, types should be compatible
         else if (node.op == BinaryOp::EQ || node.op == BinaryOp::NE ||
@@ -651,108 +794,91 @@ public:
             
             gatherComparisonConstraints(*node.left, leftType, *node.right, rightType);
         }
+        
+        node.inferredType = inferBinaryType(node, leftType, rightType);
     }
     
     void visit(UnaryExpression& node) override {
-        node.operand->accept(*this);
+        Type operandType = typeOf(*node.operand);
+        node.inferredType = node.op == UnaryOp::NOT ? Type(TypeKind::BOOL) : operandType;
     }
     
     void visit(TupleExpression& node) override {
+        // A tuple evaluates to its last element
+        node.inferredType = Type(TypeKind::UNKNOWN);
         for (auto& element : node.elements) {
-            element->accept(*this);
+            node.inferredType = typeOf(*element);
         }
     }
     
     void visit(ListLiteral& node) override {
-        // Visit all elements for type checking
+        std::vector<Type> elementTypes;
         for (auto& element : node.elements) {
-            element->accept(*this);
+            elementTypes.push_back(typeOf(*element));
         }
-        // Note: inferListType is called implicitly in inferType when needed
+        // An empty list has no element type until append() gives it one
+        node.inferredType = node.elements.empty() ? Type(TypeKind::LIST) : listOf(commonType(elementTypes));
     }
     
     void visit(DictLiteral& node) override {
-        // Visit all keys and values for type checking
+        std::vector<Type> keyTypes;
+        std::vector<Type> valueTypes;
         for (auto& key : node.keys) {
-            key->accept(*this);
+            keyTypes.push_back(typeOf(*key));
         }
         for (auto& value : node.values) {
-            value->accept(*this);
+            valueTypes.push_back(typeOf(*value));
         }
-        // Note: inferDictType is called implicitly in inferType when needed
+        node.inferredType = Type(TypeKind::DICT, std::make_unique<Type>(commonType(keyTypes)),
+                                 std::make_unique<Type>(commonType(valueTypes)));
     }
     
     void visit(IndexExpression& node) override {
-        // Check object and index types
-        node.object->accept(*this);
-        node.index->accept(*this);
-        // Note: inferIndexType is called implicitly in inferType when needed
+        Type objectType = typeOf(*node.object);
+        typeOf(*node.index);
+        
+        // Lists yield their element type, dicts their value type
+        if (objectType.kind == TypeKind::LIST || objectType.kind == TypeKind::DICT) {
+            node.inferredType = elementTypeOf(objectType);
+        } else {
+            node.inferredType = Type(TypeKind::UNKNOWN);
+        }
     }
     
     void visit(FunctionCall& node) override {
-        // Check for built-in type conversion functions first
-        if (node.name == "str" || node.name == "int" || node.name == "flt") {
-            // Built-in functions expect exactly one argument
-            if (node.arguments.size() != 1) {
-                addError("Built-in function " + node.name + "() expects 1 argument, got " +
-                        std::to_string(node.arguments.size()));
-                return;
-            }
-            
-            // Visit the argument for type checking
-            node.arguments[0]->accept(*this);
-            Type argType = inferType(*node.arguments[0]);
-            
-            // Validate argument types for each built-in function
-            if (node.name == "str") {
-                // str() accepts int, float, bool, or string
-                if (argType.kind != TypeKind::INT32 && argType.kind != TypeKind::INT64 &&
-                    argType.kind != TypeKind::FLOAT32 && argType.kind != TypeKind::FLOAT64 &&
-                    argType.kind != TypeKind::BOOL && argType.kind != TypeKind::STRING) {
-                    addError("str() cannot convert " + argType.toString() + " to string");
-                }
-            } else if (node.name == "int") {
-                // int() accepts int, float, bool, or string
-                if (argType.kind != TypeKind::INT32 && argType.kind != TypeKind::INT64 &&
-                    argType.kind != TypeKind::FLOAT32 && argType.kind != TypeKind::FLOAT64 &&
-                    argType.kind != TypeKind::BOOL && argType.kind != TypeKind::STRING) {
-                    addError("int() cannot convert " + argType.toString() + " to integer");
-                }
-            } else if (node.name == "flt") {
-                // flt() accepts int, float, bool, or string
-                if (argType.kind != TypeKind::INT32 && argType.kind != TypeKind::INT64 &&
-                    argType.kind != TypeKind::FLOAT32 && argType.kind != TypeKind::FLOAT64 &&
-                    argType.kind != TypeKind::BOOL && argType.kind != TypeKind::STRING) {
-                    addError("flt() cannot convert " + argType.toString() + " to float");
-                }
-            }
+        if (visitBuiltinCall(node)) {
             return;
         }
         
+        // Visit arguments first
+        std::vector<Type> argTypes;
+        for (auto& arg : node.arguments) {
+            argTypes.push_back(typeOf(*arg));
+        }
+        // Return types are not annotated in the source; the inferred one is set below
+        node.inferredType = Type(TypeKind::UNKNOWN);
+        node.specialization.clear();
+        
         auto it = functions.find(node.name);
         if (it == functions.end()) {
-            addError("Undefined function: " + node.name);
+            addError("Undefined function: " + node.name, node.line);
             return;
         }
         
         FunctionDeclaration* func = it->second;
-        
-        // Visit arguments first
-        for (auto& arg : node.arguments) {
-            arg->accept(*this);
-        }
+        calledFunctions.insert(func->name);
         
         // Check argument count
         if (node.arguments.size() != func->parameters.size()) {
             addError("Function " + node.name + " expects " + 
                     std::to_string(func->parameters.size()) + " arguments, got " +
-                    std::to_string(node.arguments.size()));
+                    std::to_string(node.arguments.size()), node.line);
             return;
         }
         
         // Check argument types and gather constraints
         for (size_t i = 0; i < node.arguments.size(); i++) {
-            Type argType = inferType(*node.arguments[i]);
+            const Type& argType = argTypes[i];
             const Parameter& param = func->parameters[i];
             
             // If parameter needs type inference, add constraint from argument
@@ -760,7 +886,7 @@ public:
             if (typeVariables.find(paramTypeVarId) != typeVariables.end()) {
                 if (argType.kind != TypeKind::UNKNOWN) {
                     addConstraint(paramTypeVarId, argType, "argument " + std::to_string(i + 1) + 
-                                 " in call to " + node.name, node.line);
+                                 " in call to " + node.name, node.line, true);
                 }
             }
             
@@ -780,9 +906,18 @@ public:
                 argType.kind != TypeKind::UNKNOWN && !isCompatible(param.type, argType)) {
                 addError("Argument " + std::to_string(i + 1) + " to function " + node.name +
                         " has wrong type: expected " + param.type.toString() + 
-                        ", got " + argType.toString());
+                        ", got " + argType.toString(), node.line);
             }
         }
+        
+        node.specialization = specializationFor(*func, argTypes);
+        
+        auto returnType = returnTypes.find(node.specialization.empty() ? func->name : node.specialization);
+        if (returnType != returnTypes.end()) {
+            node.inferredType = returnType->second;
+        } else {
+            sawPendingCall = true;
+        }
     }
     
     void visit(VariableDeclaration& node) override {
@@ -793,27 +928,16 @@ public:
         }
         
         if (node.initializer) {
-            node.initializer->accept(*this);
-            
-            Type initType = inferType(*node.initializer);
+            Type initType = typeOf(*node.initializer);
             
             if (!node.hasExplicitType) {
-                // Type inference
-                if (initType.kind == TypeKind::UNKNOWN) {
-                    // Default to int32 if we can't infer
-                    node.type = Type(TypeKind::INT32);
-                } else {
-                    node.type = initType;
-                }
-            } else {
-                // Type checking
-                if (!isCompatible(node.type, initType)) {
-                    addError("Cannot assign " + initType.toString() + 
-                            " to variable of type " + node.type.toString());
-                }
+                node.type = initType;
+            } else if (!isCompatible(node.type, initType)) {
+                addError("Cannot assign " + initType.toString() + 
+                        " to variable of type " + node.type.toString(), node.line);
             }
         } else if (!node.hasExplicitType) {
-            addError("Variable " + node.name + " needs either explicit type or initializer");
+            addError("Variable " + node.name + " needs either explicit type or initializer", node.line);
         }
         
         // Mark as const if needed
@@ -826,37 +950,28 @@ public:
     
     void visit(FunctionDeclaration& node) override {
         // Set up function context
-        Type savedReturnType = currentReturnType;
-        currentReturnType = node.returnType;
         std::string savedFunctionName = currentFunctionName;
+        std::string savedReturnKey = currentReturnKey;
         currentFunctionName = node.name;
+        auto active = activeSpecializations.find(node.name);
+        currentReturnKey = active != activeSpecializations.end() && !active->second.empty() ? active->second : node.name;
+        returnSummaries[currentReturnKey];
         
         // Enter function scope
         scopeManager.enterScope(true);
         
         // Add parameters to function scope
         for (const auto& param : node.parameters) {
-            Type paramType = param.type;
-            
             // Explicitly declare parameters as local to ensure they go in function scope
             scopeManager.declareLocal(param.name);
             
-            // For implicit parameters, still use the type (even if UNKNOWN) so they're in scope
-            // The type inference will resolve UNKNOWN types later
-            scopeManager.setVariable(param.name, paramType);
+            // Inferred parameters are UNKNOWN until their call sites resolve them
+            scopeManager.setVariable(param.name, param.type);
         }
         
         if (node.isSingleExpression) {
-            // Single expression function
-            node.expression->accept(*this);
-            Type exprType = inferType(*node.expression);
-            
-            if (!isCompatible(node.returnType, exprType)) {
-                addError("Function " + node.name + " returns " + exprType.toString() +
-                        " but declared return type is " + node.returnType.toString());
-            }
+            recordReturn(node.expression.get());
         } else {
-            // Block function
             for (auto& stmt : node.body) {
                 stmt->accept(*this);
             }
@@ -866,8 +981,8 @@ public:
         scopeManager.exitScope();
         
         // Restore context
-        currentReturnType = savedReturnType;
         currentFunctionName = savedFunctionName;
+        currentReturnKey = savedReturnKey;
     }
     
     void visit(BlockStatement& node) override {
@@ -880,6 +995,34 @@ public:
         node.expression->accept(*this);
     }
     
+    void visit(TupleAssignment& node) override {
+        // Every value is evaluated before any target is assigned
+        std::vector<Type> valueTypes;
+        for (auto& value : node.values) {
+            valueTypes.push_back(typeOf(*value));
+        }
+        for (size_t i = 0; i < node.targets.size(); i++) {
+            Type valueType = i < valueTypes.size() ? valueTypes[i] : Type(TypeKind::UNKNOWN);
+            node.targets[i]->inferredType = valueType;
+            if (auto id = dynamic_cast<Identifier*>(node.targets[i].get())) {
+                scopeManager.setVariable(id->name, valueType);
+            }
+        }
+    }
+    
+    void visit(ChainAssignment& node) override {
+        Type valueType = typeOf(*node.value);
+        for (const std::string& varName : node.variables) {
+            scopeManager.setVariable(varName, valueType);
+        }
+    }
+    
+    void visit(IndexAssignment& node) override {
+        typeOf(*node.object);
+        typeOf(*node.index);
+        typeOf(*node.value);
+    }
+    
     void visit(GlobalStatement& node) override {
         for (const std::string& varName : node.variables) {
             scopeManager.declareGlobal(varName);
@@ -893,27 +1036,12 @@ public:
     }
     
     void visit(ReturnStatement& node) override {
-        if (node.value) {
-            node.value->accept(*this);
-            Type returnType = inferType(*node.value);
-            
-            if (!isCompatible(currentReturnType, returnType)) {
-                addError("Return type mismatch: expected " + currentReturnType.toString() +
-                        ", got " + returnType.toString());
-            }
-        } else if (currentReturnType.kind != TypeKind::VOID) {
-            addError("Non-void function must return a value");
-        }
+        recordReturn(node.value.get());
     }
     
     void visit(IfStatement& node) override {
+        // Conditions use truthiness, so any type is accepted
         node.condition->accept(*this);
-        Type condType = inferType(*node.condition);
-        
-        if (condType.kind != TypeKind::BOOL) {
-            addError("If condition must be boolean, got " + condType.toString());
-        }
-        
         node.thenBranch->accept(*this);
         if (node.elseBranch) {
             node.elseBranch->accept(*this);
@@ -922,23 +1050,52 @@ public:
     
     void visit(WhileStatement& node) override {
         node.condition->accept(*this);
-        Type condType = inferType(*node.condition);
+        node.body->accept(*this);
+    }
+    
+    void visit(ForInStatement& node) override {
+        const Expression* savedIterable = forInIterable;
+        forInIterable = node.iterable.get();
+        node.iterable->accept(*this);
+        forInIterable = savedIterable;
         
-        if (condType.kind != TypeKind::BOOL) {
-            addError("While condition must be boolean, got " + condType.toString());
+        // Dicts and their views bind keys and values, lists their elements,
+        // strings one-character strings and ranges their values
+        auto view = dynamic_cast<FunctionCall*>(node.iterable.get());
+        std::string viewName = view && view->arguments.size() == 1 &&
+                               (view->name == "keys" || view->name == "values" || view->name == "items") ? view->name : "";
+        if (!viewName.empty() || node.iterable->inferredType.kind == TypeKind::DICT) {
+            const Type& dictType = viewName.empty() ? node.iterable->inferredType : view->arguments[0]->inferredType;
+            Type keyType = dictType.keyType ? *dictType.keyType : Type(TypeKind::UNKNOWN);
+            scopeManager.setVariable(node.variable, viewName == "values" ? elementTypeOf(dictType) : keyType);
+            if (viewName == "items" && !node.valueVariable.empty()) {
+                scopeManager.setVariable(node.valueVariable, elementTypeOf(dictType));
+            }
+        } else if (node.iterable->inferredType.kind == TypeKind::LIST) {
+            scopeManager.setVariable(node.variable, elementTypeOf(node.iterable->inferredType));
+        } else if (node.iterable->inferredType.kind == TypeKind::STRING) {
+            scopeManager.setVariable(node.variable, Type(TypeKind::STRING));
+        } else {
+            scopeManager.setVariable(node.variable, Type(TypeKind::INT32));
+        }
+        if (!node.valueVariable.empty() && viewName != "items") {
+            addError("Only items() binds two for-in variables", node.line);
+        } else if (viewName == "items" && node.valueVariable.empty()) {
+            addError("items() binds two for-in variables: for key, value in items(d)", node.line);
         }
-        
         node.body->accept(*this);
     }
     
-    // ForStatement removed - only ForInStatement is supported
+    void visit(BreakStatement&) override {}
+    void visit(ContinueStatement&) override {}
+    void visit(PassStatement&) override {}
     
     void visit(StructDeclaration& node) override {
         // Basic validation - check for duplicate fields
         std::unordered_map<std::string, bool> fieldNames;
         for (const auto& field : node.fields) {
             if (fieldNames[field.name]) {
-                addError("Duplicate field name in struct " + node.name + ": " + field.name);
+                addError("Duplicate field name in struct " + node.name + ": " + field.name, node.line);
             }
             fieldNames[field.name] = true;
         }
@@ -949,7 +1106,7 @@ public:
         std::unordered_map<std::string, bool> valueNames;
         for (const auto& value : node.values) {
             if (valueNames[value.name]) {
-                addError("Duplicate value name in enum " + node.name + ": " + value.name);
+                addError("Duplicate value name in enum " + node.name + ": " + value.name, node.line);
             }
             valueNames[value.name] = true;
         }